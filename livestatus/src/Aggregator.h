@@ -20,6 +20,8 @@ class Aggregation {
 public:
     virtual ~Aggregation() = default;
     virtual void update(double value) = 0;
+    // Adds the values seen by another aggregation created by the same factory.
+    virtual void merge(const Aggregation &other) = 0;
     [[nodiscard]] virtual double value() const = 0;
 };
 
@@ -28,6 +30,8 @@ public:
     virtual ~Aggregator() = default;
     virtual void consume(Row row, const contact *auth_user,
                          std::chrono::seconds timezone_offset) = 0;
+    // Adds the rows consumed by another aggregator for the same stats column.
+    virtual void merge(const Aggregator &other) = 0;
     virtual void output(RowRenderer &r) const = 0;
 };
 
@@ -13,6 +13,7 @@
 #include <vector>
 
 #include "Filter.h"
+#include "FilterProgram.h"
 #include "OringFilter.h"
 #include "Row.h"
 
@@ -61,6 +62,19 @@ std::optional<std::string> AndingFilter::stringValueRestrictionFor(
     return {};
 }
 
+std::optional<std::string> AndingFilter::stringPrefixRestrictionFor(
+    const std::string &column_name) const {
+    std::optional<std::string> result;
+    for (const auto &filter : _subfilters) {
+        if (auto prefix = filter->stringPrefixRestrictionFor(column_name)) {
+            if (!result || prefix->size() > result->size()) {
+                result = prefix;  // The longest prefix is the most selective.
+            }
+        }
+    }
+    return result;
+}
+
 std::optional<int32_t> AndingFilter::greatestLowerBoundFor(
     const std::string &column_name,
     std::chrono::seconds timezone_offset) const {
@@ -100,6 +114,10 @@ std::optional<std::bitset<32>> AndingFilter::valueSetLeastUpperBoundFor(
     return result;
 }
 
+void AndingFilter::compile(FilterProgram &program) const {
+    program.emitAllOf(_subfilters);
+}
+
 std::unique_ptr<Filter> AndingFilter::copy() const {
     return make(kind(), conjuncts());
 }
@@ -15,6 +15,12 @@ Column::Column(std::string name, std::string description, ColumnOffsets offsets)
     , _description(std::move(description))
     , _offsets(std::move(offsets)) {}
 
+bool Column::appendGroupKey(Row /*row*/, std::string & /*key*/,
+                            const contact * /*auth_user*/,
+                            std::chrono::seconds /*timezone_offset*/) const {
+    return false;
+}
+
 const void *Column::shiftPointer(Row row) const {
     return _offsets.shiftPointer(row);
 }
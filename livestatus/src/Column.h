@@ -71,6 +71,14 @@ public:
     [[nodiscard]] virtual std::unique_ptr<Aggregator> createAggregator(
         AggregationFactory factory) const = 0;
 
+    // Appends a binary encoding of the row's value to key, used for grouping
+    // in stats queries. Concatenated encodings of several columns have to be
+    // unambiguous. Returns false if the column has no such encoding, the
+    // caller has to render the value then.
+    virtual bool appendGroupKey(Row row, std::string &key,
+                                const contact *auth_user,
+                                std::chrono::seconds timezone_offset) const;
+
     [[nodiscard]] Logger *logger() const { return _logger; }
 
 private:
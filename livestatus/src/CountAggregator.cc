@@ -16,4 +16,8 @@ void CountAggregator::consume(Row row, const contact* auth_user,
     }
 }
 
+void CountAggregator::merge(const Aggregator& other) {
+    _count += static_cast<const CountAggregator&>(other)._count;
+}
+
 void CountAggregator::output(RowRenderer& r) const { r.output(_count); }
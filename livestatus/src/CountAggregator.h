@@ -23,6 +23,7 @@ public:
         : _filter(filter), _count(0) {}
     void consume(Row row, const contact *auth_user,
                  std::chrono::seconds timezone_offset) override;
+    void merge(const Aggregator &other) override;
     void output(RowRenderer &r) const override;
 
 private:
@@ -27,6 +27,11 @@ public:
         _aggregation->update(_column->getValue(row));
     }
 
+    void merge(const Aggregator &other) override {
+        _aggregation->merge(
+            *static_cast<const DoubleAggregator &>(other)._aggregation);
+    }
+
     void output(RowRenderer &r) const override {
         r.output(_aggregation->value());
     }
@@ -6,6 +6,7 @@
 #include "DowntimesOrComments.h"
 
 #include <iosfwd>
+#include <utility>
 
 #include "DowntimeOrComment.h"
 #include "Logger.h"
@@ -18,10 +19,10 @@ void DowntimesOrComments::registerDowntime(nebstruct_downtime_data *data) {
     switch (data->type) {
         case NEBTYPE_DOWNTIME_ADD:
         case NEBTYPE_DOWNTIME_LOAD:
-            _entries[id] = std::make_unique<Downtime>(_mc, data);
+            add(id, std::make_unique<Downtime>(_mc, data));
             break;
         case NEBTYPE_DOWNTIME_DELETE:
-            if (_entries.erase(id) == 0) {
+            if (!remove(id)) {
                 Informational(_logger)
                     << "Cannot delete non-existing downtime " << id;
             }
@@ -36,10 +37,10 @@ void DowntimesOrComments::registerComment(nebstruct_comment_data *data) {
     switch (data->type) {
         case NEBTYPE_COMMENT_ADD:
         case NEBTYPE_COMMENT_LOAD:
-            _entries[id] = std::make_unique<Comment>(_mc, data);
+            add(id, std::make_unique<Comment>(_mc, data));
             break;
         case NEBTYPE_COMMENT_DELETE:
-            if (_entries.erase(id) == 0) {
+            if (!remove(id)) {
                 Informational(_logger)
                     << "Cannot delete non-existing comment " << id;
             }
@@ -48,3 +49,41 @@ void DowntimesOrComments::registerComment(nebstruct_comment_data *data) {
             break;
     }
 }
+
+std::vector<const DowntimeOrComment *> DowntimesOrComments::entriesFor(
+    const host *hst, const service *svc) const {
+    std::vector<const DowntimeOrComment *> result;
+    auto it = _entries_by_object.find(ObjectKey{hst, svc});
+    if (it != _entries_by_object.end()) {
+        result.reserve(it->second.size());
+        for (const auto &[id, entry] : it->second) {
+            result.push_back(entry);
+        }
+    }
+    return result;
+}
+
+void DowntimesOrComments::add(unsigned long id,
+                              std::unique_ptr<DowntimeOrComment> entry) {
+    remove(id);
+    _entries_by_object[ObjectKey{entry->_host, entry->_service}][id] =
+        entry.get();
+    _entries[id] = std::move(entry);
+}
+
+bool DowntimesOrComments::remove(unsigned long id) {
+    auto it = _entries.find(id);
+    if (it == _entries.end()) {
+        return false;
+    }
+    ObjectKey key{it->second->_host, it->second->_service};
+    auto by_object = _entries_by_object.find(key);
+    if (by_object != _entries_by_object.end()) {
+        by_object->second.erase(id);
+        if (by_object->second.empty()) {
+            _entries_by_object.erase(by_object);
+        }
+    }
+    _entries.erase(it);
+    return true;
+}
@@ -12,6 +12,8 @@
 
 #include <map>
 #include <memory>
+#include <utility>
+#include <vector>
 
 #include "DowntimeOrComment.h"  // IWYU pragma: keep
 #include "nagios.h"
@@ -26,10 +28,22 @@ public:
     [[nodiscard]] auto begin() const { return _entries.cbegin(); }
     [[nodiscard]] auto end() const { return _entries.cend(); }
 
+    /// All entries for the given host/service, ordered by ID.
+    [[nodiscard]] std::vector<const DowntimeOrComment *> entriesFor(
+        const host *hst, const service *svc) const;
+
 private:
+    using ObjectKey = std::pair<const host *, const service *>;
+
     std::map<unsigned long, std::unique_ptr<DowntimeOrComment>> _entries;
+    // Index of _entries by the host/service they belong to.
+    std::map<ObjectKey, std::map<unsigned long, const DowntimeOrComment *>>
+        _entries_by_object;
     MonitoringCore *const _mc;
     Logger *const _logger;
+
+    void add(unsigned long id, std::unique_ptr<DowntimeOrComment> entry);
+    bool remove(unsigned long id);
 };
 
 #endif  // DowntimesOrComments_h
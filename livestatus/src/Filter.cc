@@ -5,6 +5,8 @@
 
 #include "Filter.h"
 
+#include "FilterProgram.h"
+
 Filter::~Filter() = default;
 
 std::optional<std::string> Filter::stringValueRestrictionFor(
@@ -12,6 +14,11 @@ std::optional<std::string> Filter::stringValueRestrictionFor(
     return {};
 }
 
+std::optional<std::string> Filter::stringPrefixRestrictionFor(
+    const std::string& /* column_name */) const {
+    return {};
+}
+
 std::optional<int32_t> Filter::greatestLowerBoundFor(
     const std::string& /* column_name */,
     std::chrono::seconds /* timezone_offset */) const {
@@ -29,3 +36,7 @@ std::optional<std::bitset<32>> Filter::valueSetLeastUpperBoundFor(
     std::chrono::seconds /* timezone_offset */) const {
     return {};
 }
+
+void Filter::compile(FilterProgram& program) const {
+    program.emitGeneric(*this);
+}
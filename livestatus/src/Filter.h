@@ -21,6 +21,7 @@
 #include "contact_fwd.h"
 class Column;
 class Filter;
+class FilterProgram;
 class Row;
 
 using Filters = std::vector<std::unique_ptr<Filter>>;
@@ -46,6 +47,10 @@ public:
     // values.
     [[nodiscard]] virtual std::optional<std::string> stringValueRestrictionFor(
         const std::string &column_name) const;
+    /// A string every row accepted by the filter has to start with for the
+    /// given column, if there is such a (non-empty) string.
+    [[nodiscard]] virtual std::optional<std::string> stringPrefixRestrictionFor(
+        const std::string &column_name) const;
     [[nodiscard]] virtual std::optional<int32_t> greatestLowerBoundFor(
         const std::string &column_name,
         std::chrono::seconds timezone_offset) const;
@@ -56,6 +61,10 @@ public:
     valueSetLeastUpperBoundFor(const std::string &column_name,
                                std::chrono::seconds timezone_offset) const;
 
+    /// Lowers the filter into the given program, the default is to simply call
+    /// accepts().
+    virtual void compile(FilterProgram &program) const;
+
     [[nodiscard]] virtual std::unique_ptr<Filter> copy() const = 0;
     [[nodiscard]] virtual std::unique_ptr<Filter> negate() const = 0;
 
@@ -0,0 +1,194 @@
+// Copyright (C) 2019 tribe29 GmbH - License: GNU General Public License v2
+// This file is part of Checkmk (https://checkmk.com). It is subject to the
+// terms and conditions defined in the file COPYING, which is part of this
+// source code package.
+
+#include "FilterProgram.h"
+
+#include <algorithm>
+#include <iterator>
+#include <string_view>
+#include <utility>
+
+#include "IntColumn.h"
+#include "IntFilter.h"
+#include "RegExp.h"
+#include "Row.h"
+#include "StringColumn.h"
+
+namespace {
+// Rough relative costs of the different kinds of instructions, only used for
+// ordering the operands of a junction.
+constexpr unsigned cost_int_comparison = 1;
+constexpr unsigned cost_string_comparison = 4;
+constexpr unsigned cost_regex = 16;
+constexpr unsigned cost_generic = 8;
+}  // namespace
+
+FilterProgram::FilterProgram(const Filter &filter) { filter.compile(*this); }
+
+bool FilterProgram::accepts(Row row, const contact *auth_user,
+                            std::chrono::seconds timezone_offset) const {
+    return _code.empty() || eval(0, row, auth_user, timezone_offset);
+}
+
+void FilterProgram::emitAllOf(const Filters &subfilters) {
+    emitJunction(OpCode::all_of, subfilters);
+}
+
+void FilterProgram::emitAnyOf(const Filters &subfilters) {
+    emitJunction(OpCode::any_of, subfilters);
+}
+
+void FilterProgram::emitJunction(OpCode op_code, const Filters &subfilters) {
+    std::vector<FilterProgram> operands;
+    operands.reserve(subfilters.size());
+    for (const auto &filter : subfilters) {
+        operands.emplace_back(*filter);
+    }
+    // A stable sort keeps the original order for operands of equal cost.
+    std::stable_sort(operands.begin(), operands.end(),
+                     [](const auto &a, const auto &b) {
+                         return a._cost < b._cost;
+                     });
+    size_t length = 1;
+    unsigned cost = 0;
+    for (const auto &operand : operands) {
+        length += operand._code.size();
+        cost += operand._cost;
+    }
+    emit({op_code, length, RelationalOperator::equal, nullptr, 0, nullptr, {},
+          nullptr, nullptr},
+         cost);
+    for (auto &operand : operands) {
+        std::move(operand._code.begin(), operand._code.end(),
+                  std::back_inserter(_code));
+    }
+}
+
+void FilterProgram::emitIntComparison(const IntColumn &column,
+                                      RelationalOperator relOp,
+                                      int32_t value) {
+    emit({OpCode::int_comparison, 1, relOp, &column, value, nullptr, {},
+          nullptr, nullptr},
+         cost_int_comparison);
+}
+
+void FilterProgram::emitStringComparison(
+    const StringColumn &column, RelationalOperator relOp,
+    const std::string &value, const std::shared_ptr<RegExp> &regExp) {
+    // Exact (in)equality is a plain comparison, no need to run the regex
+    // machinery for it.
+    OpCode op_code = OpCode::generic;
+    unsigned cost = cost_string_comparison;
+    switch (relOp) {
+        case RelationalOperator::equal:
+            op_code = OpCode::string_equal;
+            break;
+        case RelationalOperator::not_equal:
+            op_code = OpCode::string_not_equal;
+            break;
+        case RelationalOperator::less:
+            op_code = OpCode::string_less;
+            break;
+        case RelationalOperator::greater_or_equal:
+            op_code = OpCode::string_greater_or_equal;
+            break;
+        case RelationalOperator::greater:
+            op_code = OpCode::string_greater;
+            break;
+        case RelationalOperator::less_or_equal:
+            op_code = OpCode::string_less_or_equal;
+            break;
+        case RelationalOperator::equal_icase:
+            op_code = OpCode::string_match;
+            cost = cost_regex;
+            break;
+        case RelationalOperator::not_equal_icase:
+            op_code = OpCode::string_no_match;
+            cost = cost_regex;
+            break;
+        case RelationalOperator::matches:
+        case RelationalOperator::matches_icase:
+            op_code = OpCode::string_search;
+            cost = cost_regex;
+            break;
+        case RelationalOperator::doesnt_match:
+        case RelationalOperator::doesnt_match_icase:
+            op_code = OpCode::string_no_search;
+            cost = cost_regex;
+            break;
+    }
+    emit({op_code, 1, relOp, nullptr, 0, &column, value, regExp, nullptr},
+         cost);
+}
+
+void FilterProgram::emitGeneric(const Filter &filter) {
+    emit({OpCode::generic, 1, RelationalOperator::equal, nullptr, 0, nullptr,
+          {}, nullptr, &filter},
+         cost_generic);
+}
+
+void FilterProgram::emit(Instruction instruction, unsigned cost) {
+    _code.push_back(std::move(instruction));
+    _cost += cost;
+}
+
+bool FilterProgram::eval(size_t pc, Row row, const contact *auth_user,
+                         std::chrono::seconds timezone_offset) const {
+    const auto &ins = _code[pc];
+    switch (ins.op_code) {
+        case OpCode::all_of:
+            for (size_t i = pc + 1; i < pc + ins.length;
+                 i += _code[i].length) {
+                if (!eval(i, row, auth_user, timezone_offset)) {
+                    return false;
+                }
+            }
+            return true;
+        case OpCode::any_of:
+            for (size_t i = pc + 1; i < pc + ins.length;
+                 i += _code[i].length) {
+                if (eval(i, row, auth_user, timezone_offset)) {
+                    return true;
+                }
+            }
+            return false;
+        case OpCode::int_comparison:
+            return IntFilter::eval(ins.int_column->getValue(row, auth_user),
+                                   ins.rel_op, ins.int_value);
+        case OpCode::generic:
+            return ins.filter->accepts(row, auth_user, timezone_offset);
+        default:
+            break;
+    }
+
+    std::string buffer;
+    auto value = ins.string_column->getView(row, buffer);
+    switch (ins.op_code) {
+        case OpCode::string_equal:
+            return value == ins.string_value;
+        case OpCode::string_not_equal:
+            return value != ins.string_value;
+            // FIXME: The cases below are nonsense for UTF-8...
+        case OpCode::string_less:
+            return value < ins.string_value;
+        case OpCode::string_greater_or_equal:
+            return value >= ins.string_value;
+        case OpCode::string_greater:
+            return value > ins.string_value;
+        case OpCode::string_less_or_equal:
+            return value <= ins.string_value;
+        case OpCode::string_match:
+            return ins.regExp->match(value);
+        case OpCode::string_no_match:
+            return !ins.regExp->match(value);
+        case OpCode::string_search:
+            return ins.regExp->search(value);
+        case OpCode::string_no_search:
+            return !ins.regExp->search(value);
+        default:
+            break;
+    }
+    return false;  // unreachable
+}
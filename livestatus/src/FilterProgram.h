@@ -0,0 +1,96 @@
+// Copyright (C) 2019 tribe29 GmbH - License: GNU General Public License v2
+// This file is part of Checkmk (https://checkmk.com). It is subject to the
+// terms and conditions defined in the file COPYING, which is part of this
+// source code package.
+
+#ifndef FilterProgram_h
+#define FilterProgram_h
+
+#include "config.h"  // IWYU pragma: keep
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Filter.h"
+#include "contact_fwd.h"
+#include "opids.h"
+class IntColumn;
+class RegExp;
+class Row;
+class StringColumn;
+
+/// A Filter lowered into a flat sequence of typed instructions. Junctions are
+/// stored in prefix order together with the length of their subprogram, so
+/// evaluation is a simple loop over a contiguous vector instead of virtual
+/// calls through a tree. The operands of each junction are ordered by their
+/// estimated cost, so cheap integer comparisons are done before string
+/// comparisons and regex matches, making short-circuiting more effective.
+/// Filter types without a specialized instruction fall back to calling their
+/// accepts() method.
+class FilterProgram {
+public:
+    /// An empty program which accepts everything.
+    FilterProgram() = default;
+
+    /// The filter must outlive the program.
+    explicit FilterProgram(const Filter &filter);
+
+    bool accepts(Row row, const contact *auth_user,
+                 std::chrono::seconds timezone_offset) const;
+
+    // The emitters below are used by the Filter::compile() implementations.
+    void emitAllOf(const Filters &subfilters);
+    void emitAnyOf(const Filters &subfilters);
+    void emitIntComparison(const IntColumn &column, RelationalOperator relOp,
+                           int32_t value);
+    void emitStringComparison(const StringColumn &column,
+                              RelationalOperator relOp,
+                              const std::string &value,
+                              const std::shared_ptr<RegExp> &regExp);
+    void emitGeneric(const Filter &filter);
+
+private:
+    enum class OpCode {
+        all_of,
+        any_of,
+        int_comparison,
+        string_equal,
+        string_not_equal,
+        string_less,
+        string_greater_or_equal,
+        string_greater,
+        string_less_or_equal,
+        string_match,
+        string_no_match,
+        string_search,
+        string_no_search,
+        generic
+    };
+
+    struct Instruction {
+        OpCode op_code;
+        // number of instructions including this one and its operands
+        size_t length;
+        RelationalOperator rel_op;
+        const IntColumn *int_column;
+        int32_t int_value;
+        const StringColumn *string_column;
+        std::string string_value;
+        std::shared_ptr<RegExp> regExp;
+        const Filter *filter;
+    };
+
+    std::vector<Instruction> _code;
+    unsigned _cost{0};
+
+    void emitJunction(OpCode op_code, const Filters &subfilters);
+    void emit(Instruction instruction, unsigned cost);
+    [[nodiscard]] bool eval(size_t pc, Row row, const contact *auth_user,
+                            std::chrono::seconds timezone_offset) const;
+};
+
+#endif  // FilterProgram_h
@@ -33,6 +33,7 @@ HostServiceState::HostServiceState()
     , _may_no_longer_exist(false)
     , _has_vanished(false)
     , _last_known_time(0)
+    , _output_entry(nullptr)
     , _host(nullptr)
     , _service(nullptr) {}
 
@@ -13,6 +13,7 @@
 #include <string>
 #include <vector>
 class HostServiceState;
+class LogEntry;
 
 // for host/service, ugly...
 #ifdef CMC
@@ -71,6 +72,9 @@ public:
     std::string _debug_info;
     std::string _log_output;
     std::string _long_log_output;
+    // The entry the outputs are from, null if there is none. Only valid as
+    // long as the entries of its logfile are loaded.
+    const LogEntry *_output_entry;
 
     // maybe "": -> no period known, we assume "always"
     std::string _notification_period;
@@ -231,6 +231,58 @@ InputBuffer::Result InputBuffer::readData() {
     return Result::should_terminate;
 }
 
+InputBuffer::Result InputBuffer::readAvailableData() {
+    if (_write_index == _readahead_buffer.capacity() && !makeRoomForData()) {
+        Informational(_logger)
+            << "Error: maximum length of request line exceeded";
+        return Result::line_too_long;
+    }
+    ssize_t r = read(_fd, &_readahead_buffer[_write_index],
+                     _readahead_buffer.capacity() - _write_index);
+    if (r < 0) {
+        return errno == EINTR ? Result::data_read : Result::eof;
+    }
+    if (r == 0) {
+        return Result::eof;
+    }
+    _write_index += r;
+    return Result::data_read;
+}
+
+// Same shifting/growing logic as in readRequest(), but without an active scan
+// position to keep track of.
+bool InputBuffer::makeRoomForData() {
+    if (_read_index > 0) {
+        size_t size = _write_index - _read_index;
+        memmove(&_readahead_buffer[0], &_readahead_buffer[_read_index], size);
+        _read_index = 0;
+        _write_index = size;
+        return true;
+    }
+    size_t new_capacity = _readahead_buffer.capacity() * 2;
+    if (new_capacity > maximum_buffer_size) {
+        return false;
+    }
+    _readahead_buffer.resize(new_capacity);
+    return true;
+}
+
+bool InputBuffer::hasCompleteRequest() const {
+    // A request is terminated by an empty line, i.e. a linefeed directly at
+    // the beginning of a line.
+    for (size_t i = _read_index; i < _write_index; i++) {
+        if (_readahead_buffer[i] == '\n' &&
+            (i == _read_index || _readahead_buffer[i - 1] == '\n')) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool InputBuffer::hasBufferedData() const {
+    return _read_index < _write_index;
+}
+
 bool InputBuffer::empty() const { return _request_lines.empty(); }
 
 std::string InputBuffer::nextLine() {
@@ -35,6 +35,16 @@ public:
                 std::chrono::milliseconds query_timeout,
                 std::chrono::milliseconds idle_timeout);
     Result readRequest();
+
+    // Non-blocking counterpart of readData() for callers which already know
+    // that the socket is readable, e.g. an epoll loop watching idle
+    // connections. Reads at most once and never waits.
+    Result readAvailableData();
+
+    // Is there a complete request (terminated by an empty line) waiting in the
+    // buffer, so that readRequest() can return without blocking?
+    [[nodiscard]] bool hasCompleteRequest() const;
+    [[nodiscard]] bool hasBufferedData() const;
     [[nodiscard]] bool empty() const;
     std::string nextLine();
 
@@ -50,6 +60,7 @@ private:
     Logger *const _logger;
 
     Result readData();
+    bool makeRoomForData();
 };
 
 #endif  // InputBuffer_h
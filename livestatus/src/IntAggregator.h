@@ -26,6 +26,11 @@ public:
         _aggregation->update(_column->getValue(row, auth_user));
     }
 
+    void merge(const Aggregator &other) override {
+        _aggregation->merge(
+            *static_cast<const IntAggregator &>(other)._aggregation);
+    }
+
     void output(RowRenderer &r) const override {
         r.output(_aggregation->value());
     }
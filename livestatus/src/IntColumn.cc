@@ -17,6 +17,14 @@ void IntColumn::output(Row row, RowRenderer &r, const contact *auth_user,
     r.output(getValue(row, auth_user));
 }
 
+bool IntColumn::appendGroupKey(Row row, std::string &key,
+                               const contact *auth_user,
+                               std::chrono::seconds /*timezone_offset*/) const {
+    auto value = getValue(row, auth_user);
+    key.append(reinterpret_cast<const char *>(&value), sizeof(value));
+    return true;
+}
+
 std::unique_ptr<Filter> IntColumn::createFilter(
     Filter::Kind kind, RelationalOperator relOp,
     const std::string &value) const {
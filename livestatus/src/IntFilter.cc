@@ -8,6 +8,7 @@
 #include <cstdlib>
 
 #include "Filter.h"
+#include "FilterProgram.h"
 #include "IntColumn.h"
 #include "Row.h"
 
@@ -17,8 +18,8 @@ IntFilter::IntFilter(Kind kind, const IntColumn &column,
     , _column(column)
     , _ref_value(atoi(value.c_str())) {}
 
-namespace {
-bool eval(int32_t x, RelationalOperator op, int32_t y) {
+// static
+bool IntFilter::eval(int32_t x, RelationalOperator op, int32_t y) {
     switch (op) {
         case RelationalOperator::equal:
             return x == y;
@@ -47,7 +48,6 @@ bool eval(int32_t x, RelationalOperator op, int32_t y) {
     }
     return false;
 }
-}  // namespace
 
 bool IntFilter::accepts(Row row, const contact *auth_user,
                         std::chrono::seconds /*timezone_offset*/) const {
@@ -122,6 +122,10 @@ std::optional<std::bitset<32>> IntFilter::valueSetLeastUpperBoundFor(
     return {result};
 }
 
+void IntFilter::compile(FilterProgram &program) const {
+    program.emitIntComparison(_column, oper(), _ref_value);
+}
+
 std::unique_ptr<Filter> IntFilter::copy() const {
     return std::make_unique<IntFilter>(*this);
 }
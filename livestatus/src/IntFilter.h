@@ -19,6 +19,7 @@
 #include "Filter.h"
 #include "contact_fwd.h"
 #include "opids.h"
+class FilterProgram;
 class IntColumn;
 class Row;
 
@@ -42,9 +43,12 @@ public:
         const std::string &column_name,
         std::chrono::seconds timezone_offset) const override;
 
+    void compile(FilterProgram &program) const override;
     [[nodiscard]] std::unique_ptr<Filter> copy() const override;
     [[nodiscard]] std::unique_ptr<Filter> negate() const override;
 
+    static bool eval(int32_t x, RelationalOperator op, int32_t y);
+
 private:
     const IntColumn &_column;
     const int32_t _ref_value;
@@ -5,22 +5,47 @@
 
 #include "LogCache.h"
 
+#include <algorithm>
 #include <filesystem>
 #include <sstream>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "Logfile.h"
+#include "LogfileIndex.h"
 #include "Logger.h"
 #include "MonitoringCore.h"
 
 namespace {
-// Check memory every N'th new message
+// Check memory every N'th new message or after that many new bytes
 constexpr unsigned long check_mem_cycle = 1000;
+constexpr size_t check_mem_bytes = 1024 * 1024;
 }  // namespace
 
 LogCache::LogCache(MonitoringCore *mc)
-    : _mc(mc), _num_cached_log_messages(0), _num_at_last_check(0) {}
+    : _mc(mc)
+    , _num_cached_log_messages(0)
+    , _num_cached_log_bytes(0)
+    , _num_at_last_check(0)
+    , _bytes_at_last_check(0) {}
+
+logfiles_t LogCache::logfiles() {
+    std::lock_guard<std::mutex> lg(_lock);
+    update();
+    return _logfiles;
+}
+
+size_t LogCache::numCachedLogMessages() {
+    std::lock_guard<std::mutex> lg(_lock);
+    update();
+    return _num_cached_log_messages;
+}
+
+bool LogCache::hasRoomForPrefetching() {
+    std::lock_guard<std::mutex> lg(_lock);
+    return !overBudget();
+}
 
 void LogCache::update() {
     if (!_logfiles.empty() &&
@@ -32,6 +57,9 @@ void LogCache::update() {
 
     _logfiles.clear();
     _num_cached_log_messages = 0;
+    _num_cached_log_bytes = 0;
+    _num_at_last_check = 0;
+    _bytes_at_last_check = 0;
 
     _last_index_update = std::chrono::system_clock::now();
     // We need to find all relevant logfiles. This includes directory, the
@@ -42,6 +70,9 @@ void LogCache::update() {
     std::filesystem::path dirpath = _mc->logArchivePath();
     try {
         for (const auto &entry : std::filesystem::directory_iterator(dirpath)) {
+            if (LogfileIndex::isIndexFile(entry.path())) {
+                continue;
+            }
             addToIndex(
                 std::make_unique<Logfile>(logger(), this, entry.path(), false));
         }
@@ -72,84 +103,98 @@ void LogCache::addToIndex(std::unique_ptr<Logfile> logfile) {
 }
 
 // This method is called each time a log message is loaded into memory. If the
-// number of messages loaded in memory is too large, memory will be freed by
-// flushing logfiles and message not needed by the current query.
+// messages loaded in memory use too many bytes or there are simply too many of
+// them, memory will be freed by flushing the least recently used logfiles and
+// messages not needed by the current query.
 //
 // The parameters to this method reflect the current query, not the messages
 // that have just been loaded.
-void LogCache::logLineHasBeenAdded(Logfile *logfile, unsigned logclasses) {
-    if (++_num_cached_log_messages <= _mc->maxCachedMessages()) {
-        return;  // current message count still allowed, everything ok
+void LogCache::logLineHasBeenAdded(Logfile *logfile, size_t bytes,
+                                   unsigned logclasses) {
+    std::lock_guard<std::mutex> lg(_lock);
+    // A query might still be working on a logfile which has been dropped from
+    // our index by a log rotation in the meantime. Such lines don't count.
+    auto current = _logfiles.find(logfile->since());
+    if (current == _logfiles.end() || current->second.get() != logfile) {
+        return;
+    }
+
+    ++_num_cached_log_messages;
+    _num_cached_log_bytes += bytes;
+    if (!overBudget()) {
+        return;  // current memory usage still allowed, everything ok
     }
 
     // Memory checking and freeing consumes CPU resources. We save resources by
     // avoiding the memory check each time a new message is loaded when being in
     // a sitation where no memory can be freed. We do this by suppressing the
-    // check when the number of messages loaded into memory has not grown by at
-    // least check_mem_cycle messages.
-    if (_num_cached_log_messages < _num_at_last_check + check_mem_cycle) {
+    // check when the memory used has not grown by at least check_mem_cycle
+    // messages or check_mem_bytes bytes.
+    if (_num_cached_log_messages < _num_at_last_check + check_mem_cycle &&
+        _num_cached_log_bytes < _bytes_at_last_check + check_mem_bytes) {
         return;  // Do not check this time
     }
 
-    // [1] Delete old logfiles: Begin deleting with the oldest logfile available
-    logfiles_t::iterator it;
-    for (it = _logfiles.begin(); it != _logfiles.end(); ++it) {
-        if (it->second.get() == logfile) {
-            break;  // Do not touch the logfile the Query is currently accessing
-        }
-        if (it->second->size() > 0) {
-            _num_cached_log_messages -= it->second->freeMessages(~0);
-            if (_num_cached_log_messages <= _mc->maxCachedMessages()) {
-                _num_at_last_check = _num_cached_log_messages;
-                return;
-            }
+    // [1] Flush the least recently used logfiles, skipping the ones currently
+    // used by other queries.
+    std::vector<Logfile *> candidates;
+    for (const auto &[since, lf] : _logfiles) {
+        if (lf.get() != logfile) {
+            candidates.push_back(lf.get());
         }
     }
-    // The end of this loop must be reached by 'break'. At least one logfile
-    // must be the current logfile. So now 'it' points to the current logfile.
-    // We save that pointer for later.
-    auto queryit = it;
-
-    // [2] Delete message classes irrelevent to current query: Starting from the
-    // current logfile (we broke out of the previous loop just when 'it' pointed
-    // to that)
-    for (; it != _logfiles.end(); ++it) {
-        if (it->second->size() > 0 &&
-            (it->second->classesRead() & ~logclasses) != 0) {
-            Debug(logger()) << "freeing classes " << ~logclasses << " of file "
-                            << it->second->path();
-            _num_cached_log_messages -= it->second->freeMessages(~logclasses);
-            if (_num_cached_log_messages <= _mc->maxCachedMessages()) {
-                _num_at_last_check = _num_cached_log_messages;
-                return;
-            }
+    std::stable_sort(candidates.begin(), candidates.end(),
+                     [](const Logfile *a, const Logfile *b) {
+                         return a->lastUsed() < b->lastUsed();
+                     });
+    for (auto *lf : candidates) {
+        auto usage = lf->freeMessagesIfUnused(~0U);
+        if (usage.messages != 0) {
+            Debug(logger()) << "flushed " << usage.messages << " messages ("
+                            << usage.bytes << " bytes) of file " << lf->path();
+        }
+        freed(usage);
+        if (!overBudget()) {
+            return;
         }
     }
 
-    // [3] Flush newest logfiles: If there are still too many messages loaded,
-    // continue flushing logfiles from the oldest to the newest starting at the
-    // file just after (i.e. newer than) the current logfile
-    for (it = ++queryit; it != _logfiles.end(); ++it) {
-        if (it->second->size() > 0) {
-            Debug(logger()) << "flush newer log, " << it->second->size()
-                            << " number of entries";
-            _num_cached_log_messages -= it->second->freeMessages(~0);
-            if (_num_cached_log_messages <= _mc->maxCachedMessages()) {
-                _num_at_last_check = _num_cached_log_messages;
-                return;
-            }
-        }
+    // [2] Delete message classes irrelevent to current query from the current
+    // logfile. The caller already has exclusive access to it.
+    auto usage = logfile->freeMessages(~logclasses);
+    if (usage.messages != 0) {
+        Debug(logger()) << "freed " << usage.messages << " messages ("
+                        << usage.bytes << " bytes) of classes " << ~logclasses
+                        << " of file " << logfile->path();
+    }
+    freed(usage);
+    if (!overBudget()) {
+        return;
     }
+
     // If we reach this point, no more logfiles can be unloaded, despite the
     // fact that there are still too many messages loaded.
     _num_at_last_check = _num_cached_log_messages;
+    _bytes_at_last_check = _num_cached_log_bytes;
     Debug(logger()) << "cannot unload more messages, still "
-                    << _num_cached_log_messages << " loaded (max is "
-                    << _mc->maxCachedMessages() << ")";
+                    << _num_cached_log_messages << " loaded using "
+                    << _num_cached_log_bytes << " bytes (max is "
+                    << _mc->maxCachedMessages() << " messages and "
+                    << _mc->maxCachedLogBytes() << " bytes)";
 }
 
-size_t LogCache::numCachedLogMessages() const {
-    return _num_cached_log_messages;
+bool LogCache::overBudget() const {
+    return _num_cached_log_messages > _mc->maxCachedMessages() ||
+           _num_cached_log_bytes > _mc->maxCachedLogBytes();
+}
+
+void LogCache::freed(Logfile::Usage usage) {
+    _num_cached_log_messages -= usage.messages;
+    _num_cached_log_bytes -= usage.bytes;
+    if (!overBudget()) {
+        _num_at_last_check = _num_cached_log_messages;
+        _bytes_at_last_check = _num_cached_log_bytes;
+    }
 }
 
 Logger *LogCache::logger() const { return _mc->loggerLivestatus(); }
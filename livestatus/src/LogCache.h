@@ -13,38 +13,52 @@
 #include <map>
 #include <memory>
 #include <mutex>
-class Logfile;
+
+#include "Logfile.h"
 class Logger;
 class MonitoringCore;
 
-using logfiles_t = std::map<time_t, std::unique_ptr<Logfile>>;
+using logfiles_t = std::map<time_t, std::shared_ptr<Logfile>>;
 
 // TODO(sp) Split this class into 2 parts: One is really only a cache for the
 // logfiles to monitor, the other part is about the lines in them.
 class LogCache {
 public:
-    // TODO(sp) Using this class requires a very tricky and fragile protocol:
-    // You have to get the lock and call update() before you use any of the
-    // other methods. Furthermore, the constructor is not allowed to call any
-    // method of the MonitoringCore it gets, because there is a knot between the
-    // Store and the NagiosCore classes, so the MonitoringCore is not yet fully
+    // NOTE: The constructor is not allowed to call any method of the
+    // MonitoringCore it gets, because there is a knot between the Store and
+    // the NagiosCore classes, so the MonitoringCore is not yet fully
     // constructed. :-P
-    std::mutex _lock;
     explicit LogCache(MonitoringCore *mc);
-    void update();
 
-    [[nodiscard]] size_t numCachedLogMessages() const;
-    void logLineHasBeenAdded(Logfile *logfile, unsigned logclasses);
-    auto begin() { return _logfiles.begin(); }
-    auto end() { return _logfiles.end(); }
+    // All methods can be called concurrently. The lock is only held for a
+    // short time, never while loading a logfile or answering a query: Each
+    // query works on its own snapshot of the logfiles, which stay valid even
+    // when the list of logfiles is rebuilt after a log rotation. Access to
+    // the entries of a single logfile is synchronized by the Logfile itself.
+    [[nodiscard]] logfiles_t logfiles();
+    [[nodiscard]] size_t numCachedLogMessages();
+
+    // Prefetching stops as soon as the cache is full, it should not push the
+    // entries needed by running queries out of it.
+    [[nodiscard]] bool hasRoomForPrefetching();
+
+    // Called by a Logfile while it has exclusive access to its own entries.
+    void logLineHasBeenAdded(Logfile *logfile, size_t bytes,
+                             unsigned logclasses);
 
 private:
     MonitoringCore *const _mc;
+    std::mutex _lock;
     size_t _num_cached_log_messages;
+    size_t _num_cached_log_bytes;
     size_t _num_at_last_check;
+    size_t _bytes_at_last_check;
     logfiles_t _logfiles;
     std::chrono::system_clock::time_point _last_index_update;
 
+    void update();
+    [[nodiscard]] bool overBudget() const;
+    void freed(Logfile::Usage usage);
     void addToIndex(std::unique_ptr<Logfile> logfile);
     [[nodiscard]] Logger *logger() const;
 };
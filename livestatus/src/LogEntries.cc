@@ -0,0 +1,115 @@
+// Copyright (C) 2019 tribe29 GmbH - License: GNU General Public License v2
+// This file is part of Checkmk (https://checkmk.com). It is subject to the
+// terms and conditions defined in the file COPYING, which is part of this
+// source code package.
+
+#include "LogEntries.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace {
+bool keyLess(const LogEntries::Item &item, uint64_t key) {
+    return item.key < key;
+}
+
+bool itemLess(const LogEntries::Item &a, const LogEntries::Item &b) {
+    return a.key < b.key;
+}
+}  // namespace
+
+LogEntries::const_iterator LogEntries::lowerBound(time_t t) const {
+    return std::lower_bound(begin(), end(), makeKey(t, 0), keyLess);
+}
+
+LogEntries::const_iterator LogEntries::upperBound(time_t t) const {
+    return std::lower_bound(begin(), end(), makeKey(t + 1, 0), keyLess);
+}
+
+LogEntries::const_iterator LogEntries::find(uint64_t key) const {
+    auto it = std::lower_bound(begin(), end(), key, keyLess);
+    return it != end() && it->key == key ? it : end();
+}
+
+LogEntry *LogEntries::add(LogEntry::Class log_class, size_t lineno,
+                          std::string line) {
+    if (log_class == LogEntry::Class::invalid) {
+        return nullptr;
+    }
+    // Entries point into themselves, so they have to be constructed in place.
+    // classify() always agrees with the constructor about valid lines.
+    auto &arena = _arenas[static_cast<size_t>(log_class)];
+    auto &entry = arena.emplace_back(lineno, std::move(line));
+    if (entry._class != log_class) {
+        arena.pop_back();
+        return nullptr;
+    }
+    Item item{makeKey(entry._time, entry._lineno), entry._class, &entry};
+    if (_sorted == _items.size() &&
+        (_items.empty() || _items.back().key < item.key)) {
+        _items.push_back(item);
+        _sorted++;
+        return &entry;
+    }
+    // Out of order, e.g. when a class is loaded after other ones. Within a
+    // single load keys are unique, so checking the sorted part is enough.
+    auto sorted_end = begin() + static_cast<std::ptrdiff_t>(_sorted);
+    auto it = std::lower_bound(begin(), sorted_end, item.key, keyLess);
+    if (it != sorted_end && it->key == item.key) {
+        arena.pop_back();
+        return nullptr;
+    }
+    _items.push_back(item);
+    return &entry;
+}
+
+void LogEntries::sort() {
+    if (_sorted == _items.size()) {
+        return;
+    }
+    auto middle = _items.begin() + static_cast<std::ptrdiff_t>(_sorted);
+    std::sort(middle, _items.end(), itemLess);
+    std::inplace_merge(_items.begin(), middle, _items.end(), itemLess);
+    _sorted = _items.size();
+}
+
+LogEntries::Usage LogEntries::erase(unsigned logclasses) {
+    Usage freed{0, 0};
+    unsigned erased_classes = 0;
+    for (size_t c = 0; c < num_classes; ++c) {
+        auto mask = 1U << c;
+        if ((logclasses & mask) == 0 || _arenas[c].empty()) {
+            continue;
+        }
+        for (const auto &entry : _arenas[c]) {
+            freed.bytes += memoryUsage(entry);
+        }
+        freed.messages += _arenas[c].size();
+        std::deque<LogEntry>{}.swap(_arenas[c]);  // really release memory
+        erased_classes |= mask;
+    }
+    if (erased_classes != 0) {
+        sort();
+        _items.erase(std::remove_if(_items.begin(), _items.end(),
+                                    [erased_classes](const Item &item) {
+                                        return ((1U << static_cast<int>(
+                                                     item.log_class)) &
+                                                erased_classes) != 0;
+                                    }),
+                     _items.end());
+        _items.shrink_to_fit();
+        _sorted = _items.size();
+    }
+    return freed;
+}
+
+// static
+uint64_t LogEntries::makeKey(time_t t, size_t lineno) {
+    return (static_cast<uint64_t>(t) << 32) | static_cast<uint64_t>(lineno);
+}
+
+// static
+size_t LogEntries::memoryUsage(const LogEntry &entry) {
+    // A rough estimate of the item, the entry and its message.
+    return sizeof(Item) + sizeof(LogEntry) + entry._message.capacity();
+}
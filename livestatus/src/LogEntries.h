@@ -0,0 +1,71 @@
+// Copyright (C) 2019 tribe29 GmbH - License: GNU General Public License v2
+// This file is part of Checkmk (https://checkmk.com). It is subject to the
+// terms and conditions defined in the file COPYING, which is part of this
+// source code package.
+
+#ifndef LogEntries_h
+#define LogEntries_h
+
+#include "config.h"  // IWYU pragma: keep
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "LogEntry.h"
+
+// The entries of a Logfile, sorted by time and line number. Lines are added in
+// file order, so their keys are nearly always sorted already and adding them
+// is a simple push_back. The entries themselves live in one arena per class,
+// so all entries of a class can be dropped at once.
+class LogEntries {
+public:
+    struct Item {
+        uint64_t key;  // time . lineno
+        LogEntry::Class log_class;
+        LogEntry *entry;
+    };
+    using const_iterator = std::vector<Item>::const_iterator;
+
+    struct Usage {
+        size_t messages;
+        size_t bytes;
+    };
+
+    [[nodiscard]] const_iterator begin() const { return _items.cbegin(); }
+    [[nodiscard]] const_iterator end() const { return _items.cend(); }
+    [[nodiscard]] bool empty() const { return _items.empty(); }
+    [[nodiscard]] size_t size() const { return _items.size(); }
+
+    // The first entry not older than/newer than the given time.
+    [[nodiscard]] const_iterator lowerBound(time_t t) const;
+    [[nodiscard]] const_iterator upperBound(time_t t) const;
+    // The entry with the given key, end() if there is none.
+    [[nodiscard]] const_iterator find(uint64_t key) const;
+
+    // The class has to be determined by LogEntry::classify() beforehand.
+    // Returns nullptr for invalid and duplicate lines, which are not added.
+    // Entries added out of order are only visible after the next sort().
+    LogEntry *add(LogEntry::Class log_class, size_t lineno, std::string line);
+    void sort();
+
+    // Drops all entries of the given classes.
+    Usage erase(unsigned logclasses);
+
+    static uint64_t makeKey(time_t t, size_t lineno);
+    static size_t memoryUsage(const LogEntry &entry);
+
+private:
+    static constexpr size_t num_classes =
+        static_cast<size_t>(LogEntry::Class::alert_handlers) + 1;
+
+    std::vector<Item> _items;
+    size_t _sorted{0};  // _items[0 .. _sorted) are sorted
+    std::array<std::deque<LogEntry>, num_classes> _arenas;
+};
+
+#endif  // LogEntries_h
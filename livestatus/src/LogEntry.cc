@@ -5,11 +5,17 @@
 
 #include "LogEntry.h"
 
-#include <algorithm>  // IWYU pragma: keep
-#include <cstdlib>
+#include <algorithm>
+#include <array>
+#include <charconv>
 #include <cstring>
 #include <functional>  // IWYU pragma: keep
+#include <mutex>
+#include <set>
+#include <shared_mutex>
 #include <stdexcept>
+#include <system_error>
+#include <tuple>
 #include <unordered_map>
 #include <utility>
 
@@ -19,13 +25,49 @@
 // [1234567890] FOO BAR: blah blah
 static constexpr size_t timestamp_prefix_length = 13;
 
+namespace {
+bool hasTimestampPrefix(std::string_view line) {
+    return line.size() >= timestamp_prefix_length && line[0] == '[' &&
+           line[11] == ']' && line[12] == ' ';
+}
+
+bool startsWith(std::string_view text, std::string_view what) {
+    return text.substr(0, what.size()) == what;
+}
+
+bool contains(std::string_view text, std::string_view what) {
+    return text.find(what) != std::string_view::npos;
+}
+
+// Like atoi(), but without the need for a NUL-terminated copy of the field.
+int toInt(std::string_view str) {
+    auto pos = str.find_first_not_of(" \t");
+    str.remove_prefix(pos == std::string_view::npos ? str.size() : pos);
+    if (!str.empty() && str[0] == '+') {
+        str.remove_prefix(1);
+    }
+    int value = 0;
+    auto [ptr, ec] =
+        std::from_chars(str.data(), str.data() + str.size(), value);
+    return ec == std::errc{} ? value : 0;
+}
+}  // namespace
+
 // TODO(sp) Fix classifyLogMessage() below to always set all fields and remove
 // this set-me-to-zero-to-be-sure-block.
 LogEntry::LogEntry(size_t lineno, std::string line)
     : _lineno(static_cast<int32_t>(lineno))
     , _message(std::move(line))
     , _state(0)
-    , _attempt(0) {
+    , _attempt(0)
+    , _host_name(intern({}))
+    , _service_description(intern({}))
+    , _command_name(intern({}))
+    , _contact_name(intern({}))
+    , _state_type(intern({}))
+    , _comment{0, 0}
+    , _plugin_output{0, 0}
+    , _long_plugin_output{0, 0} {
     // pointer to options (everything after ':')
     size_t pos = _message.find(':');
     if (pos != std::string::npos) {
@@ -37,11 +79,15 @@ LogEntry::LogEntry(size_t lineno, std::string line)
     _options = &_message[pos];
 
     try {
-        if (_message.size() < timestamp_prefix_length || _message[0] != '[' ||
-            _message[11] != ']' || _message[12] != ' ') {
+        if (!hasTimestampPrefix(_message)) {
             throw std::invalid_argument("timestamp delimiter");
         }
-        _time = std::stoi(_message.substr(1, 10));
+        auto digits = std::string_view{_message}.substr(1, 10);
+        auto [ptr, ec] = std::from_chars(
+            digits.data(), digits.data() + digits.size(), _time);
+        if (ec != std::errc{}) {
+            throw std::invalid_argument("timestamp");
+        }
     } catch (const std::logic_error &e) {
         _class = Class::invalid;
         _kind = LogEntryKind::none;
@@ -53,19 +99,49 @@ LogEntry::LogEntry(size_t lineno, std::string line)
     classifyLogMessage();
 }
 
-void LogEntry::assign(Param par, const std::string &field) {
+namespace {
+// The names are spread over several sets with a lock of their own, so threads
+// parsing logfiles in parallel rarely wait for each other. Looking up a known
+// name, by far the most common case, only needs a shared lock.
+struct InternedNames {
+    std::shared_mutex mutex;
+    std::set<std::string, std::less<>> names;
+};
+}  // namespace
+
+// static
+const std::string *LogEntry::intern(std::string_view str) {
+    static const std::string empty;
+    static std::array<InternedNames, 16> shards;
+    if (str.empty()) {
+        return &empty;
+    }
+    auto &shard = shards[std::hash<std::string_view>{}(str) % shards.size()];
+    {
+        std::shared_lock<std::shared_mutex> sl(shard.mutex);
+        auto it = shard.names.find(str);
+        if (it != shard.names.end()) {
+            return &*it;
+        }
+    }
+    std::unique_lock<std::shared_mutex> ul(shard.mutex);
+    return &*shard.names.emplace(str).first;
+}
+
+void LogEntry::assign(Param par, Span field) {
+    auto str = view(field);
     switch (par) {
         case Param::HostName:
-            _host_name = field;
+            _host_name = intern(str);
             return;
         case Param::ServiceDescription:
-            _service_description = field;
+            _service_description = intern(str);
             return;
         case Param::CommandName:
-            _command_name = field;
+            _command_name = intern(str);
             return;
         case Param::CommandNameWithWorkaround:
-            _command_name = field;
+            _command_name = intern(str);
             // The NotifyHelper class has a long, tragic history: Through a long
             // series of commits, it suffered from spelling mistakes like
             // "HOST_NOTIFICATION" or "HOST NOTIFICATION" (without a colon),
@@ -74,38 +150,38 @@ void LogEntry::assign(Param par, const std::string &field) {
             // of this tragedy is that due to legacy reasons, we have to support
             // parsing an incorrect ordering of "state type" and "command name"
             // fields. :-P
-            if (_state_type.empty()) {
+            if (_state_type->empty()) {
                 return;  // extremely broken line
             }
-            if (_state_type == "check-mk-notify") {
+            if (*_state_type == "check-mk-notify") {
                 // Ooops, we encounter one of our own buggy lines...
                 std::swap(_state_type, _command_name);
-                if (_state_type.empty()) {
+                if (_state_type->empty()) {
                     return;  // extremely broken line, even after swapping
                 }
             }
-            _state = _service_description.empty()
-                         ? static_cast<int>(parseHostState(_state_type))
-                         : static_cast<int>(parseServiceState(_state_type));
+            _state = _service_description->empty()
+                         ? static_cast<int>(parseHostState(*_state_type))
+                         : static_cast<int>(parseServiceState(*_state_type));
             return;
         case Param::ContactName:
-            _contact_name = field;
+            _contact_name = intern(str);
             return;
         case Param::HostState:
-            _state = static_cast<int>(parseHostState(field));
+            _state = static_cast<int>(parseHostState(str));
             return;
         case Param::ServiceState:
         case Param::ExitCode:  // HACK: Encoded as a service state! :-P
-            _state = static_cast<int>(parseServiceState(field));
+            _state = static_cast<int>(parseServiceState(str));
             return;
         case Param::State:
-            _state = atoi(field.c_str());
+            _state = toInt(str);
             return;
         case Param::StateType:
-            _state_type = field;
+            _state_type = intern(str);
             return;
         case Param::Attempt:
-            _attempt = atoi(field.c_str());
+            _attempt = toInt(str);
             return;
         case Param::Comment:
             _comment = field;
@@ -114,13 +190,17 @@ void LogEntry::assign(Param par, const std::string &field) {
             _plugin_output = field;
             return;
         case Param::LongPluginOutput:
-            _long_plugin_output = mk::to_multi_line(field);
+            _long_plugin_output = field;
             return;
         case Param::Ignore:
             return;
     }
 };
 
+std::string LogEntry::longPluginOutput() const {
+    return mk::to_multi_line(std::string{view(_long_plugin_output)});
+}
+
 std::vector<LogEntry::LogDef> LogEntry::log_definitions{
     LogDef{"INITIAL HOST STATE",
            Class::state,
@@ -290,82 +370,150 @@ std::vector<LogEntry::LogDef> LogEntry::log_definitions{
                Param::Ignore  // command
            }}};
 
-// A bit verbose, but we avoid unnecessary string copies below.
-void LogEntry::classifyLogMessage() {
-    for (const auto &def : log_definitions) {
-        if (textStartsWith(def.prefix) &&
-            _message.compare(timestamp_prefix_length + def.prefix.size(), 2,
-                             ": ") == 0) {
-            _type = &def.prefix[0];
-            _class = def.log_class;
-            _kind = def.log_type;
-            // TODO(sp) Use boost::tokenizer instead of this index fiddling
-            size_t pos = timestamp_prefix_length + def.prefix.size() + 2;
-            for (Param par : def.params) {
-                size_t sep_pos = _message.find(';', pos);
-                size_t end_pos =
-                    sep_pos == std::string::npos ? _message.size() : sep_pos;
-                assign(par, _message.substr(pos, end_pos - pos));
-                pos = sep_pos == std::string::npos ? _message.size()
-                                                   : (sep_pos + 1);
-            }
-            return;
-        }
+// static
+LogEntry::Class LogEntry::classify(std::string_view line) {
+    if (!hasTimestampPrefix(line)) {
+        return Class::invalid;
     }
-    _type = &_message[timestamp_prefix_length];
-    if (textStartsWith("LOG VERSION: 2.0")) {
-        _class = Class::program;
-        _kind = LogEntryKind::log_version;
-        return;
+    auto text = line.substr(timestamp_prefix_length);
+    if (const auto *def = findDefinition(text)) {
+        return def->log_class;
     }
-    if (textStartsWith("logging initial states") ||
-        textStartsWith("logging intitial states")) {
-        _class = Class::program;
-        _kind = LogEntryKind::log_initial_states;
-        return;
+    return classifyText(text).first;
+}
+
+// Parses exactly like the constructor does, but only the fields we need.
+// static
+LogEntry::Summary LogEntry::summarize(std::string_view line) {
+    Summary summary{Class::invalid, 0, {}};
+    if (!hasTimestampPrefix(line)) {
+        return summary;
     }
-    if (textContains("starting...") || textContains("active mode...")) {
-        _class = Class::program;
-        _kind = LogEntryKind::core_starting;
-        return;
+    auto digits = line.substr(1, 10);
+    auto [ptr, ec] = std::from_chars(
+        digits.data(), digits.data() + digits.size(), summary.time);
+    if (ec != std::errc{}) {
+        summary.time = 0;
+        return summary;
     }
-    if (textContains("shutting down...") || textContains("Bailing out") ||
-        textContains("standby mode...")) {
-        _class = Class::program;
-        _kind = LogEntryKind::core_stopping;
-        return;
+    auto text = line.substr(timestamp_prefix_length);
+    const auto *def = findDefinition(text);
+    if (def == nullptr) {
+        summary.log_class = classifyText(text).first;
+        return summary;
     }
-    if (textContains("restarting...")) {
-        _class = Class::program;
-        _kind = LogEntryKind::none;
-        return;
+    summary.log_class = def->log_class;
+    auto fields = text.substr(def->prefix.size() + 2);
+    for (Param par : def->params) {
+        auto sep_pos = fields.find(';');
+        if (par == Param::HostName) {
+            summary.host_name = fields.substr(0, sep_pos);
+            break;
+        }
+        if (sep_pos == std::string_view::npos) {
+            break;
+        }
+        fields.remove_prefix(sep_pos + 1);
+    }
+    return summary;
+}
+
+// All definitions match "PREFIX: " and no prefix contains a colon, so instead
+// of trying each prefix in turn, we look up the text before the first colon in
+// a table sorted by prefix, built once from log_definitions.
+// static
+const LogEntry::LogDef *LogEntry::findDefinition(std::string_view text) {
+    using entry_t = std::pair<std::string_view, const LogDef *>;
+    static const auto by_prefix = [] {
+        std::vector<entry_t> table;
+        table.reserve(log_definitions.size());
+        for (const auto &def : log_definitions) {
+            table.emplace_back(def.prefix, &def);
+        }
+        std::sort(table.begin(), table.end());
+        return table;
+    }();
+    static const auto max_prefix_length =
+        std::max_element(by_prefix.begin(), by_prefix.end(),
+                         [](const entry_t &a, const entry_t &b) {
+                             return a.first.size() < b.first.size();
+                         })
+            ->first.size();
+
+    // No need to look for the colon beyond the longest prefix.
+    auto colon = text.substr(0, max_prefix_length + 1).find(':');
+    if (colon == std::string_view::npos || text.substr(colon + 1, 1) != " ") {
+        return nullptr;
     }
-    _class = Class::info;
-    _kind = LogEntryKind::none;
+    auto prefix = text.substr(0, colon);
+    auto it = std::lower_bound(
+        by_prefix.begin(), by_prefix.end(), prefix,
+        [](const entry_t &e, std::string_view p) { return e.first < p; });
+    return it != by_prefix.end() && it->first == prefix ? it->second
+                                                        : nullptr;
 }
 
-bool LogEntry::textStartsWith(const std::string &what) const {
-    return _message.compare(timestamp_prefix_length, what.size(), what) == 0;
+// static
+std::pair<LogEntry::Class, LogEntryKind> LogEntry::classifyText(
+    std::string_view text) {
+    if (startsWith(text, "LOG VERSION: 2.0")) {
+        return {Class::program, LogEntryKind::log_version};
+    }
+    if (startsWith(text, "logging initial states") ||
+        startsWith(text, "logging intitial states")) {
+        return {Class::program, LogEntryKind::log_initial_states};
+    }
+    if (contains(text, "starting...") || contains(text, "active mode...")) {
+        return {Class::program, LogEntryKind::core_starting};
+    }
+    if (contains(text, "shutting down...") || contains(text, "Bailing out") ||
+        contains(text, "standby mode...")) {
+        return {Class::program, LogEntryKind::core_stopping};
+    }
+    if (contains(text, "restarting...")) {
+        return {Class::program, LogEntryKind::none};
+    }
+    return {Class::info, LogEntryKind::none};
 }
 
-bool LogEntry::textContains(const std::string &what) const {
-    return _message.find(what, timestamp_prefix_length) != std::string::npos;
+// A bit verbose, but we avoid unnecessary string copies below.
+void LogEntry::classifyLogMessage() {
+    auto text = std::string_view{_message}.substr(timestamp_prefix_length);
+    if (const auto *def = findDefinition(text)) {
+        _type = &def->prefix[0];
+        _class = def->log_class;
+        _kind = def->log_type;
+        // TODO(sp) Use boost::tokenizer instead of this index fiddling
+        size_t pos = timestamp_prefix_length + def->prefix.size() + 2;
+        for (Param par : def->params) {
+            size_t sep_pos = _message.find(';', pos);
+            size_t end_pos =
+                sep_pos == std::string::npos ? _message.size() : sep_pos;
+            assign(par, Span{static_cast<uint32_t>(pos),
+                             static_cast<uint32_t>(end_pos - pos)});
+            pos = sep_pos == std::string::npos ? _message.size()
+                                               : (sep_pos + 1);
+        }
+        return;
+    }
+    _type = &_message[timestamp_prefix_length];
+    std::tie(_class, _kind) = classifyText(text);
 }
 
 namespace {
 // Ugly: Depending on where we're called, the actual state type can be in
 // parentheses at the end, e.g. "ALERTHANDLER (OK)".
-std::string extractStateType(const std::string &str) {
+std::string_view extractStateType(std::string_view str) {
     if (!str.empty() && str[str.size() - 1] == ')') {
         size_t lparen = str.rfind('(');
-        if (lparen != std::string::npos) {
+        if (lparen != std::string_view::npos) {
             return str.substr(lparen + 1, str.size() - lparen - 2);
         }
     }
     return str;
 }
 
-std::unordered_map<std::string, ServiceState> fl_service_state_types{
+std::unordered_map<std::string_view, ServiceState> fl_service_state_types{
     // normal states
     {"OK", ServiceState::ok},
     {"WARNING", ServiceState::warning},
@@ -374,7 +522,7 @@ std::unordered_map<std::string, ServiceState> fl_service_state_types{
     // states from "... ALERT"/"... NOTIFICATION"
     {"RECOVERY", ServiceState::ok}};
 
-std::unordered_map<std::string, HostState> fl_host_state_types{
+std::unordered_map<std::string_view, HostState> fl_host_state_types{
     // normal states
     {"UP", HostState::up},
     {"DOWN", HostState::down},
@@ -390,13 +538,13 @@ std::unordered_map<std::string, HostState> fl_host_state_types{
 }  // namespace
 
 // static
-ServiceState LogEntry::parseServiceState(const std::string &str) {
+ServiceState LogEntry::parseServiceState(std::string_view str) {
     auto it = fl_service_state_types.find(extractStateType(str));
     return it == fl_service_state_types.end() ? ServiceState::ok : it->second;
 }
 
 // static
-HostState LogEntry::parseHostState(const std::string &str) {
+HostState LogEntry::parseHostState(std::string_view str) {
     auto it = fl_host_state_types.find(extractStateType(str));
     return it == fl_host_state_types.end() ? HostState::up : it->second;
 }
@@ -454,12 +602,12 @@ std::string LogEntry::state_info() const {
         case LogEntryKind::state_host_initial:
         case LogEntryKind::state_host:
         case LogEntryKind::alert_host:
-            return parens(_state_type, to_host_state(_state));
+            return parens(stateType(), to_host_state(_state));
 
         case LogEntryKind::state_service_initial:
         case LogEntryKind::state_service:
         case LogEntryKind::alert_service:
-            return parens(_state_type, to_service_state(_state));
+            return parens(stateType(), to_service_state(_state));
 
         case LogEntryKind::none:
             if (strcmp(_type, "HOST NOTIFICATION RESULT") == 0 ||
@@ -471,27 +619,27 @@ std::string LogEntry::state_info() const {
                 return parens("EXIT_CODE", to_exit_code(_state));
             }
             if (strcmp(_type, "HOST NOTIFICATION") == 0) {
-                if (_state_type == "UP" ||    //
-                    _state_type == "DOWN" ||  //
-                    _state_type == "UNREACHABLE") {
-                    return parens("NOTIFY", _state_type);
+                if (stateType() == "UP" ||    //
+                    stateType() == "DOWN" ||  //
+                    stateType() == "UNREACHABLE") {
+                    return parens("NOTIFY", stateType());
                 }
-                if (mk::starts_with(_state_type, "ALERTHANDLER (")) {
+                if (mk::starts_with(stateType(), "ALERTHANDLER (")) {
                     return parens("EXIT_CODE", to_exit_code(_state));
                 }
-                return _state_type;
+                return stateType();
             }
             if (strcmp(_type, "SERVICE NOTIFICATION") == 0) {
-                if (_state_type == "OK" ||        //
-                    _state_type == "WARNING" ||   //
-                    _state_type == "CRITICAL" ||  //
-                    _state_type == "UNKNOWN") {
-                    return parens("NOTIFY", _state_type);
+                if (stateType() == "OK" ||        //
+                    stateType() == "WARNING" ||   //
+                    stateType() == "CRITICAL" ||  //
+                    stateType() == "UNKNOWN") {
+                    return parens("NOTIFY", stateType());
                 }
-                if (mk::starts_with(_state_type, "ALERTHANDLER (")) {
+                if (mk::starts_with(stateType(), "ALERTHANDLER (")) {
                     return parens("EXIT_CODE", to_exit_code(_state));
                 }
-                return _state_type;
+                return stateType();
             }
             if (strcmp(_type, "PASSIVE HOST CHECK") == 0) {
                 return parens("PASSIVE", to_host_state(_state));
@@ -507,7 +655,7 @@ std::string LogEntry::state_info() const {
         case LogEntryKind::flapping_service:
         case LogEntryKind::acknowledge_alert_host:
         case LogEntryKind::acknowledge_alert_service:
-            return _state_type;
+            return stateType();
 
         case LogEntryKind::timeperiod_transition:
         case LogEntryKind::core_starting:
@@ -11,6 +11,8 @@
 #include <cstdint>
 #include <ctime>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
 enum class ServiceState { ok = 0, warning = 1, critical = 2, unknown = 3 };
@@ -88,25 +90,51 @@ public:
     time_t _time;
     Class _class;
     LogEntryKind _kind;
-    std::string _message;  // copy of complete unsplit message
+    std::string _message;  // the only copy of the complete unsplit message
     const char *_options;  // points into _complete after ':'
     const char *_type;     // points into _complete or into static data
-    std::string _host_name;
-    std::string _service_description;
-    std::string _command_name;
-    std::string _contact_name;
     int _state;
-    std::string _state_type;
     int _attempt;
-    std::string _comment;
-    std::string _plugin_output;
-    std::string _long_plugin_output;
 
     // NOTE: line gets modified!
     LogEntry(size_t lineno, std::string line);
     [[nodiscard]] std::string state_info() const;
-    static ServiceState parseServiceState(const std::string &str);
-    static HostState parseHostState(const std::string &str);
+    static ServiceState parseServiceState(std::string_view str);
+    static HostState parseHostState(std::string_view str);
+
+    /// The class a log line would get, determined without constructing a
+    /// LogEntry. Lines with a malformed timestamp prefix are invalid.
+    static Class classify(std::string_view line);
+
+    /// What a LogfileIndex needs to know about a log line, determined without
+    /// constructing a LogEntry, i.e. without copying or interning anything.
+    struct Summary {
+        Class log_class;
+        time_t time;
+        std::string_view host_name;  // points into the line
+    };
+    static Summary summarize(std::string_view line);
+
+    // Names are interned, i.e. shared by all entries mentioning them.
+    [[nodiscard]] const std::string &hostName() const { return *_host_name; }
+    [[nodiscard]] const std::string &serviceDescription() const {
+        return *_service_description;
+    }
+    [[nodiscard]] const std::string &commandName() const {
+        return *_command_name;
+    }
+    [[nodiscard]] const std::string &contactName() const {
+        return *_contact_name;
+    }
+    [[nodiscard]] const std::string &stateType() const { return *_state_type; }
+
+    // Free-form texts are just views into _message.
+    [[nodiscard]] std::string_view comment() const { return view(_comment); }
+    [[nodiscard]] std::string_view pluginOutput() const {
+        return view(_plugin_output);
+    }
+    // The escaped form is kept, it is converted to multiple lines on access.
+    [[nodiscard]] std::string longPluginOutput() const;
 
 private:
     enum class Param {
@@ -134,12 +162,34 @@ private:
         std::vector<Param> params;
     };
 
+    struct Span {
+        uint32_t offset;
+        uint32_t length;
+    };
+
     static std::vector<LogDef> log_definitions;
 
-    void assign(Param par, const std::string &field);
+    const std::string *_host_name;
+    const std::string *_service_description;
+    const std::string *_command_name;
+    const std::string *_contact_name;
+    const std::string *_state_type;
+    Span _comment;
+    Span _plugin_output;
+    Span _long_plugin_output;
+
+    [[nodiscard]] std::string_view view(Span span) const {
+        return std::string_view{_message}.substr(span.offset, span.length);
+    }
+    // Equal names share a single string for the lifetime of the process, so
+    // their addresses identify them, see LogObjectCache. Nodes of a std::set
+    // never move, and the names are never pruned: There are only as many of
+    // them as distinct names in the history, far fewer than log entries.
+    static const std::string *intern(std::string_view str);
+    void assign(Param par, Span field);
     void classifyLogMessage();
-    [[nodiscard]] bool textStartsWith(const std::string &what) const;
-    [[nodiscard]] bool textContains(const std::string &what) const;
+    static const LogDef *findDefinition(std::string_view text);
+    static std::pair<Class, LogEntryKind> classifyText(std::string_view text);
 };
 
 #endif  // LogEntry_h
@@ -0,0 +1,47 @@
+// Copyright (C) 2019 tribe29 GmbH - License: GNU General Public License v2
+// This file is part of Checkmk (https://checkmk.com). It is subject to the
+// terms and conditions defined in the file COPYING, which is part of this
+// source code package.
+
+#include "LogObjectCache.h"
+
+#include "LogEntry.h"
+
+MonitoringCore::Host *LogObjectCache::host(const LogEntry &entry) {
+    const auto &name = entry.hostName();
+    auto it = _hosts.find(&name);
+    if (it == _hosts.end()) {
+        it = _hosts.emplace(&name, _mc->find_host(name)).first;
+    }
+    return it->second;
+}
+
+MonitoringCore::Service *LogObjectCache::service(const LogEntry &entry) {
+    const auto &host_name = entry.hostName();
+    const auto &description = entry.serviceDescription();
+    auto key = std::make_pair(&host_name, &description);
+    auto it = _services.find(key);
+    if (it == _services.end()) {
+        it = _services.emplace(key, _mc->find_service(host_name, description))
+                 .first;
+    }
+    return it->second;
+}
+
+const MonitoringCore::Contact *LogObjectCache::contact(const LogEntry &entry) {
+    const auto &name = entry.contactName();
+    auto it = _contacts.find(&name);
+    if (it == _contacts.end()) {
+        it = _contacts.emplace(&name, _mc->find_contact(name)).first;
+    }
+    return it->second;
+}
+
+const Command *LogObjectCache::command(const LogEntry &entry) {
+    const auto &name = entry.commandName();
+    auto it = _commands.find(&name);
+    if (it == _commands.end()) {
+        it = _commands.emplace(&name, _mc->find_command(name)).first;
+    }
+    return &it->second;
+}
@@ -0,0 +1,54 @@
+// Copyright (C) 2019 tribe29 GmbH - License: GNU General Public License v2
+// This file is part of Checkmk (https://checkmk.com). It is subject to the
+// terms and conditions defined in the file COPYING, which is part of this
+// source code package.
+
+#ifndef LogObjectCache_h
+#define LogObjectCache_h
+
+#include "config.h"  // IWYU pragma: keep
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "MonitoringCore.h"
+class LogEntry;
+
+// Resolves the names mentioned in log entries to the objects of the monitoring
+// core. The names are interned, so we can cache the results by the addresses of
+// the names, and a query touching a million entries only does a lookup per
+// distinct name. A cache lives only as long as a single query, so it never sees
+// a configuration change.
+class LogObjectCache {
+public:
+    explicit LogObjectCache(MonitoringCore *mc) : _mc(mc) {}
+
+    MonitoringCore::Host *host(const LogEntry &entry);
+    MonitoringCore::Service *service(const LogEntry &entry);
+    const MonitoringCore::Contact *contact(const LogEntry &entry);
+    const Command *command(const LogEntry &entry);
+
+private:
+    using name_t = const std::string *;
+
+    struct NamePairHash {
+        size_t operator()(const std::pair<name_t, name_t> &names) const {
+            std::hash<name_t> hash;
+            return hash(names.first) ^ (hash(names.second) << 1);
+        }
+    };
+
+    MonitoringCore *const _mc;
+    std::unordered_map<name_t, MonitoringCore::Host *> _hosts;
+    std::unordered_map<std::pair<name_t, name_t>, MonitoringCore::Service *,
+                       NamePairHash>
+        _services;
+    std::unordered_map<name_t, const MonitoringCore::Contact *> _contacts;
+    // Nodes never move, so we can hand out pointers to the commands.
+    std::unordered_map<name_t, Command> _commands;
+};
+
+#endif  // LogObjectCache_h
@@ -0,0 +1,92 @@
+// Copyright (C) 2019 tribe29 GmbH - License: GNU General Public License v2
+// This file is part of Checkmk (https://checkmk.com). It is subject to the
+// terms and conditions defined in the file COPYING, which is part of this
+// source code package.
+
+#include "LogPrefetcher.h"
+
+#include <algorithm>
+#include <atomic>
+#include <utility>
+
+#include "Logfile.h"
+#include "ThreadPool.h"
+
+namespace {
+// The pool is shared with the helpers of parallel scans, see ThreadPool::run(),
+// and its queue knows no priorities. So all prefetchers together never occupy
+// more than half of the workers, leaving the rest to the queries themselves.
+std::atomic<size_t> prefetch_jobs{0};
+
+size_t claimJobs(size_t max_jobs, size_t wanted) {
+    auto jobs = prefetch_jobs.load();
+    size_t claimed = 0;
+    do {
+        claimed = std::min(wanted, max_jobs > jobs ? max_jobs - jobs : 0);
+    } while (claimed != 0 &&
+             !prefetch_jobs.compare_exchange_weak(jobs, jobs + claimed));
+    return claimed;
+}
+}  // namespace
+
+// Shared by the LogPrefetcher and its jobs, which might outlive it.
+struct LogPrefetcher::State {
+    State(std::vector<std::shared_ptr<Logfile>> logfiles_,
+          size_t max_lines_per_logfile_, unsigned logclasses_,
+          filter_t filter_)
+        : logfiles(std::move(logfiles_))
+        , max_lines_per_logfile(max_lines_per_logfile_)
+        , logclasses(logclasses_)
+        , filter(std::move(filter_)) {}
+
+    // Every job claims the next logfile until there are none left, so the
+    // logfiles are loaded in order, each one by a single job.
+    void work() {
+        for (auto i = next++; i < logfiles.size() && !cancelled;
+             i = next++) {
+            auto &logfile = *logfiles[i];
+            if (filter && !filter(logfile)) {
+                continue;
+            }
+            if (!logfile.prefetch(max_lines_per_logfile, logclasses)) {
+                cancelled = true;  // cache is full
+            }
+        }
+    }
+
+    const std::vector<std::shared_ptr<Logfile>> logfiles;
+    const size_t max_lines_per_logfile;
+    const unsigned logclasses;
+    const filter_t filter;
+    std::atomic<size_t> next{0};
+    std::atomic<bool> cancelled{false};
+};
+
+LogPrefetcher::LogPrefetcher(ThreadPool *pool,
+                             std::vector<std::shared_ptr<Logfile>> logfiles,
+                             size_t max_lines_per_logfile, unsigned logclasses,
+                             filter_t filter) {
+    if (pool == nullptr || logfiles.empty()) {
+        return;
+    }
+    _state = std::make_shared<State>(std::move(logfiles),
+                                     max_lines_per_logfile, logclasses,
+                                     std::move(filter));
+    auto jobs = claimJobs((pool->size() + 1) / 2, _state->logfiles.size());
+    for (size_t i = 0; i < jobs; ++i) {
+        pool->post([state = _state] {
+            try {
+                state->work();
+            } catch (...) {
+                // The pool would drop it, too, but we must release the job.
+            }
+            --prefetch_jobs;
+        });
+    }
+}
+
+LogPrefetcher::~LogPrefetcher() {
+    if (_state) {
+        _state->cancelled = true;
+    }
+}
@@ -0,0 +1,44 @@
+// Copyright (C) 2019 tribe29 GmbH - License: GNU General Public License v2
+// This file is part of Checkmk (https://checkmk.com). It is subject to the
+// terms and conditions defined in the file COPYING, which is part of this
+// source code package.
+
+#ifndef LogPrefetcher_h
+#define LogPrefetcher_h
+
+#include "config.h"  // IWYU pragma: keep
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <vector>
+
+class Logfile;
+class ThreadPool;
+
+// Loads the logfiles a query is going to read next on the workers of a
+// ThreadPool, so that parsing them overlaps with processing the current one.
+// The logfiles are loaded roughly in the given order, as long as the LogCache
+// has room for them. Loading stops when the LogPrefetcher is destroyed, but
+// the workers don't wait for the query: Whatever has been loaded so far stays
+// in the cache. Prefetching uses at most half of the workers, even for
+// several queries at once, so parallel scans still get their share.
+class LogPrefetcher {
+public:
+    // Logfiles for which the filter returns false are not loaded.
+    using filter_t = std::function<bool(Logfile &)>;
+
+    LogPrefetcher(ThreadPool *pool,
+                  std::vector<std::shared_ptr<Logfile>> logfiles,
+                  size_t max_lines_per_logfile, unsigned logclasses,
+                  filter_t filter);
+    LogPrefetcher(const LogPrefetcher &) = delete;
+    LogPrefetcher &operator=(const LogPrefetcher &) = delete;
+    ~LogPrefetcher();
+
+private:
+    struct State;
+    std::shared_ptr<State> _state;
+};
+
+#endif  // LogPrefetcher_h
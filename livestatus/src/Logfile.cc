@@ -6,16 +6,26 @@
 #include "Logfile.h"
 
 #include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
 #include <cstdlib>
-#include <sstream>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
 #include <utility>
-#include <vector>
 
 #include "LogCache.h"
 #include "LogEntry.h"
 #include "Logger.h"
+#include "global_counters.h"
 
 namespace {
 time_t firstTimestampOf(const std::filesystem::path &path, Logger *logger) {
@@ -41,6 +51,119 @@ time_t firstTimestampOf(const std::filesystem::path &path, Logger *logger) {
     line[11] = 0;
     return atoi(line + 1);
 }
+
+// A read-only view of a whole file, mapped into our address space. This avoids
+// copying every line into a separate buffer before we even know if we need it.
+// Only for archives: Accessing a mapping beyond the end of a file kills us with
+// SIGBUS, so the file must not be truncated while it is mapped.
+class MappedFile {
+public:
+    explicit MappedFile(const std::filesystem::path &path)
+        : _fd(::open(path.c_str(), O_RDONLY | O_CLOEXEC)) {
+        struct stat st {};
+        if (_fd == -1 || ::fstat(_fd, &st) == -1) {
+            return;
+        }
+        _size = static_cast<size_t>(st.st_size);
+        _mtime = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000 +
+                 st.st_mtim.tv_nsec;
+        if (_size == 0) {
+            return;  // mmap doesn't like empty mappings
+        }
+        _data = ::mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, _fd, 0);
+        if (_data == MAP_FAILED) {
+            _data = nullptr;
+            return;
+        }
+        ::madvise(_data, _size, MADV_SEQUENTIAL);
+    }
+
+    ~MappedFile() {
+        if (_data != nullptr) {
+            ::munmap(_data, _size);
+        }
+        if (_fd != -1) {
+            ::close(_fd);
+        }
+    }
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    [[nodiscard]] bool ok() const {
+        return _fd != -1 && (_size == 0 || _data != nullptr);
+    }
+
+    [[nodiscard]] LogfileIndex::Stamp stamp() const {
+        return {_size, _mtime};
+    }
+
+    [[nodiscard]] std::string_view contents() const {
+        return _data == nullptr
+                   ? std::string_view{}
+                   : std::string_view{static_cast<const char *>(_data), _size};
+    }
+
+private:
+    int _fd;
+    size_t _size{0};
+    int64_t _mtime{0};
+    void *_data{nullptr};
+};
+
+// The end of a file from the given offset on, read into a buffer. This is for
+// the current logfile, which grows while we read it and which might even be
+// truncated, e.g. by logrotate's copytruncate, so mapping it is not safe.
+class FileTail {
+public:
+    FileTail(const std::filesystem::path &path, size_t offset) {
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        struct stat st {};
+        if (fd == -1 || ::fstat(fd, &st) == -1) {
+            if (fd != -1) {
+                ::close(fd);
+            }
+            return;
+        }
+        auto size = static_cast<size_t>(st.st_size);
+        _offset = std::min(offset, size);
+        _data.resize(size - _offset);
+        size_t pos = 0;
+        while (pos < _data.size()) {
+            auto n = ::pread(fd, &_data[pos], _data.size() - pos,
+                             static_cast<off_t>(_offset + pos));
+            if (n == -1 && errno == EINTR) {
+                continue;
+            }
+            if (n == -1) {
+                ::close(fd);
+                return;
+            }
+            if (n == 0) {
+                break;  // truncated in the meantime
+            }
+            pos += static_cast<size_t>(n);
+        }
+        ::close(fd);
+        _data.resize(pos);
+        _ok = true;
+    }
+
+    [[nodiscard]] bool ok() const { return _ok; }
+
+    // where the contents start in the file
+    [[nodiscard]] size_t offset() const { return _offset; }
+
+    // the size of the file as far as we have read it
+    [[nodiscard]] size_t size() const { return _offset + _data.size(); }
+
+    [[nodiscard]] std::string_view contents() const { return _data; }
+
+private:
+    bool _ok{false};
+    size_t _offset{0};
+    std::string _data;
+};
 }  // namespace
 
 Logfile::Logfile(Logger *logger, LogCache *log_cache,
@@ -50,135 +173,226 @@ Logfile::Logfile(Logger *logger, LogCache *log_cache,
     , _path(std::move(path))
     , _since(firstTimestampOf(_path, _logger))
     , _watch(watch)
-    , _read_pos{}
+    , _pins(0)
+    , _last_used(0)
+    , _read_pos(0)
+    , _loaded_size(0)
     , _lineno(0)
     , _logclasses_read(0) {}
 
+bool Logfile::needsLoading(unsigned logclasses) const {
+    if ((logclasses & ~_logclasses_read) != 0) {
+        return true;
+    }
+    // The current logfile might have grown since we have loaded it.
+    struct stat st {};
+    return _watch && ::stat(_path.c_str(), &st) == 0 &&
+           static_cast<size_t>(st.st_size) != _loaded_size;
+}
+
 void Logfile::load(size_t max_lines_per_logfile, unsigned logclasses) {
     unsigned missing_types = logclasses & ~_logclasses_read;
     // The current logfile has the _watch flag set to true.
     // In that case, if the logfile has grown, we need to
     // load the rest of the file, even if no logclasses
     // are missing.
+    if (!_watch && missing_types == 0) {
+        return;
+    }
     if (_watch) {
-        FILE *file = fopen(_path.c_str(), "r");
-        if (file == nullptr) {
+        // Lines of missing classes can be anywhere in the file, all others
+        // only in the part which has been added since we last read it.
+        FileTail file{_path, missing_types == 0U ? _read_pos : 0};
+        if (!file.ok()) {
             generic_error ge("cannot open logfile " + _path.string());
             Informational(_logger) << ge;
             return;
         }
-        // If we read this file for the first time, we initialize
-        // the current file position to 0
-        if (_lineno == 0) {
-            fgetpos(file, &_read_pos);
-        }
-
+        auto contents = file.contents();
+        _loaded_size = file.size();
         // file might have grown. Read all classes that we already
         // have read to the end of the file
         if (_logclasses_read != 0U) {
-            fsetpos(file, &_read_pos);  // continue at previous end
-            loadRange(max_lines_per_logfile, file, _logclasses_read,
-                      logclasses);
-            fgetpos(file, &_read_pos);
+            auto start = std::min(_read_pos, file.size());
+            auto added = contents.substr(start - file.offset());
+            _read_pos = start + loadRange(max_lines_per_logfile, added,
+                                          _logclasses_read, logclasses);
         }
         if (missing_types != 0U) {
-            fseek(file, 0, SEEK_SET);
             _lineno = 0;
-            loadRange(max_lines_per_logfile, file, missing_types, logclasses);
+            // remember current end of file
+            _read_pos = loadRange(max_lines_per_logfile, contents,
+                                  missing_types, logclasses);
             _logclasses_read |= missing_types;
-            fgetpos(file, &_read_pos);  // remember current end of file
         }
-        fclose(file);
     } else {
-        if (missing_types == 0) {
-            return;
-        }
-
-        FILE *file = fopen(_path.c_str(), "r");
-        if (file == nullptr) {
+        MappedFile file{_path};
+        if (!file.ok()) {
             generic_error ge("cannot open logfile " + _path.string());
             Informational(_logger) << ge;
             return;
         }
-
-        _lineno = 0;
-        loadRange(max_lines_per_logfile, file, missing_types, logclasses);
+        auto contents = file.contents();
+        // Archives don't change anymore, so we can use their index to skip
+        // all parts not containing any of the missing classes.
+        ensureIndex(file.stamp(), contents);
+        for (const auto &bucket : _index->buckets()) {
+            if ((bucket.classes & missing_types) == 0) {
+                continue;
+            }
+            _lineno = bucket.lineno;
+            auto range = contents.substr(bucket.offset, bucket.length);
+            if (loadRange(max_lines_per_logfile, range, missing_types,
+                          logclasses) < range.size()) {
+                break;  // too many lines
+            }
+        }
         _logclasses_read |= missing_types;
-        fclose(file);
     }
+    _entries.sort();
+}
+
+std::shared_ptr<const LogfileIndex> Logfile::index() {
+    if (_watch) {
+        return nullptr;
+    }
+    {
+        std::shared_lock<std::shared_mutex> sl(_mutex);
+        if (_index) {
+            return _index;
+        }
+    }
+    std::unique_lock<std::shared_mutex> ul(_mutex);
+    if (!_index) {
+        MappedFile file{_path};
+        if (!file.ok()) {
+            return nullptr;
+        }
+        ensureIndex(file.stamp(), file.contents());
+    }
+    return _index;
 }
 
-void Logfile::loadRange(size_t max_lines_per_logfile, FILE *file,
-                        unsigned missing_types, unsigned logclasses) {
-    std::vector<char> linebuffer(65536);
-    // TODO(sp) We should really use C++ I/O here...
-    while (fgets(&linebuffer[0], static_cast<int>(linebuffer.size()), file) !=
-           nullptr) {
+void Logfile::ensureIndex(LogfileIndex::Stamp stamp,
+                          std::string_view contents) {
+    if (_index && _index->stamp() == stamp) {
+        return;
+    }
+    auto index_path = LogfileIndex::pathFor(_path);
+    if (auto index = LogfileIndex::load(index_path, stamp)) {
+        _index = std::make_shared<const LogfileIndex>(std::move(*index));
+        return;
+    }
+    Debug(_logger) << "building index for " << _path;
+    auto index = LogfileIndex::build(stamp, contents);
+    if (!index.save(index_path)) {
+        Debug(_logger) << "cannot write index " << index_path;
+    }
+    _index = std::make_shared<const LogfileIndex>(std::move(index));
+}
+
+// Returns the number of bytes consumed. Lines are split with memchr(), which is
+// vectorized in any decent C library, and only lines of the wanted classes are
+// turned into a LogEntry.
+size_t Logfile::loadRange(size_t max_lines_per_logfile,
+                          std::string_view contents, unsigned missing_types,
+                          unsigned logclasses) {
+    size_t pos = 0;
+    while (pos < contents.size()) {
         if (_lineno >= max_lines_per_logfile) {
             Error(_logger) << "more than " << max_lines_per_logfile
                            << " lines in " << _path << ", ignoring the rest!";
-            return;
+            return pos;
         }
         _lineno++;
-        // remove trailing newline (should be nuked, see above)
-        auto it =
-            std::find_if(linebuffer.begin(), linebuffer.end(),
-                         [](auto ch) { return ch == '\0' || ch == '\n'; });
-        if (it != linebuffer.end()) {
-            *it = '\0';
-        }
-        if (processLogLine(_lineno, &linebuffer[0], missing_types)) {
-            _log_cache->logLineHasBeenAdded(this, logclasses);
+        const char *begin = contents.data() + pos;
+        size_t remaining = contents.size() - pos;
+        const auto *newline =
+            static_cast<const char *>(memchr(begin, '\n', remaining));
+        size_t length = newline == nullptr
+                            ? remaining
+                            : static_cast<size_t>(newline - begin);
+        pos += newline == nullptr ? length : length + 1;
+        if (auto bytes = processLogLine(
+                _lineno, std::string_view{begin, length}, missing_types)) {
+            _log_cache->logLineHasBeenAdded(this, bytes, logclasses);
         }
     }
+    return pos;
 }
 
-long Logfile::freeMessages(unsigned logclasses) {
-    long freed = 0;
-    // We have to be careful here: Erasing an element from an associative
-    // container invalidates the iterator pointing to it. The solution is the
-    // usual post-increment idiom, see Scott Meyers' "Effective STL", item 9
-    // ("Choose carefully among erasing options.").
-    for (auto it = _entries.begin(); it != _entries.end();) {
-        if (((1U << static_cast<int>(it->second->_class)) & logclasses) != 0U) {
-            _entries.erase(it++);
-            freed++;
-        } else {
-            ++it;
-        }
+Logfile::Usage Logfile::freeMessagesIfUnused(unsigned logclasses) {
+    std::unique_lock<std::shared_mutex> ul(_mutex, std::try_to_lock);
+    return ul.owns_lock() ? freeMessages(logclasses) : Usage{0, 0};
+}
+
+Logfile::Usage Logfile::freeMessages(unsigned logclasses) {
+    if (_pins != 0 || _entries.empty()) {
+        return {0, 0};
     }
+    auto freed = _entries.erase(logclasses);
     _logclasses_read &= ~logclasses;
+    if (freed.messages != 0) {
+        counterIncrement(Counter::log_cache_evictions);
+    }
     return freed;
 }
 
-bool Logfile::processLogLine(size_t lineno, std::string line,
-                             unsigned logclasses) {
-    auto entry = std::make_unique<LogEntry>(lineno, std::move(line));
-    // ignored invalid lines
-    if (entry->_class == LogEntry::Class::invalid) {
-        return false;
-    }
-    if (((1U << static_cast<int>(entry->_class)) & logclasses) == 0U) {
-        return false;
+size_t Logfile::processLogLine(size_t lineno, std::string_view line,
+                               unsigned logclasses) {
+    // A NUL byte terminates the line, just like it did with fgets().
+    line = line.substr(0, line.find('\0'));
+    // Filter on the cheaply computed class first, most lines of an archive are
+    // usually not needed for a query.
+    auto log_class = LogEntry::classify(line);
+    if (log_class == LogEntry::Class::invalid ||
+        ((1U << static_cast<int>(log_class)) & logclasses) == 0U) {
+        return 0;
     }
-    uint64_t key = makeKey(entry->_time, entry->_lineno);
-    if (_entries.find(key) != _entries.end()) {
-        // this should never happen. The lineno must be unique!
-        Error(_logger) << "strange duplicate logfile line " << entry->_message;
-        return false;
+    // ignores invalid lines
+    const auto *entry = _entries.add(log_class, lineno, std::string{line});
+    if (entry == nullptr) {
+        return 0;
     }
-    _entries[key] = std::move(entry);
-    return true;
+    return LogEntries::memoryUsage(*entry);
 }
 
-const logfile_entries_t *Logfile::getEntriesFor(size_t max_lines_per_logfile,
-                                                unsigned logclasses) {
-    // make sure all messages are present
-    load(max_lines_per_logfile, logclasses);
+const LogEntries *Logfile::getEntriesFor(
+    size_t max_lines_per_logfile, unsigned logclasses,
+    std::shared_lock<std::shared_mutex> &lock) {
+    lock = std::shared_lock<std::shared_mutex>{};
+    lock = std::shared_lock<std::shared_mutex>{_mutex};
+    _last_used = std::chrono::steady_clock::now().time_since_epoch().count();
+    if (!needsLoading(logclasses)) {
+        counterIncrement(Counter::log_cache_hits);
+        return &_entries;
+    }
+    counterIncrement(Counter::log_cache_misses);
+    // Loading needs exclusive access. Our entries are pinned after loading
+    // until we have our shared lock again, so nobody can free them in between.
+    lock.unlock();
+    {
+        std::unique_lock<std::shared_mutex> ul(_mutex);
+        load(max_lines_per_logfile, logclasses);
+        ++_pins;
+    }
+    lock.lock();
+    --_pins;
     return &_entries;
 }
 
-// static
-uint64_t Logfile::makeKey(time_t t, size_t lineno) {
-    return (static_cast<uint64_t>(t) << 32) | static_cast<uint64_t>(lineno);
+bool Logfile::prefetch(size_t max_lines_per_logfile, unsigned logclasses) {
+    if (!_log_cache->hasRoomForPrefetching()) {
+        return false;
+    }
+    std::unique_lock<std::shared_mutex> ul(_mutex, std::try_to_lock);
+    if (ul.owns_lock() && needsLoading(logclasses)) {
+        Debug(_logger) << "prefetching " << _path;
+        // Count as used, otherwise we would be the first victim when the
+        // LogCache has to free memory.
+        _last_used =
+            std::chrono::steady_clock::now().time_since_epoch().count();
+        load(max_lines_per_logfile, logclasses);
+    }
+    return true;
 }
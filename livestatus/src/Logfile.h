@@ -10,39 +10,59 @@
 // bug?
 #include "config.h"  // IWYU pragma: keep
 
-#include <cstdint>
-#include <cstdio>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
 #include <ctime>
 #include <filesystem>
-#include <map>
 #include <memory>
-#include <string>
+#include <shared_mutex>
+#include <string_view>
 
+#include "LogEntries.h"
 #include "LogEntry.h"  // IWYU pragma: keep
+#include "LogfileIndex.h"
 class LogCache;
 class Logger;
 
-// key is time_t . lineno
-using logfile_entries_t = std::map<uint64_t, std::unique_ptr<LogEntry>>;
-
+// Several queries can read the entries of a Logfile concurrently, each
+// holding a shared lock on it. Loading more entries and freeing them needs
+// exclusive access. To avoid deadlocks, a query never waits for the lock of a
+// Logfile while it holds the lock of another one, and LogCache only frees the
+// entries of other Logfiles if they are not in use.
 class Logfile {
 public:
     Logfile(Logger *logger, LogCache *log_cache, std::filesystem::path path,
             bool watch);
     [[nodiscard]] std::filesystem::path path() const { return _path; }
-
-    // for tricky protocol between LogCache::logLineHasBeenAdded and this class
     [[nodiscard]] time_t since() const { return _since; }
-    [[nodiscard]] unsigned classesRead() const { return _logclasses_read; }
-    [[nodiscard]] size_t size() const { return _entries.size(); }
-    long freeMessages(unsigned logclasses);
 
-    // for TableStateHistory and TableLog
-    const logfile_entries_t *getEntriesFor(size_t max_lines_per_logfile,
-                                           unsigned logclasses);
+    // for tricky protocol between LogCache::logLineHasBeenAdded and this
+    // class: The first one requires exclusive access to this Logfile, the
+    // second one gets it if possible. Both do nothing while a query is
+    // switching locks to load entries it is going to use.
+    using Usage = LogEntries::Usage;
+    Usage freeMessages(unsigned logclasses);
+    Usage freeMessagesIfUnused(unsigned logclasses);
+    [[nodiscard]] std::chrono::steady_clock::time_point lastUsed() const {
+        return std::chrono::steady_clock::time_point{
+            std::chrono::steady_clock::duration{_last_used}};
+    }
+
+    // for TableStateHistory and TableLog: The entries can be used while the
+    // given lock is held. Any lock held before via that lock is released
+    // before the lock of this Logfile is acquired.
+    const LogEntries *getEntriesFor(
+        size_t max_lines_per_logfile, unsigned logclasses,
+        std::shared_lock<std::shared_mutex> &lock);
+
+    // for LogPrefetcher: Loads the entries in the background unless somebody
+    // else is using this Logfile already. Returns false when the LogCache
+    // has no room left for prefetched entries.
+    bool prefetch(size_t max_lines_per_logfile, unsigned logclasses);
 
-    // for TableLog::answerQuery
-    static uint64_t makeKey(time_t t, size_t lineno);
+    // for TableLog::answerQuery, only archived logfiles have an index
+    std::shared_ptr<const LogfileIndex> index();
 
 private:
     Logger *const _logger;
@@ -50,15 +70,23 @@ private:
     const std::filesystem::path _path;
     const time_t _since;  // time of first entry
     const bool _watch;    // true only for current logfile
-    fpos_t _read_pos;     // read until this position
+    mutable std::shared_mutex _mutex;
+    std::atomic<int> _pins;  // queries switching from exclusive to shared
+    std::atomic<std::chrono::steady_clock::rep> _last_used;
+    size_t _read_pos;     // read until this byte offset
+    size_t _loaded_size;  // size of the file when it was last loaded
     size_t _lineno;       // read until this line
-    logfile_entries_t _entries;
+    LogEntries _entries;
     unsigned _logclasses_read;  // only these types have been read
+    std::shared_ptr<const LogfileIndex> _index;
 
+    [[nodiscard]] bool needsLoading(unsigned logclasses) const;
     void load(size_t max_lines_per_logfile, unsigned logclasses);
-    void loadRange(size_t max_lines_per_logfile, FILE *file,
-                   unsigned missing_types, unsigned logclasses);
-    bool processLogLine(size_t lineno, std::string line, unsigned logclasses);
+    void ensureIndex(LogfileIndex::Stamp stamp, std::string_view contents);
+    size_t loadRange(size_t max_lines_per_logfile, std::string_view contents,
+                     unsigned missing_types, unsigned logclasses);
+    size_t processLogLine(size_t lineno, std::string_view line,
+                          unsigned logclasses);
 };
 
 #endif  // Logfile_h
@@ -0,0 +1,192 @@
+// Copyright (C) 2019 tribe29 GmbH - License: GNU General Public License v2
+// This file is part of Checkmk (https://checkmk.com). It is subject to the
+// terms and conditions defined in the file COPYING, which is part of this
+// source code package.
+
+#include "LogfileIndex.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include "LogEntry.h"
+
+namespace {
+// Bump the version whenever the layout or the classification changes.
+constexpr char magic[8] = {'L', 'S', 'I', 'D', 'X', '\0', '\0', '\1'};
+
+const std::string index_extension = ".idx";
+
+template <typename T>
+void write(std::ostream &os, const T &value) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    os.write(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+template <typename T>
+bool read(std::istream &is, T &value) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    return static_cast<bool>(
+        is.read(reinterpret_cast<char *>(&value), sizeof(value)));
+}
+}  // namespace
+
+// static
+LogfileIndex LogfileIndex::build(Stamp stamp, std::string_view contents) {
+    LogfileIndex index;
+    index._stamp = stamp;
+    size_t pos = 0;
+    uint64_t lineno = 0;
+    while (pos < contents.size()) {
+        if (lineno % lines_per_bucket == 0) {
+            index._buckets.push_back(Bucket{pos, 0, lineno, 0, 0, 0});
+        }
+        auto &bucket = index._buckets.back();
+        const char *begin = contents.data() + pos;
+        size_t remaining = contents.size() - pos;
+        const auto *newline =
+            static_cast<const char *>(memchr(begin, '\n', remaining));
+        size_t length = newline == nullptr
+                            ? remaining
+                            : static_cast<size_t>(newline - begin);
+        pos += newline == nullptr ? length : length + 1;
+        bucket.length = pos - bucket.offset;
+        lineno++;
+
+        // Classify exactly like Logfile::processLogLine() does, but without
+        // constructing a LogEntry: Building an index must not cost another
+        // full parse of the logfile.
+        std::string_view line{begin, length};
+        line = line.substr(0, line.find('\0'));
+        auto summary = LogEntry::summarize(line);
+        if (summary.log_class == LogEntry::Class::invalid) {
+            continue;
+        }
+        if (bucket.classes == 0) {
+            bucket.first = summary.time;
+            bucket.last = summary.time;
+        } else {
+            bucket.first = std::min(bucket.first, summary.time);
+            bucket.last = std::max(bucket.last, summary.time);
+        }
+        if (index._classes == 0) {
+            index._first = summary.time;
+            index._last = summary.time;
+        } else {
+            index._first = std::min(index._first, summary.time);
+            index._last = std::max(index._last, summary.time);
+        }
+        auto mask = 1U << static_cast<int>(summary.log_class);
+        bucket.classes |= mask;
+        index._classes |= mask;
+        if (!summary.host_name.empty()) {
+            index._host_names.emplace(summary.host_name);
+        }
+    }
+    return index;
+}
+
+// static
+std::optional<LogfileIndex> LogfileIndex::load(
+    const std::filesystem::path &path, Stamp stamp) {
+    std::ifstream is(path, std::ios::binary);
+    char file_magic[sizeof(magic)];
+    if (!is.read(file_magic, sizeof(file_magic)) ||
+        memcmp(file_magic, magic, sizeof(magic)) != 0) {
+        return {};
+    }
+    LogfileIndex index;
+    uint64_t num_buckets = 0;
+    if (!read(is, index._stamp.size) || !read(is, index._stamp.mtime) ||
+        !(index._stamp == stamp) || !read(is, index._first) ||
+        !read(is, index._last) || !read(is, index._classes) ||
+        !read(is, num_buckets)) {
+        return {};
+    }
+    for (uint64_t i = 0; i < num_buckets; ++i) {
+        Bucket bucket{};
+        if (!read(is, bucket.offset) || !read(is, bucket.length) ||
+            !read(is, bucket.lineno) || !read(is, bucket.first) ||
+            !read(is, bucket.last) || !read(is, bucket.classes) ||
+            bucket.offset + bucket.length > stamp.size) {
+            return {};
+        }
+        index._buckets.push_back(bucket);
+    }
+    uint64_t num_host_names = 0;
+    if (!read(is, num_host_names)) {
+        return {};
+    }
+    for (uint64_t i = 0; i < num_host_names; ++i) {
+        uint32_t length = 0;
+        if (!read(is, length) || length > stamp.size) {
+            return {};
+        }
+        std::string host_name(length, '\0');
+        if (!is.read(host_name.data(), length)) {
+            return {};
+        }
+        index._host_names.insert(std::move(host_name));
+    }
+    return index;
+}
+
+bool LogfileIndex::save(const std::filesystem::path &path) const {
+    auto tmp_path = path;
+    tmp_path += ".tmp";
+    {
+        std::ofstream os(tmp_path, std::ios::binary | std::ios::trunc);
+        os.write(magic, sizeof(magic));
+        write(os, _stamp.size);
+        write(os, _stamp.mtime);
+        write(os, _first);
+        write(os, _last);
+        write(os, _classes);
+        write(os, static_cast<uint64_t>(_buckets.size()));
+        for (const auto &bucket : _buckets) {
+            write(os, bucket.offset);
+            write(os, bucket.length);
+            write(os, bucket.lineno);
+            write(os, bucket.first);
+            write(os, bucket.last);
+            write(os, bucket.classes);
+        }
+        write(os, static_cast<uint64_t>(_host_names.size()));
+        for (const auto &host_name : _host_names) {
+            write(os, static_cast<uint32_t>(host_name.size()));
+            os.write(host_name.data(),
+                     static_cast<std::streamsize>(host_name.size()));
+        }
+        if (!os.flush()) {
+            std::error_code ec;
+            std::filesystem::remove(tmp_path, ec);
+            return false;
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmp_path, path, ec);
+    if (ec) {
+        std::filesystem::remove(tmp_path, ec);
+        return false;
+    }
+    return true;
+}
+
+// static
+std::filesystem::path LogfileIndex::pathFor(
+    const std::filesystem::path &logfile) {
+    auto path = logfile;
+    path += index_extension;
+    return path;
+}
+
+// static
+bool LogfileIndex::isIndexFile(const std::filesystem::path &path) {
+    // Half-written indexes have an additional ".tmp" extension.
+    auto extension = path.extension();
+    return extension == index_extension ||
+           (extension == ".tmp" && path.stem().extension() == index_extension);
+}
@@ -0,0 +1,87 @@
+// Copyright (C) 2019 tribe29 GmbH - License: GNU General Public License v2
+// This file is part of Checkmk (https://checkmk.com). It is subject to the
+// terms and conditions defined in the file COPYING, which is part of this
+// source code package.
+
+#ifndef LogfileIndex_h
+#define LogfileIndex_h
+
+#include "config.h"  // IWYU pragma: keep
+
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <filesystem>
+#include <functional>
+#include <optional>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/// A summary of an archived (i.e. immutable) logfile, which is stored in a
+/// sidecar file next to it. It tells us which parts of the logfile can contain
+/// lines of a given class, the time range covered by the logfile and the hosts
+/// mentioned in it, so we can skip files and lines without parsing them.
+class LogfileIndex {
+public:
+    static constexpr size_t lines_per_bucket = 1024;
+
+    /// Identifies the version of a logfile an index has been built from.
+    struct Stamp {
+        uint64_t size;
+        int64_t mtime;  // nanoseconds since the epoch
+
+        bool operator==(const Stamp &other) const {
+            return size == other.size && mtime == other.mtime;
+        }
+    };
+
+    /// A consecutive range of lines.
+    struct Bucket {
+        uint64_t offset;  // byte offset of the first line
+        uint64_t length;  // in bytes, including all newlines
+        uint64_t lineno;  // number of lines before this bucket
+        time_t first;     // timestamp range of the valid lines
+        time_t last;
+        uint32_t classes;  // bitmask of the classes of the valid lines
+    };
+
+    static LogfileIndex build(Stamp stamp, std::string_view contents);
+
+    /// Returns an empty optional if there is no valid index for the given
+    /// version of the logfile.
+    static std::optional<LogfileIndex> load(const std::filesystem::path &path,
+                                            Stamp stamp);
+
+    /// Writes the index atomically, returns false on errors.
+    bool save(const std::filesystem::path &path) const;
+
+    /// Where the index for the given logfile is stored.
+    static std::filesystem::path pathFor(const std::filesystem::path &logfile);
+    static bool isIndexFile(const std::filesystem::path &path);
+
+    [[nodiscard]] Stamp stamp() const { return _stamp; }
+    [[nodiscard]] time_t first() const { return _first; }
+    [[nodiscard]] time_t last() const { return _last; }
+    [[nodiscard]] uint32_t classes() const { return _classes; }
+    [[nodiscard]] const std::vector<Bucket> &buckets() const {
+        return _buckets;
+    }
+    /// Entries without a host name are not recorded, so every logfile might
+    /// contain some for an empty one.
+    [[nodiscard]] bool mentionsHost(std::string_view host_name) const {
+        return host_name.empty() ||
+               _host_names.find(host_name) != _host_names.end();
+    }
+
+private:
+    Stamp _stamp{0, 0};
+    time_t _first{0};
+    time_t _last{0};
+    uint32_t _classes{0};
+    std::vector<Bucket> _buckets;
+    std::set<std::string, std::less<>> _host_names;
+};
+
+#endif  // LogfileIndex_h
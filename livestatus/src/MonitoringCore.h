@@ -123,6 +123,8 @@ public:
     virtual Encoding dataEncoding() = 0;
     virtual size_t maxResponseSize() = 0;
     virtual size_t maxCachedMessages() = 0;
+    virtual size_t maxCachedLogBytes() = 0;
+    virtual size_t queryCacheSize() = 0;
 
     [[nodiscard]] virtual AuthorizationKind serviceAuthorization() const = 0;
     [[nodiscard]] virtual AuthorizationKind groupAuthorization() const = 0;
@@ -197,6 +197,10 @@ std::filesystem::path NagiosCore::rrdcachedSocketPath() const {
 Encoding NagiosCore::dataEncoding() { return _data_encoding; }
 size_t NagiosCore::maxResponseSize() { return _limits._max_response_size; }
 size_t NagiosCore::maxCachedMessages() { return _limits._max_cached_messages; }
+size_t NagiosCore::maxCachedLogBytes() {
+    return _limits._max_cached_log_bytes;
+}
+size_t NagiosCore::queryCacheSize() { return _limits._query_cache_size; }
 
 AuthorizationKind NagiosCore::serviceAuthorization() const {
     return _authorization._service;
@@ -284,26 +288,30 @@ void NagiosCore::registerComment(nebstruct_comment_data *data) {
     _store.registerComment(data);
 }
 
+void NagiosCore::updateState(const host *hst) { _store.updateState(hst); }
+
+void NagiosCore::updateState(const service *svc) { _store.updateState(svc); }
+
+void NagiosCore::updateStates() { _store.updateStates(); }
+
 std::vector<DowntimeData> NagiosCore::downtimes_for_object(
     const ::host *h, const ::service *s) const {
     std::vector<DowntimeData> result;
-    for (const auto &entry : _store._downtimes) {
-        auto *dt = static_cast<Downtime *>(entry.second.get());
-        if (dt->_host == h && dt->_service == s) {
-            result.push_back({
-                dt->_id,
-                dt->_author_name,
-                dt->_comment,
-                false,
-                std::chrono::system_clock::from_time_t(dt->_entry_time),
-                std::chrono::system_clock::from_time_t(dt->_start_time),
-                std::chrono::system_clock::from_time_t(dt->_end_time),
-                dt->_fixed != 0,
-                std::chrono::seconds(dt->_duration),
-                0,
-                dt->_type != 0,
-            });
-        }
+    for (const auto *entry : _store._downtimes.entriesFor(h, s)) {
+        const auto *dt = static_cast<const Downtime *>(entry);
+        result.push_back({
+            dt->_id,
+            dt->_author_name,
+            dt->_comment,
+            false,
+            std::chrono::system_clock::from_time_t(dt->_entry_time),
+            std::chrono::system_clock::from_time_t(dt->_start_time),
+            std::chrono::system_clock::from_time_t(dt->_end_time),
+            dt->_fixed != 0,
+            std::chrono::seconds(dt->_duration),
+            0,
+            dt->_type != 0,
+        });
     }
     return result;
 }
@@ -311,14 +319,12 @@ std::vector<DowntimeData> NagiosCore::downtimes_for_object(
 std::vector<CommentData> NagiosCore::comments_for_object(
     const ::host *h, const ::service *s) const {
     std::vector<CommentData> result;
-    for (const auto &entry : _store._comments) {
-        auto *co = static_cast<Comment *>(entry.second.get());
-        if (co->_host == h && co->_service == s) {
-            result.push_back(
-                {co->_id, co->_author_name, co->_comment,
-                 static_cast<uint32_t>(co->_entry_type),
-                 std::chrono::system_clock::from_time_t(co->_entry_time)});
-        }
+    for (const auto *entry : _store._comments.entriesFor(h, s)) {
+        const auto *co = static_cast<const Comment *>(entry);
+        result.push_back(
+            {co->_id, co->_author_name, co->_comment,
+             static_cast<uint32_t>(co->_entry_type),
+             std::chrono::system_clock::from_time_t(co->_entry_time)});
     }
     return result;
 }
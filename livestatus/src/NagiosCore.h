@@ -44,8 +44,10 @@ struct NagiosPaths {
 
 struct NagiosLimits {
     size_t _max_cached_messages{500000};
+    size_t _max_cached_log_bytes{256 * 1024 * 1024};
     size_t _max_lines_per_logfile{1000000};
     size_t _max_response_size{100 * 1024 * 1024};
+    size_t _query_cache_size{0};
 };
 
 struct NagiosAuthorization {
@@ -100,6 +102,8 @@ public:
     Encoding dataEncoding() override;
     size_t maxResponseSize() override;
     size_t maxCachedMessages() override;
+    size_t maxCachedLogBytes() override;
+    size_t queryCacheSize() override;
 
     AuthorizationKind serviceAuthorization() const override;
     AuthorizationKind groupAuthorization() const override;
@@ -125,6 +129,9 @@ public:
     bool answerRequest(InputBuffer &input, OutputBuffer &output);
     void registerDowntime(nebstruct_downtime_data *data);
     void registerComment(nebstruct_comment_data *data);
+    void updateState(const host *hst);
+    void updateState(const service *svc);
+    void updateStates();
 
 private:
     Logger *_logger_livestatus;
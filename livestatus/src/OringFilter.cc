@@ -14,6 +14,7 @@
 
 #include "AndingFilter.h"
 #include "Filter.h"
+#include "FilterProgram.h"
 #include "Row.h"
 
 // static
@@ -68,6 +69,30 @@ std::optional<std::string> OringFilter::stringValueRestrictionFor(
     return restriction;
 }
 
+std::optional<std::string> OringFilter::stringPrefixRestrictionFor(
+    const std::string &column_name) const {
+    std::optional<std::string> restriction;
+    for (const auto &filter : _subfilters) {
+        auto current = filter->stringPrefixRestrictionFor(column_name);
+        if (!current) {
+            return {};  // No restriction for subfilter? Give up.
+        }
+        if (!restriction) {
+            restriction = current;  // First restriction? Take it.
+        } else {
+            // Otherwise keep only the common prefix.
+            auto mismatch = std::mismatch(restriction->begin(),
+                                          restriction->end(), current->begin(),
+                                          current->end());
+            restriction->erase(mismatch.first, restriction->end());
+            if (restriction->empty()) {
+                return {};
+            }
+        }
+    }
+    return restriction;
+}
+
 std::optional<int32_t> OringFilter::greatestLowerBoundFor(
     const std::string &column_name,
     std::chrono::seconds timezone_offset) const {
@@ -107,6 +132,10 @@ std::optional<std::bitset<32>> OringFilter::valueSetLeastUpperBoundFor(
     return result;
 }
 
+void OringFilter::compile(FilterProgram &program) const {
+    program.emitAnyOf(_subfilters);
+}
+
 std::unique_ptr<Filter> OringFilter::copy() const {
     return make(kind(), disjuncts());
 }
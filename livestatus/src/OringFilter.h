@@ -21,6 +21,7 @@
 #include "Filter.h"
 #include "contact_fwd.h"
 class Column;
+class FilterProgram;
 class Row;
 
 class OringFilter : public Filter {
@@ -34,6 +35,8 @@ public:
         std::function<bool(const Column &)> predicate) const override;
     [[nodiscard]] std::optional<std::string> stringValueRestrictionFor(
         const std::string &column_name) const override;
+    [[nodiscard]] std::optional<std::string> stringPrefixRestrictionFor(
+        const std::string &column_name) const override;
     [[nodiscard]] std::optional<int32_t> greatestLowerBoundFor(
         const std::string &column_name,
         std::chrono::seconds timezone_offset) const override;
@@ -43,6 +46,7 @@ public:
     [[nodiscard]] std::optional<std::bitset<32>> valueSetLeastUpperBoundFor(
         const std::string &column_name,
         std::chrono::seconds timezone_offset) const override;
+    void compile(FilterProgram &program) const override;
     [[nodiscard]] std::unique_ptr<Filter> copy() const override;
     [[nodiscard]] std::unique_ptr<Filter> negate() const override;
     [[nodiscard]] bool is_tautology() const override;
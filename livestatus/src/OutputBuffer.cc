@@ -7,10 +7,14 @@
 
 #include <unistd.h>
 
+#include <algorithm>
 #include <cerrno>
+#include <climits>
 #include <chrono>
 #include <cstddef>
 #include <iomanip>
+#include <limits>
+#include <sstream>
 
 #include "Logger.h"
 #include "Poller.h"
@@ -21,53 +25,98 @@ OutputBuffer::OutputBuffer(int fd, const bool &termination_flag, Logger *logger)
     : _fd(fd)
     , _termination_flag(termination_flag)
     , _logger(logger)
+    , _stream_buffer(*this)
+    , _os(&_stream_buffer)
     // TODO(sp) This is really the wrong default because it hides some early
     // errors, e.g. an unknown command. But we can't change this easily because
     // of legacy reasons... :-/
     , _response_header(ResponseHeader::off)
-    , _response_code(ResponseCode::ok) {}
+    , _response_code(ResponseCode::ok)
+    , _chunk_timeout(default_chunk_timeout)
+    , _write_failed(false) {}
 
 OutputBuffer::~OutputBuffer() { flush(); }
 
 void OutputBuffer::flush() {
-    if (_response_header == ResponseHeader::fixed16) {
-        if (_response_code != ResponseCode::ok) {
-            _os.clear();
-            _os.str("");
-            _os << _error_message;
-        }
-        auto code = static_cast<unsigned>(_response_code);
-        size_t size = _os.tellp();
-        std::ostringstream header;
-        header << std::setw(3) << std::setfill('0') << code << " "  //
-               << std::setw(11) << std::setfill(' ') << size << "\n";
-        writeData(header);
+    switch (_response_header) {
+        case ResponseHeader::off:
+            writeData(_stream_buffer.data());
+            break;
+        case ResponseHeader::fixed16:
+            if (_response_code != ResponseCode::ok) {
+                writeHeader(_response_code, _error_message.size());
+                writeData(_error_message);
+            } else {
+                writeHeader(_response_code, _stream_buffer.data().size());
+                writeData(_stream_buffer.data());
+            }
+            break;
+        case ResponseHeader::chunked16:
+            if (_response_code != ResponseCode::ok) {
+                // Whatever has been streamed so far is incomplete, the client
+                // has to discard it.
+                writeHeader(_response_code, _error_message.size());
+                writeData(_error_message);
+            } else {
+                writeChunk();
+                writeHeader(ResponseCode::ok, 0);
+            }
+            break;
     }
-    writeData(_os);
 }
 
-void OutputBuffer::writeData(std::ostringstream &os) {
-    // TODO(sp) This cruel and slightly non-portable hack avoids copying, which
-    // is important. Note that UBSan rightly complains about it. We could do
-    // better with C++20 via os.view().data().
-    struct Hack : public std::stringbuf {
-        [[nodiscard]] const char *base() const { return pbase(); }
-    };
-    const char *buffer = static_cast<Hack *>(os.rdbuf())->base();
-    size_t bytes_to_write = os.tellp();
-    while (!shouldTerminate() && bytes_to_write > 0) {
+void OutputBuffer::writeChunk() {
+    auto data = _stream_buffer.data();
+    // After an error, the rest of the response is useless for the client.
+    if (!data.empty() && _response_code == ResponseCode::ok) {
+        auto deadline = std::chrono::steady_clock::now() + _chunk_timeout;
+        writeHeader(ResponseCode::ok, data.size(), deadline);
+        writeData(data, deadline);
+    }
+    _stream_buffer.consume();
+}
+
+void OutputBuffer::writeHeader(
+    ResponseCode code, size_t size,
+    std::optional<std::chrono::steady_clock::time_point> deadline) {
+    std::ostringstream header;
+    header << std::setw(3) << std::setfill('0') << static_cast<unsigned>(code)
+           << " "  //
+           << std::setw(11) << std::setfill(' ') << size << "\n";
+    writeData(header.str(), deadline);
+}
+
+void OutputBuffer::writeData(
+    std::string_view data,
+    std::optional<std::chrono::steady_clock::time_point> deadline) {
+    const char *buffer = data.data();
+    size_t bytes_to_write = data.size();
+    while (!shouldTerminate() && !_write_failed && bytes_to_write > 0) {
         if (!Poller{}.wait(100ms, _fd, PollEvents::out, _logger)) {
-            if (errno == ETIMEDOUT) {
-                continue;
+            if (errno != ETIMEDOUT) {
+                _write_failed = true;
+                break;
             }
-            break;
+            if (deadline && std::chrono::steady_clock::now() >= *deadline) {
+                Informational(_logger)
+                    << "client did not accept data for "
+                    << _chunk_timeout.count() << " ms, aborting query";
+                _write_failed = true;
+            }
+            continue;
         }
-        ssize_t bytes_written = write(_fd, buffer, bytes_to_write);
+        // A writable socket or pipe accepts at least PIPE_BUF bytes without
+        // blocking, larger writes could block without any deadline.
+        ssize_t bytes_written =
+            write(_fd, buffer,
+                  deadline ? std::min<size_t>(bytes_to_write, PIPE_BUF)
+                           : bytes_to_write);
         if (bytes_written == -1) {
             generic_error ge("could not write " +
                              std::to_string(bytes_to_write) +
                              " bytes to client socket");
             Informational(_logger) << ge;
+            _write_failed = true;
             break;
         }
         buffer += bytes_written;
@@ -85,3 +134,56 @@ void OutputBuffer::setError(ResponseCode code, const std::string &message) {
 }
 
 std::string OutputBuffer::getError() const { return _error_message; }
+
+OutputBuffer::StreamBuffer::StreamBuffer(OutputBuffer &output)
+    : _output(output), _consumed(0) {}
+
+std::string_view OutputBuffer::StreamBuffer::data() const {
+    return {pbase(), static_cast<size_t>(pptr() - pbase())};
+}
+
+size_t OutputBuffer::StreamBuffer::totalSize() const {
+    return _consumed + data().size();
+}
+
+void OutputBuffer::StreamBuffer::consume() {
+    _consumed += data().size();
+    setp(_buffer.data(), _buffer.data() + _buffer.size());
+}
+
+void OutputBuffer::StreamBuffer::grow() {
+    size_t used = data().size();
+    _buffer.resize(std::max<size_t>(4096, 2 * _buffer.size()));
+    setp(_buffer.data(), _buffer.data() + _buffer.size());
+    // pbump() takes an int, so we might need several steps.
+    while (used > 0) {
+        auto step = std::min<size_t>(used, std::numeric_limits<int>::max());
+        pbump(static_cast<int>(step));
+        used -= step;
+    }
+}
+
+OutputBuffer::StreamBuffer::int_type OutputBuffer::StreamBuffer::overflow(
+    int_type ch) {
+    if (_output.streaming() && data().size() >= chunk_size) {
+        _output.writeChunk();
+    } else {
+        grow();
+    }
+    if (traits_type::eq_int_type(ch, traits_type::eof())) {
+        return traits_type::not_eof(ch);
+    }
+    *pptr() = traits_type::to_char_type(ch);
+    pbump(1);
+    return ch;
+}
+
+OutputBuffer::StreamBuffer::pos_type OutputBuffer::StreamBuffer::seekoff(
+    off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) {
+    // We only support tellp().
+    if (off != 0 || dir != std::ios_base::cur ||
+        (which & std::ios_base::out) == 0) {
+        return pos_type(off_type(-1));
+    }
+    return pos_type(static_cast<off_type>(totalSize()));
+}
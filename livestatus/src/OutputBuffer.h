@@ -8,8 +8,14 @@
 
 #include "config.h"  // IWYU pragma: keep
 
-#include <sstream>
+#include <chrono>
+#include <cstddef>
+#include <optional>
+#include <ostream>
+#include <streambuf>
 #include <string>
+#include <string_view>
+#include <vector>
 class Logger;
 
 class OutputBuffer {
@@ -24,17 +30,49 @@ public:
         invalid_request = 452,
     };
 
-    enum class ResponseHeader { off, fixed16 };
+    // off:       no header at all, errors are not reported
+    // fixed16:   a single 16 byte header "<code> <size>\n" followed by the
+    //            complete response, which has to be buffered for that
+    // chunked16: the response is streamed as a sequence of chunks, each with
+    //            a fixed16 header. The stream is terminated by an empty chunk
+    //            with code 200 or by a chunk with an error code and an error
+    //            message, so errors happening mid-stream can still be reported.
+    enum class ResponseHeader { off, fixed16, chunked16 };
+
+    // Size of the chunks written while streaming.
+    static constexpr size_t chunk_size = 64 * 1024;
+
+    // While streaming, chunks are written in the middle of a query, often
+    // with locks held, e.g. on a logfile. A client not accepting a chunk within
+    // this time must not stall everybody else, so the query fails instead.
+    static constexpr std::chrono::milliseconds default_chunk_timeout{10000};
 
     OutputBuffer(int fd, const bool &termination_flag, Logger *logger);
+    OutputBuffer(const OutputBuffer &) = delete;
+    OutputBuffer &operator=(const OutputBuffer &) = delete;
+    OutputBuffer(OutputBuffer &&) = delete;
+    OutputBuffer &operator=(OutputBuffer &&) = delete;
     ~OutputBuffer();
 
     bool shouldTerminate() const { return _termination_flag; }
 
     std::ostream &os() { return _os; }
-    std::string str() const { return _os.str(); }
+    // The part of the response which has not been written to the client yet,
+    // i.e. the whole response unless we are streaming.
+    std::string str() const { return std::string{_stream_buffer.data()}; }
 
     void setResponseHeader(ResponseHeader r) { _response_header = r; }
+    // Large responses are written to the client while they are produced.
+    [[nodiscard]] bool streaming() const {
+        return _response_header == ResponseHeader::chunked16;
+    }
+    void setChunkTimeout(std::chrono::milliseconds timeout) {
+        _chunk_timeout = timeout;
+    }
+
+    // The client could not be written to, the rest of the query is useless
+    // and the connection must not be kept alive.
+    [[nodiscard]] bool writeFailed() const { return _write_failed; }
 
     void setError(ResponseCode code, const std::string &message);
     std::string getError() const;
@@ -42,16 +80,49 @@ public:
     Logger *getLogger() const { return _logger; }
 
 private:
+    // Our own buffer instead of a std::stringbuf: It gives us access to the
+    // data without copying, and when streaming it hands out full chunks to the
+    // socket instead of growing. tellp() still reports the total number of
+    // bytes of the response.
+    class StreamBuffer : public std::streambuf {
+    public:
+        explicit StreamBuffer(OutputBuffer &output);
+        [[nodiscard]] std::string_view data() const;
+        [[nodiscard]] size_t totalSize() const;
+        void consume();
+
+    protected:
+        int_type overflow(int_type ch) override;
+        pos_type seekoff(off_type off, std::ios_base::seekdir dir,
+                         std::ios_base::openmode which) override;
+
+    private:
+        OutputBuffer &_output;
+        std::vector<char> _buffer;
+        size_t _consumed;
+
+        void grow();
+    };
+
     const int _fd;
     const bool &_termination_flag;
     Logger *const _logger;
-    std::ostringstream _os;
+    StreamBuffer _stream_buffer;
+    std::ostream _os;
     ResponseHeader _response_header;
     ResponseCode _response_code;
     std::string _error_message;
+    std::chrono::milliseconds _chunk_timeout;
+    bool _write_failed;
 
     void flush();
-    void writeData(std::ostringstream &os);
+    void writeChunk();
+    void writeHeader(
+        ResponseCode code, size_t size,
+        std::optional<std::chrono::steady_clock::time_point> deadline = {});
+    void writeData(
+        std::string_view data,
+        std::optional<std::chrono::steady_clock::time_point> deadline = {});
 };
 
 #endif  // OutputBuffer_h
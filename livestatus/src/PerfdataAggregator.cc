@@ -5,11 +5,14 @@
 
 #include "PerfdataAggregator.h"
 
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cerrno>
 #include <cmath>
+#include <cstdlib>
 #include <functional>
-#include <iterator>
-#include <sstream>
-#include <stdexcept>
+#include <limits>
 #include <utility>
 
 #include "Renderer.h"
@@ -19,24 +22,58 @@
 
 void PerfdataAggregator::consume(Row row, const contact * /* auth_user */,
                                  std::chrono::seconds /* timezone_offset */) {
-    std::istringstream iss(_column->getValue(row));
-    std::istream_iterator<std::string> end;
-    for (auto it = std::istream_iterator<std::string>(iss); it != end; ++it) {
-        auto pos = it->find('=');
-        if (pos != std::string::npos) {
-            try {
-                auto varname = it->substr(0, pos);
-                auto value = std::stod(it->substr(pos + 1));
-                _aggregations.insert(std::make_pair(varname, _factory()))
-                    .first->second->update(value);
-            } catch (const std::logic_error &e) {
-            }
+    std::string buffer;
+    auto perf_data = _column->getView(row, buffer);
+    // Split at whitespace like an istream would, but without copying.
+    auto is_space = [](char ch) {
+        return std::isspace(static_cast<unsigned char>(ch)) != 0;
+    };
+    const auto *it = perf_data.begin();
+    while (it != perf_data.end()) {
+        it = std::find_if_not(it, perf_data.end(), is_space);
+        const auto *end = std::find_if(it, perf_data.end(), is_space);
+        std::string_view token{it, static_cast<size_t>(end - it)};
+        auto pos = token.find('=');
+        if (pos != std::string_view::npos) {
+            consumeVariable(token.substr(0, pos), token.substr(pos + 1));
+        }
+        it = end;
+    }
+}
+
+void PerfdataAggregator::consumeVariable(std::string_view varname,
+                                         std::string_view value) {
+    // The numeric part is short, so the copy is cheap and usually doesn't
+    // allocate. The semantics are the same as with std::stod.
+    std::string number{value};
+    char *end = nullptr;
+    errno = 0;
+    double d = std::strtod(number.c_str(), &end);
+    if (end == number.c_str() || errno == ERANGE) {
+        return;
+    }
+    auto agg = _aggregations.find(varname);
+    if (agg == _aggregations.end()) {
+        agg = _aggregations.emplace(std::string{varname}, _factory()).first;
+    }
+    agg->second->update(d);
+}
+
+void PerfdataAggregator::merge(const Aggregator &other) {
+    for (const auto &[varname, aggregation] :
+         static_cast<const PerfdataAggregator &>(other)._aggregations) {
+        auto agg = _aggregations.find(varname);
+        if (agg == _aggregations.end()) {
+            agg = _aggregations.emplace(varname, _factory()).first;
         }
+        agg->second->merge(*aggregation);
     }
 }
 
 void PerfdataAggregator::output(RowRenderer &r) const {
     std::string perf_data;
+    // Values are finite, so this is plenty for "%f"-style formatting.
+    char buf[std::numeric_limits<double>::max_exponent10 + 16];
     bool first = true;
     for (const auto &entry : _aggregations) {
         double value = entry.second->value();
@@ -46,7 +83,9 @@ void PerfdataAggregator::output(RowRenderer &r) const {
             } else {
                 perf_data += " ";
             }
-            perf_data += entry.first + "=" + std::to_string(value);
+            auto res = std::to_chars(buf, buf + sizeof(buf), value,
+                                     std::chars_format::fixed, 6);
+            perf_data.append(entry.first).append(1, '=').append(buf, res.ptr);
         }
     }
     r.output(perf_data);
@@ -9,9 +9,11 @@
 #include "config.h"  // IWYU pragma: keep
 
 #include <chrono>
+#include <functional>
 #include <map>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <utility>
 
 #include "Aggregator.h"
@@ -27,12 +29,16 @@ public:
         : _factory(std::move(factory)), _column(column) {}
     void consume(Row row, const contact *auth_user,
                  std::chrono::seconds timezone_offset) override;
+    void merge(const Aggregator &other) override;
     void output(RowRenderer &r) const override;
 
 private:
     AggregationFactory _factory;
     const StringColumn *const _column;
-    std::map<std::string, std::unique_ptr<Aggregation>> _aggregations;
+    std::map<std::string, std::unique_ptr<Aggregation>, std::less<>>
+        _aggregations;
+
+    void consumeVariable(std::string_view varname, std::string_view value);
 };
 
 #endif  // PerfdataAggregator_h
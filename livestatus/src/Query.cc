@@ -29,6 +29,7 @@
 #include "StatsColumn.h"
 #include "StringUtils.h"
 #include "Table.h"
+#include "ThreadPool.h"
 #include "Triggers.h"
 #include "auth.h"
 #include "opids.h"
@@ -85,6 +86,7 @@ Query::Query(const std::list<std::string> &lines, Table &table,
     , _time_limit_timeout(0)
     , _current_line(0)
     , _timezone_offset(0)
+    , _max_staleness(0)
     , _logger(logger) {
     FilterStack filters;
     FilterStack wait_conditions;
@@ -162,6 +164,8 @@ Query::Query(const std::list<std::string> &lines, Table &table,
                 parseWaitTimeoutLine(arguments);
             } else if (header == "Localtime") {
                 parseLocaltimeLine(arguments);
+            } else if (header == "MaxStaleness") {
+                parseMaxStalenessLine(arguments);
             } else {
                 throw std::runtime_error("undefined request header");
             }
@@ -181,6 +185,7 @@ Query::Query(const std::list<std::string> &lines, Table &table,
     }
 
     _filter = AndingFilter::make(Filter::Kind::row, filters);
+    _filter_program = FilterProgram{*_filter};
     _wait_condition =
         AndingFilter::make(Filter::Kind ::wait_condition, wait_conditions);
 }
@@ -263,6 +268,9 @@ namespace {
 class SumAggregation : public Aggregation {
 public:
     void update(double value) override { sum_ += value; }
+    void merge(const Aggregation &other) override {
+        sum_ += static_cast<const SumAggregation &>(other).sum_;
+    }
     [[nodiscard]] double value() const override { return sum_; }
 
 private:
@@ -279,6 +287,13 @@ public:
         first_ = false;
     }
 
+    void merge(const Aggregation &other) override {
+        const auto &o = static_cast<const MinAggregation &>(other);
+        if (!o.first_) {
+            update(o.sum_);
+        }
+    }
+
     [[nodiscard]] double value() const override { return sum_; }
 
 private:
@@ -298,6 +313,13 @@ public:
         first_ = false;
     }
 
+    void merge(const Aggregation &other) override {
+        const auto &o = static_cast<const MaxAggregation &>(other);
+        if (!o.first_) {
+            update(o.sum_);
+        }
+    }
+
     [[nodiscard]] double value() const override { return sum_; }
 
 private:
@@ -315,6 +337,12 @@ public:
         sum_ += value;
     }
 
+    void merge(const Aggregation &other) override {
+        const auto &o = static_cast<const AvgAggregation &>(other);
+        count_ += o.count_;
+        sum_ += o.sum_;
+    }
+
     [[nodiscard]] double value() const override { return sum_ / count_; }
 
 private:
@@ -331,6 +359,13 @@ public:
         sum_of_squares_ += value * value;
     }
 
+    void merge(const Aggregation &other) override {
+        const auto &o = static_cast<const StdAggregation &>(other);
+        count_ += o.count_;
+        sum_ += o.sum_;
+        sum_of_squares_ += o.sum_of_squares_;
+    }
+
     [[nodiscard]] double value() const override {
         auto mean = sum_ / count_;
         return sqrt(sum_of_squares_ / count_ - mean * mean);
@@ -346,6 +381,9 @@ private:
 class SumInvAggregation : public Aggregation {
 public:
     void update(double value) override { sum_ += 1.0 / value; }
+    void merge(const Aggregation &other) override {
+        sum_ += static_cast<const SumInvAggregation &>(other).sum_;
+    }
     [[nodiscard]] double value() const override { return sum_; }
 
 private:
@@ -360,6 +398,12 @@ public:
         sum_ += 1.0 / value;
     }
 
+    void merge(const Aggregation &other) override {
+        const auto &o = static_cast<const AvgInvAggregation &>(other);
+        count_ += o.count_;
+        sum_ += o.sum_;
+    }
+
     [[nodiscard]] double value() const override { return sum_ / count_; }
 
 private:
@@ -468,6 +512,7 @@ void Query::parseSeparatorsLine(char *line) {
 
 namespace {
 std::map<std::string, OutputFormat> formats{{"CSV", OutputFormat::csv},
+                                            {"binary", OutputFormat::binary},
                                             {"csv", OutputFormat::broken_csv},
                                             {"json", OutputFormat::json},
                                             {"python", OutputFormat::python},
@@ -520,8 +565,10 @@ void Query::parseResponseHeaderLine(char *line) {
         _output.setResponseHeader(OutputBuffer::ResponseHeader::off);
     } else if (value == "fixed16") {
         _output.setResponseHeader(OutputBuffer::ResponseHeader::fixed16);
+    } else if (value == "chunked16") {
+        _output.setResponseHeader(OutputBuffer::ResponseHeader::chunked16);
     } else {
-        throw std::runtime_error("expected 'off' or 'fixed16'");
+        throw std::runtime_error("expected 'off', 'fixed16' or 'chunked16'");
     }
 }
 
@@ -552,6 +599,11 @@ void Query::parseWaitObjectLine(char *line) {
     }
 }
 
+void Query::parseMaxStalenessLine(char *line) {
+    _max_staleness =
+        std::chrono::seconds(nextNonNegativeIntegerArgument(&line));
+}
+
 void Query::parseLocaltimeLine(char *line) {
     auto value = nextNonNegativeIntegerArgument(&line);
     // Compute offset to be *added* each time we output our time and
@@ -607,17 +659,25 @@ bool Query::process() {
 
 void Query::start(QueryRenderer &q) {
     if (_columns.empty()) {
-        getAggregatorsFor({});
+        findStatsGroup(Row{nullptr}, _stats_grouping);
     }
     if (_show_column_headers) {
-        RowRenderer r(q);
+        std::vector<std::string> names;
+        names.reserve(_columns.size() + _stats_columns.size());
         for (const auto &column : _columns) {
-            r.output(column->name());
+            names.push_back(column->name());
         }
 
         // Output dummy headers for stats columns
         for (size_t col = 1; col <= _stats_columns.size(); ++col) {
-            r.output("stats_" + std::to_string(col));
+            names.push_back("stats_" + std::to_string(col));
+        }
+
+        if (!q.renderer().outputColumnHeaders(names)) {
+            RowRenderer r(q);
+            for (const auto &name : names) {
+                r.output(name);
+            }
         }
     }
 }
@@ -633,7 +693,10 @@ bool Query::timelimitReached() const {
     return false;
 }
 
-bool Query::processDataset(Row row) {
+bool Query::checkResponseLimits() const {
+    if (_output.writeFailed()) {
+        return false;  // The client is gone or stalled, so just stop.
+    }
     if (_output.shouldTerminate()) {
         // Not the perfect response code, but good enough...
         _output.setError(OutputBuffer::ResponseCode::limit_exceeded,
@@ -641,16 +704,31 @@ bool Query::processDataset(Row row) {
         return false;
     }
 
-    if (static_cast<size_t>(_output.os().tellp()) > _max_response_size) {
+    auto buffered = _renderer_query == nullptr
+                        ? 0
+                        : _renderer_query->renderer().bufferedSize();
+    if (static_cast<size_t>(_output.os().tellp()) + buffered >
+        _max_response_size) {
         _output.setError(OutputBuffer::ResponseCode::limit_exceeded,
                          "Maximum response size of " +
                              std::to_string(_max_response_size) +
                              " bytes exceeded!");
         return false;
     }
+    return true;
+}
+
+bool Query::accepts(Row row) const {
+    return _filter_program.accepts(row, _auth_user, _timezone_offset) &&
+           (_auth_user == nullptr || _table.isAuthorized(row, _auth_user));
+}
+
+bool Query::processDataset(Row row) {
+    if (!checkResponseLimits()) {
+        return false;
+    }
 
-    if (_filter->accepts(row, _auth_user, _timezone_offset) &&
-        (_auth_user == nullptr || _table.isAuthorized(row, _auth_user))) {
+    if (accepts(row)) {
         _current_line++;
         if (_limit >= 0 && static_cast<int>(_current_line) > _limit) {
             return false;
@@ -663,25 +741,8 @@ bool Query::processDataset(Row row) {
         }
 
         if (doStats()) {
-            // Things get a bit tricky here: For stats queries, we have to
-            // combine rows with the same values in the non-stats columns. But
-            // when we finally output those non-stats columns in finish(), we
-            // don't have the row anymore, so we can't use Column::output()
-            // then.  :-/ The slightly hacky workaround is to pre-render all
-            // non-stats columns into a single string here (RowFragment) and
-            // output it later in a verbatim manner.
-            std::ostringstream os;
-            {
-                auto renderer =
-                    Renderer::make(_output_format, os, _output.getLogger(),
-                                   _separators, _data_encoding);
-                QueryRenderer q(*renderer, EmitBeginEnd::off);
-                RowRenderer r(q);
-                for (const auto &column : _columns) {
-                    column->output(row, r, _auth_user, _timezone_offset);
-                }
-            }
-            for (const auto &aggr : getAggregatorsFor(RowFragment{os.str()})) {
+            for (const auto &aggr :
+                 findStatsGroup(row, _stats_grouping).aggregators) {
                 aggr->consume(row, _auth_user, timezoneOffset());
             }
         } else {
@@ -695,14 +756,140 @@ bool Query::processDataset(Row row) {
     return true;
 }
 
+void Query::processDatasets(const std::vector<Row> &rows, ThreadPool *pool) {
+    // Splitting up small tables is not worth the trouble. For stats queries
+    // with a limit, the rows consumed by the aggregators depend on the order.
+    constexpr size_t min_rows_per_chunk = 1000;
+    size_t num_chunks = pool == nullptr || (doStats() && _limit >= 0)
+                            ? 1
+                            : std::min(pool->size() + 1,
+                                       rows.size() / min_rows_per_chunk);
+    if (num_chunks < 2) {
+        for (auto row : rows) {
+            if (!processDataset(row)) {
+                break;
+            }
+        }
+        return;
+    }
+
+    Debug(_logger) << "scanning " << rows.size() << " rows in " << num_chunks
+                   << " parallel chunks";
+    std::vector<ScanResult> results(num_chunks);
+    // The rendered rows of all chunks share a single budget, so they don't
+    // keep more than the maximum response size in memory.
+    std::atomic<size_t> buffered{0};
+    pool->run(num_chunks, [&](size_t i) {
+        scan(rows, i * rows.size() / num_chunks,
+             (i + 1) * rows.size() / num_chunks, buffered, results[i]);
+    });
+    for (auto &result : results) {
+        if (!merge(rows, result)) {
+            break;
+        }
+    }
+}
+
+// Runs on a worker thread, so we must not touch any non-const state here,
+// only the given result.
+void Query::scan(const std::vector<Row> &rows, size_t begin, size_t end,
+                 std::atomic<size_t> &buffered, ScanResult &result) const {
+    result.resume = end;
+    result.end = end;
+    std::ostringstream os;
+    std::unique_ptr<Renderer> renderer;
+    if (!doStats()) {
+        renderer = Renderer::make(_output_format, os, _output.getLogger(),
+                                  _separators, _data_encoding);
+    }
+    for (auto i = begin; i < end; ++i) {
+        if (_output.shouldTerminate()) {
+            break;
+        }
+        if (_time_limit >= 0 && time(nullptr) >= _time_limit_timeout) {
+            result.timed_out = true;
+            break;
+        }
+        Row row = rows[i];
+        if (!accepts(row)) {
+            continue;
+        }
+        result.accepted++;
+        if (doStats()) {
+            for (const auto &aggr :
+                 findStatsGroup(row, result.stats).aggregators) {
+                aggr->consume(row, _auth_user, timezoneOffset());
+            }
+            continue;
+        }
+        os.str("");
+        {
+            QueryRenderer q(*renderer, EmitBeginEnd::off);
+            RowRenderer r(q);
+            for (const auto &column : _columns) {
+                column->output(row, r, _auth_user, _timezone_offset);
+            }
+        }
+        result.rows.push_back(os.str());
+        auto size = result.rows.back().size();
+        if (buffered.fetch_add(size) + size > _max_response_size) {
+            // Whether the response really gets too large depends on the rows
+            // before this chunk, so the merge has to find out.
+            result.resume = i + 1;
+            break;
+        }
+        // The merged response will be cut off anyway, so we can stop early.
+        if (_limit >= 0 && result.accepted >= static_cast<unsigned>(_limit)) {
+            break;
+        }
+    }
+}
+
+// Runs on the query's thread, adding the result of a scan to the response in
+// the order of the rows.
+bool Query::merge(const std::vector<Row> &rows, ScanResult &result) {
+    if (doStats()) {
+        _current_line += result.accepted;
+        for (const auto &group : result.stats.groups) {
+            if (auto *existing = _stats_grouping.groups.find(group->key)) {
+                for (size_t i = 0; i < existing->aggregators.size(); ++i) {
+                    existing->aggregators[i]->merge(*group->aggregators[i]);
+                }
+            } else {
+                _stats_grouping.groups.insert(group->key,
+                                              std::move(group->fragment),
+                                              std::move(group->aggregators));
+            }
+        }
+    } else {
+        for (auto &fragment : result.rows) {
+            if (!checkResponseLimits()) {
+                return false;
+            }
+            _current_line++;
+            if (_limit >= 0 && static_cast<int>(_current_line) > _limit) {
+                return false;
+            }
+            RowRenderer r(*_renderer_query);
+            r.output(RowFragment{std::move(fragment)});
+        }
+        for (auto i = result.resume; i < result.end; ++i) {
+            if (!processDataset(rows[i])) {
+                return false;
+            }
+        }
+    }
+    return !(result.timed_out && timelimitReached());
+}
+
 void Query::finish(QueryRenderer &q) {
     if (doStats()) {
-        for (const auto &group : _stats_groups) {
+        for (const auto *group : _stats_grouping.groups.sorted()) {
             RowRenderer r(q);
-            if (!group.first._str.empty()) {
-                r.output(group.first);
+            if (!group->fragment._str.empty()) {
+                r.output(group->fragment);
             }
-            for (const auto &aggr : group.second) {
+            for (const auto &aggr : group->aggregators) {
                 aggr->output(r);
             }
         }
@@ -730,6 +917,19 @@ std::optional<std::string> Query::stringValueRestrictionFor(
     return result;
 }
 
+std::optional<std::string> Query::stringPrefixRestrictionFor(
+    const std::string &column_name) const {
+    auto result = _filter->stringPrefixRestrictionFor(column_name);
+    if (result) {
+        Debug(_logger) << "column " << _table.name() << "." << column_name
+                       << " is restricted to prefix '" << *result << "'";
+    } else {
+        Debug(_logger) << "column " << _table.name() << "." << column_name
+                       << " has no prefix restriction";
+    }
+    return result;
+}
+
 std::optional<int32_t> Query::greatestLowerBoundFor(
     const std::string &column_name) const {
     auto result = _filter->greatestLowerBoundFor(column_name, timezoneOffset());
@@ -777,19 +977,66 @@ std::optional<std::bitset<32>> Query::valueSetLeastUpperBoundFor(
     return result;
 }
 
-const std::vector<std::unique_ptr<Aggregator>> &Query::getAggregatorsFor(
-    const RowFragment &groupspec) {
-    auto it = _stats_groups.find(groupspec);
-    if (it == _stats_groups.end()) {
-        std::vector<std::unique_ptr<Aggregator>> aggrs;
-        for (const auto &sc : _stats_columns) {
-            aggrs.push_back(sc->createAggregator(_logger));
+// For stats queries, we have to combine rows with the same values in the
+// non-stats columns. Most columns can provide a binary key for their value,
+// only the remaining ones are rendered. The output of the non-stats columns is
+// needed in finish(), when we don't have the rows anymore, so we render them
+// into a RowFragment once per group and output it later in a verbatim manner.
+StatsGroups::Group &Query::findStatsGroup(Row row,
+                                          StatsGrouping &grouping) const {
+    grouping.key.clear();
+    for (const auto &column : _columns) {
+        if (!column->appendGroupKey(row, grouping.key, _auth_user,
+                                    _timezone_offset)) {
+            appendRenderedGroupKey(*column, row, grouping);
         }
-        it = _stats_groups.emplace(groupspec, move(aggrs)).first;
     }
-    return it->second;
+    if (auto *group = grouping.groups.find(grouping.key)) {
+        return *group;
+    }
+    std::vector<std::unique_ptr<Aggregator>> aggrs;
+    for (const auto &sc : _stats_columns) {
+        aggrs.push_back(sc->createAggregator(_logger));
+    }
+    return grouping.groups.insert(grouping.key, renderGroupColumns(row),
+                                  std::move(aggrs));
 }
 
+void Query::appendRenderedGroupKey(const Column &column, Row row,
+                                   StatsGrouping &grouping) const {
+    if (!grouping.renderer) {
+        grouping.renderer =
+            Renderer::make(_output_format, grouping.os, _output.getLogger(),
+                           _separators, _data_encoding);
+    }
+    grouping.os.str("");
+    {
+        QueryRenderer q(*grouping.renderer, EmitBeginEnd::off);
+        RowRenderer r(q);
+        column.output(row, r, _auth_user, _timezone_offset);
+    }
+    auto rendered = grouping.os.str();
+    auto size = rendered.size();
+    grouping.key.append(reinterpret_cast<const char *>(&size), sizeof(size));
+    grouping.key.append(rendered);
+}
+
+RowFragment Query::renderGroupColumns(Row row) const {
+    std::ostringstream os;
+    {
+        auto renderer = Renderer::make(_output_format, os, _output.getLogger(),
+                                       _separators, _data_encoding);
+        QueryRenderer q(*renderer, EmitBeginEnd::off);
+        RowRenderer r(q);
+        for (const auto &column : _columns) {
+            column->output(row, r, _auth_user, _timezone_offset);
+        }
+    }
+    return RowFragment{os.str()};
+}
+
+bool Query::cacheable() const { return _wait_condition->is_tautology(); }
+
 void Query::doWait() {
     _table.core()->triggers().wait_for(_wait_trigger, _wait_timeout, [this] {
         return _wait_condition->accepts(_wait_object, _auth_user,
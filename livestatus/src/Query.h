@@ -10,25 +10,29 @@
 // an IWYU bug?
 #include "config.h"  // IWYU pragma: keep
 
+#include <atomic>
 #include <bitset>
+#include <cstddef>
 #include <chrono>
 #include <cstdint>
 #include <ctime>
 #include <functional>
 #include <list>
-#include <map>
 #include <memory>
 #include <optional>
+#include <sstream>
 #include <string>
 #include <unordered_set>
 #include <vector>
 
 #include "Aggregator.h"  // IWYU pragma: keep
 #include "Filter.h"
+#include "FilterProgram.h"
 #include "Renderer.h"
 #include "RendererBrokenCSV.h"
 #include "Row.h"
 #include "StatsColumn.h"
+#include "StatsGroups.h"
 #include "Triggers.h"
 #include "contact_fwd.h"
 #include "data_encoding.h"
@@ -36,6 +40,7 @@ class Column;
 class Logger;
 class OutputBuffer;
 class Table;
+class ThreadPool;
 
 class Query {
 public:
@@ -45,10 +50,22 @@ public:
 
     bool process();
 
+    [[nodiscard]] bool keepalive() const { return _keepalive; }
+    // Requests waiting for something can't be answered from the QueryCache.
+    [[nodiscard]] bool cacheable() const;
+    [[nodiscard]] std::chrono::seconds maxStaleness() const {
+        return _max_staleness;
+    }
+
     // NOTE: We cannot make this 'const' right now, it increments _current_line
-    // and calls the non-const getAggregatorsFor() member function.
+    // and adds groups to _stats_grouping.
     bool processDataset(Row row);
 
+    // Has the same effect as calling processDataset() for all rows in turn,
+    // but spreads the work over the given pool if that's worthwhile. The pool
+    // may be null.
+    void processDatasets(const std::vector<Row> &rows, ThreadPool *pool);
+
     bool timelimitReached() const;
     void invalidRequest(const std::string &message) const;
 
@@ -60,6 +77,8 @@ public:
         std::function<bool(const Column &)> predicate) const;
     std::optional<std::string> stringValueRestrictionFor(
         const std::string &column_name) const;
+    std::optional<std::string> stringPrefixRestrictionFor(
+        const std::string &column_name) const;
     std::optional<int32_t> greatestLowerBoundFor(
         const std::string &column_name) const;
     std::optional<int32_t> leastUpperBoundFor(
@@ -83,6 +102,7 @@ private:
     bool _keepalive;
     using FilterStack = Filters;
     std::unique_ptr<Filter> _filter;
+    FilterProgram _filter_program;
     const contact *_auth_user;
     std::unique_ptr<Filter> _wait_condition;
     std::chrono::milliseconds _wait_timeout;
@@ -96,11 +116,20 @@ private:
     time_t _time_limit_timeout;
     unsigned _current_line;
     std::chrono::seconds _timezone_offset;
+    std::chrono::seconds _max_staleness;
     Logger *const _logger;
     std::vector<std::shared_ptr<Column>> _columns;
     std::vector<std::unique_ptr<StatsColumn>> _stats_columns;
-    std::map<RowFragment, std::vector<std::unique_ptr<Aggregator>>>
-        _stats_groups;
+    // The state needed for grouping rows in stats queries. Parallel scans use
+    // one per worker and merge them afterwards.
+    struct StatsGrouping {
+        StatsGroups groups;
+        // Scratch space for computing group keys, reused for all rows.
+        std::string key;
+        std::ostringstream os;
+        std::unique_ptr<Renderer> renderer;
+    };
+    StatsGrouping _stats_grouping;
     std::unordered_set<std::shared_ptr<Column>> _all_columns;
 
     bool doStats() const;
@@ -127,13 +156,31 @@ private:
     void parseWaitTriggerLine(char *line);
     void parseWaitObjectLine(char *line);
     void parseLocaltimeLine(char *line);
+    void parseMaxStalenessLine(char *line);
     void start(QueryRenderer &q);
     void finish(QueryRenderer &q);
 
-    // NOTE: We cannot make this 'const' right now, it adds entries into
-    // _stats_groups.
-    const std::vector<std::unique_ptr<Aggregator>> &getAggregatorsFor(
-        const RowFragment &groupspec);
+    StatsGroups::Group &findStatsGroup(Row row, StatsGrouping &grouping) const;
+    void appendRenderedGroupKey(const Column &column, Row row,
+                                StatsGrouping &grouping) const;
+    RowFragment renderGroupColumns(Row row) const;
+    bool checkResponseLimits() const;
+    bool accepts(Row row) const;
+
+    // The outcome of a parallel scan over some of the rows. When the rendered
+    // rows of all scans exceed the maximum response size, the scans stop and
+    // the rows from 'resume' up to 'end' are left for the merge.
+    struct ScanResult {
+        std::vector<std::string> rows;  // rendered rows, if no stats
+        StatsGrouping stats;
+        unsigned accepted{0};
+        bool timed_out{false};
+        size_t resume{0};
+        size_t end{0};
+    };
+    void scan(const std::vector<Row> &rows, size_t begin, size_t end,
+              std::atomic<size_t> &buffered, ScanResult &result) const;
+    bool merge(const std::vector<Row> &rows, ScanResult &result);
 };
 
 #endif  // Query_h
@@ -0,0 +1,113 @@
+// Copyright (C) 2019 tribe29 GmbH - License: GNU General Public License v2
+// This file is part of Checkmk (https://checkmk.com). It is subject to the
+// terms and conditions defined in the file COPYING, which is part of this
+// source code package.
+
+#include "QueryCache.h"
+
+#include <string>
+#include <utility>
+
+#include "StringUtils.h"
+
+// static
+std::string QueryCache::makeKey(const std::string &tablename,
+                                const std::list<std::string> &lines,
+                                std::chrono::seconds timezone_offset) {
+    std::string key = tablename;
+    key += '\n';
+    key += std::to_string(timezone_offset.count());
+    for (const auto &line : lines) {
+        auto stripped_line = mk::rstrip(line);
+        if (stripped_line.empty()) {
+            break;
+        }
+        auto header = stripped_line.substr(0, stripped_line.find(':'));
+        if (header == "KeepAlive" || header == "ResponseHeader" ||
+            header == "MaxStaleness" || header == "Localtime") {
+            continue;
+        }
+        key += '\n';
+        key += stripped_line;
+    }
+    return key;
+}
+
+std::shared_ptr<const std::string> QueryCache::answer(
+    const std::string &key, uint64_t generation,
+    std::chrono::seconds max_staleness, size_t max_bytes,
+    const Compute &compute) {
+    auto now = std::chrono::steady_clock::now();
+    {
+        std::unique_lock<std::mutex> ul(_mutex);
+        auto deadline = now + _max_wait;
+        while (true) {
+            auto it = _entries.find(key);
+            if (it == _entries.end()) {
+                break;
+            }
+            auto &entry = it->second;
+            if (!entry.response) {
+                if (_computed.wait_until(ul, deadline) ==
+                    std::cv_status::timeout) {
+                    ul.unlock();
+                    compute();
+                    return nullptr;
+                }
+                continue;
+            }
+            if (entry.generation == generation ||
+                now - entry.time < max_staleness) {
+                _lru.splice(_lru.begin(), _lru, entry.lru);
+                return entry.response;
+            }
+            erase(it);
+            break;
+        }
+        _entries.emplace(key, Entry{nullptr, generation, now, _lru.end()});
+    }
+    std::optional<std::string> response;
+    try {
+        response = compute();
+    } catch (...) {
+        finish(key, std::nullopt, max_bytes);
+        throw;
+    }
+    finish(key, std::move(response), max_bytes);
+    return nullptr;
+}
+
+size_t QueryCache::size() const {
+    std::lock_guard<std::mutex> lg(_mutex);
+    return _bytes;
+}
+
+void QueryCache::erase(std::unordered_map<std::string, Entry>::iterator it) {
+    if (it->second.response) {
+        _bytes -= it->second.response->size();
+        _lru.erase(it->second.lru);
+    }
+    _entries.erase(it);
+}
+
+void QueryCache::finish(const std::string &key,
+                        std::optional<std::string> response,
+                        size_t max_bytes) {
+    {
+        std::lock_guard<std::mutex> lg(_mutex);
+        auto it = _entries.find(key);
+        if (!response || response->size() > max_bytes) {
+            erase(it);
+        } else {
+            auto &entry = it->second;
+            _bytes += response->size();
+            entry.response =
+                std::make_shared<const std::string>(std::move(*response));
+            entry.lru = _lru.insert(_lru.begin(), key);
+            while (_bytes > max_bytes) {
+                erase(_entries.find(_lru.back()));
+            }
+        }
+    }
+    _computed.notify_all();
+}
@@ -0,0 +1,84 @@
+// Copyright (C) 2019 tribe29 GmbH - License: GNU General Public License v2
+// This file is part of Checkmk (https://checkmk.com). It is subject to the
+// terms and conditions defined in the file COPYING, which is part of this
+// source code package.
+
+#ifndef QueryCache_h
+#define QueryCache_h
+
+#include "config.h"  // IWYU pragma: keep
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+// Remembers the rendered responses of GET requests, so the same request
+// sent by lots of dashboards at once is answered only once. A response is
+// reused as long as the Triggers generation is unchanged, i.e. nothing has
+// happened in the core since it has been computed, or if it is younger than
+// the MaxStaleness the request allows. Values changing just by the passing of
+// time, like staleness, are not tracked by the generation, so the cache is
+// off unless a size is configured. Least recently used responses are evicted
+// when that size is exceeded.
+class QueryCache {
+public:
+    // Computes a response for the cache, returns nothing if the response
+    // should not be cached, e.g. because of an error.
+    using Compute = std::function<std::optional<std::string>()>;
+
+    // How long identical requests wait for a response being computed before
+    // computing it on their own, the computing request might be stuck on a
+    // slow client.
+    static constexpr std::chrono::milliseconds default_max_wait{5000};
+
+    explicit QueryCache(std::chrono::milliseconds max_wait = default_max_wait)
+        : _max_wait{max_wait} {}
+
+    // The table and the request lines without the ones only affecting the
+    // transport, in the order of the request, plus the effective timezone
+    // offset instead of the Localtime line. The AuthUser line is included.
+    static std::string makeKey(const std::string &tablename,
+                               const std::list<std::string> &lines,
+                               std::chrono::seconds timezone_offset);
+
+    // Returns the cached response for the key, if any. Otherwise calls compute
+    // and returns nullptr, keeping at most max_bytes of responses afterwards.
+    // Identical requests arriving while compute is running wait up to
+    // max_wait for its response instead of computing it again. If it takes
+    // longer, they compute their response without caching it.
+    std::shared_ptr<const std::string> answer(
+        const std::string &key, uint64_t generation,
+        std::chrono::seconds max_staleness, size_t max_bytes,
+        const Compute &compute);
+
+    [[nodiscard]] size_t size() const;
+
+private:
+    struct Entry {
+        std::shared_ptr<const std::string> response;  // null while computing
+        uint64_t generation;
+        std::chrono::steady_clock::time_point time;
+        std::list<std::string>::iterator lru;  // only when computed
+    };
+
+    const std::chrono::milliseconds _max_wait;
+    mutable std::mutex _mutex;
+    std::condition_variable _computed;
+    std::unordered_map<std::string, Entry> _entries;
+    std::list<std::string> _lru;  // most recently used first
+    size_t _bytes{0};
+
+    void erase(std::unordered_map<std::string, Entry>::iterator it);
+    void finish(const std::string &key, std::optional<std::string> response,
+                size_t max_bytes);
+};
+
+#endif  // QueryCache_h
@@ -8,11 +8,13 @@
 #include <rrd.h>
 
 #include <algorithm>
+#include <charconv>
 #include <cstdlib>
 #include <cstring>
 #include <ctime>
 #include <filesystem>
 #include <iterator>
+#include <limits>
 #include <ostream>
 #include <set>
 #include <type_traits>
@@ -51,19 +53,38 @@ void RRDColumn::output(Row row, RowRenderer &r, const contact * /* auth_user */,
     }
 }
 
+namespace {
+// Same result as std::to_string, i.e. "%f" for doubles, but without going
+// through vsnprintf and the C locale for every single data point.
+template <typename T>
+std::string formatNumber(T value) {
+    // enough for the integer digits of any double plus 6 decimals
+    char buf[std::numeric_limits<double>::max_exponent10 + 16];
+    std::to_chars_result res;
+    if constexpr (std::is_floating_point_v<T>) {
+        res = std::to_chars(buf, buf + sizeof(buf), value,
+                            std::chars_format::fixed, 6);
+    } else {
+        res = std::to_chars(buf, buf + sizeof(buf), value);
+    }
+    return std::string(buf, res.ptr);
+}
+}  // namespace
+
 std::vector<std::string> RRDColumn::getValue(
     Row row, const contact * /*auth_user*/,
     std::chrono::seconds timezone_offset) const {
     auto data = getData(row);
     std::vector<std::string> strings;
-    strings.push_back(std::to_string(
+    strings.reserve(3 + data.values.size());
+    strings.push_back(formatNumber(
         std::chrono::system_clock::to_time_t(data.start + timezone_offset)));
-    strings.push_back(std::to_string(
+    strings.push_back(formatNumber(
         std::chrono::system_clock::to_time_t(data.end + timezone_offset)));
-    strings.push_back(std::to_string(data.step));
+    strings.push_back(formatNumber(data.step));
     std::transform(data.values.begin(), data.values.end(),
                    std::back_inserter(strings),
-                   [](const auto &value) { return std::to_string(value); });
+                   [](const auto &value) { return formatNumber(value); });
     return strings;
 }
 
@@ -27,12 +27,14 @@ public:
         return str;
     }
 
-    bool match(const std::string &str) const {
-        return RE2::FullMatch(str, regex_);
+    bool match(std::string_view str) const {
+        return RE2::FullMatch(re2::StringPiece{str.data(), str.size()},
+                              regex_);
     }
 
-    bool search(const std::string &str) const {
-        return RE2::PartialMatch(str, regex_);
+    bool search(std::string_view str) const {
+        return RE2::PartialMatch(re2::StringPiece{str.data(), str.size()},
+                                 regex_);
     }
 
     static std::string engine() { return "RE2"; }
@@ -74,12 +76,12 @@ public:
                                   std::regex_constants::format_sed);
     }
 
-    [[nodiscard]] bool match(const std::string &str) const {
-        return regex_match(str, regex_);
+    [[nodiscard]] bool match(std::string_view str) const {
+        return regex_match(str.begin(), str.end(), regex_);
     }
 
-    [[nodiscard]] bool search(const std::string &str) const {
-        return regex_search(str, regex_);
+    [[nodiscard]] bool search(std::string_view str) const {
+        return regex_search(str.begin(), str.end(), regex_);
     }
 
     static std::string engine() { return "C++11"; }
@@ -107,9 +109,9 @@ std::string RegExp::replace(const std::string &str,
     return _impl->replace(str, replacement);
 }
 
-bool RegExp::match(const std::string &str) const { return _impl->match(str); }
+bool RegExp::match(std::string_view str) const { return _impl->match(str); }
 
-bool RegExp::search(const std::string &str) const { return _impl->search(str); }
+bool RegExp::search(std::string_view str) const { return _impl->search(str); }
 
 // static
 std::string RegExp::engine() { return Impl::engine(); }
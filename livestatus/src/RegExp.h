@@ -10,6 +10,7 @@
 
 #include <memory>
 #include <string>
+#include <string_view>
 
 class RegExp {
 public:
@@ -28,8 +29,8 @@ public:
 
     [[nodiscard]] std::string replace(const std::string &str,
                                       const std::string &replacement) const;
-    [[nodiscard]] bool match(const std::string &str) const;
-    [[nodiscard]] bool search(const std::string &str) const;
+    [[nodiscard]] bool match(std::string_view str) const;
+    [[nodiscard]] bool search(std::string_view str) const;
 
     static std::string engine();
 
@@ -5,13 +5,18 @@
 
 #include "Renderer.h"
 
+#include <bit>
+#include <charconv>
 #include <cmath>
 #include <ctime>
-#include <iomanip>
 #include <ostream>
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 #include "Logger.h"
-#include "OStreamStateSaver.h"
+#include "RendererBinary.h"
 #include "RendererBrokenCSV.h"
 #include "RendererCSV.h"
 #include "RendererJSON.h"
@@ -40,6 +45,8 @@ std::unique_ptr<Renderer> Renderer::make(OutputFormat format, std::ostream &os,
             return std::make_unique<RendererPython>(os, logger, data_encoding);
         case OutputFormat::python3:
             return std::make_unique<RendererPython3>(os, logger, data_encoding);
+        case OutputFormat::binary:
+            return std::make_unique<RendererBinary>(os, logger, data_encoding);
     }
     return nullptr;  // unreachable
 }
@@ -49,24 +56,63 @@ void Renderer::output(double value) {
     if (static_cast<bool>(std::isnan(value))) {
         output(Null());
     } else {
-        _os << value;
+        outputDouble(value);
     }
 }
 
+void Renderer::outputInteger(long long value) {
+    char buf[24];
+    auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), value);
+    _os.write(buf, end - buf);
+}
+
+void Renderer::outputUnsignedInteger(unsigned long long value) {
+    char buf[24];
+    auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), value);
+    _os.write(buf, end - buf);
+}
+
+void Renderer::outputDouble(double value) {
+    // Large enough for 17 significant digits, sign, point and exponent.
+    char buf[32];
+    auto [end, ec] =
+        roundTripDoubles()
+            ? std::to_chars(buf, buf + sizeof(buf), value)
+            : std::to_chars(buf, buf + sizeof(buf), value,
+                            std::chars_format::general, 6);
+    _os.write(buf, end - buf);
+}
+
 void Renderer::output(PlainChar value) { _os.put(value._ch); }
 
+namespace {
+// Writes a backslash, the given letter and the lowest 4 * digits bits of value
+// as lowercase hex digits. This is much cheaper than std::hex & friends, which
+// would need saving and restoring the stream state for every single call.
+void outputHexEscape(std::ostream &os, char letter, unsigned value,
+                     int digits) {
+    constexpr const char *hex_digits = "0123456789abcdef";
+    char buf[6] = {'\\', letter};
+    for (int i = digits - 1; i >= 0; --i) {
+        buf[2 + i] = hex_digits[value & 0xF];
+        value >>= 4;
+    }
+    os.write(buf, 2 + digits);
+}
+}  // namespace
+
 void Renderer::output(HexEscape value) {
-    OStreamStateSaver s(_os);
-    _os << R"(\x)" << std::hex << std::setw(2) << std::setfill('0')
-        << static_cast<unsigned>(static_cast<unsigned char>(value._ch));
+    outputHexEscape(_os, 'x', static_cast<unsigned char>(value._ch), 2);
+}
+
+void Renderer::output(const RowFragment &value) {
+    outputRowFragment(value._str);
 }
 
-void Renderer::output(const RowFragment &value) { _os << value._str; }
+void Renderer::outputRowFragment(const std::string &value) { _os << value; }
 
 void Renderer::output(char16_t value) {
-    OStreamStateSaver s(_os);
-    _os << R"(\u)" << std::hex << std::setw(4) << std::setfill('0')
-        << static_cast<unsigned int>(value);
+    outputHexEscape(_os, 'u', value, 4);
 }
 
 void Renderer::output(char32_t value) {
@@ -86,17 +132,61 @@ void Renderer::output(const std::vector<char> &value) { outputBlob(value); }
 
 void Renderer::output(const std::string &value) { outputString(value); }
 
+void Renderer::output(std::string_view value) { outputString(value); }
+
 void Renderer::output(std::chrono::system_clock::time_point value) {
-    output(std::chrono::system_clock::to_time_t(value));
+    outputTime(std::chrono::system_clock::to_time_t(value));
 }
 
+void Renderer::outputTime(time_t value) { outputInteger(value); }
+
 namespace {
 bool isBoringChar(unsigned char ch) {
     return 32 <= ch && ch <= 127 && ch != '"' && ch != '\\';
 }
 
+// Returns the end of the run of boring characters starting at start. Plugin
+// output is mostly ASCII, so with SSE2 we check 16 bytes at a time and only
+// look at single bytes for the tail of the string.
+const char *skipBoringChars(const char *start, const char *end) {
+    const char *p = start;
+#ifdef __SSE2__
+    // As signed bytes, everything >= 128 is negative, so a single signed
+    // comparison catches both control characters and non-ASCII bytes.
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    while (end - p >= 16) {
+        __m128i chunk =
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+        __m128i special = _mm_or_si128(
+            _mm_cmplt_epi8(chunk, space),
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, quote),
+                         _mm_cmpeq_epi8(chunk, backslash)));
+        auto mask = static_cast<unsigned>(_mm_movemask_epi8(special));
+        if (mask != 0) {
+            return p + std::countr_zero(mask);
+        }
+        p += 16;
+    }
+#endif
+    while (p != end && isBoringChar(*p)) {
+        ++p;
+    }
+    return p;
+}
 }  // namespace
 
+// Boring characters are the vast majority, so we write them in runs, saving a
+// lot of stream overhead compared to putting them one by one.
+void Renderer::outputBoringChars(const char *&p, const char *end) {
+    const char *run_end = skipBoringChars(p, end);
+    if (run_end != p) {
+        _os.write(p, run_end - p);
+        p = run_end;
+    }
+}
+
 void Renderer::truncatedUTF8() {
     Warning(_logger) << "UTF-8 sequence too short";
 }
@@ -108,12 +198,13 @@ void Renderer::invalidUTF8(unsigned char ch) {
 void Renderer::outputByteString(const std::string &prefix,
                                 const std::vector<char> &value) {
     _os << prefix << R"(")";  // "
-    for (auto ch : value) {
-        if (isBoringChar(ch)) {
-            output(PlainChar{ch});
-        } else {
-            output(HexEscape{ch});
+    const char *end = value.data() + value.size();
+    for (const char *p = value.data(); p != end; ++p) {
+        outputBoringChars(p, end);
+        if (p == end) {
+            break;
         }
+        output(HexEscape{*p});
     }
     _os << R"(")";  // "
 }
@@ -139,13 +230,13 @@ void Renderer::outputUnicodeString(const std::string &prefix, const char *start,
 
 void Renderer::outputUTF8(const char *start, const char *end) {
     for (const char *p = start; p != end; ++p) {
+        outputBoringChars(p, end);
+        if (p == end) {
+            break;
+        }
         unsigned char ch0 = *p;
         if ((ch0 & 0x80) == 0x00) {
-            if (isBoringChar(ch0)) {
-                output(PlainChar{*p});
-            } else {
-                output(char32_t{ch0});
-            }
+            output(char32_t{ch0});
         } else if ((ch0 & 0xE0) == 0xC0) {
             // 2 byte encoding
             if (ch0 == 0xC0 || ch0 == 0xC1) {
@@ -210,21 +301,22 @@ void Renderer::outputUTF8(const char *start, const char *end) {
 
 void Renderer::outputLatin1(const char *start, const char *end) {
     for (const char *p = start; p != end; ++p) {
-        unsigned char ch = *p;
-        if (isBoringChar(ch)) {
-            output(PlainChar{*p});
-        } else {
-            output(char32_t{ch});
+        outputBoringChars(p, end);
+        if (p == end) {
+            break;
         }
+        output(char32_t{static_cast<unsigned char>(*p)});
     }
 }
 
 void Renderer::outputMixed(const char *start, const char *end) {
     for (const char *p = start; p != end; ++p) {
+        outputBoringChars(p, end);
+        if (p == end) {
+            break;
+        }
         unsigned char ch0 = *p;
-        if (isBoringChar(ch0)) {
-            output(PlainChar{*p});
-        } else if ((ch0 & 0xE0) == 0xC0) {
+        if ((ch0 & 0xE0) == 0xC0) {
             // Possible 2 byte encoding? => Assume UTF-8, ignore overlong
             // encodings
             if (end <= &p[1]) {
@@ -9,9 +9,13 @@
 #include "config.h"  // IWYU pragma: keep
 
 #include <chrono>
+#include <cstddef>
+#include <ctime>
 #include <iosfwd>
 #include <memory>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -19,7 +23,7 @@
 class CSVSeparators;
 class Logger;
 
-enum class OutputFormat { csv, broken_csv, json, python, python3 };
+enum class OutputFormat { csv, broken_csv, json, python, python3, binary };
 
 struct Null {};
 
@@ -48,9 +52,14 @@ public:
     // default implementation for (un)signed int/long
     template <typename T>
     void output(T value) {
-        _os << std::to_string(value);
+        if constexpr (std::is_signed_v<T>) {
+            outputInteger(value);
+        } else {
+            outputUnsignedInteger(value);
+        }
     }
 
+    void output(bool value) { output(value ? 1 : 0); }
     void output(double value);
     void output(PlainChar value);
     void output(HexEscape value);
@@ -60,6 +69,7 @@ public:
     void output(Null value);
     void output(const std::vector<char> &value);
     void output(const std::string &value);
+    void output(std::string_view value);
     void output(std::chrono::system_clock::time_point value);
 
     // A whole query.
@@ -90,6 +100,17 @@ public:
     virtual void separateDictKeyValue() = 0;
     virtual void endDict() = 0;
 
+    // Renderers which don't write their output right away report how much
+    // they have buffered, so the response size limit still works for them.
+    [[nodiscard]] virtual size_t bufferedSize() const { return 0; }
+
+    // Renderers with a place of their own for the column headers take them
+    // here, all others get them as the first row of the query.
+    virtual bool outputColumnHeaders(
+        const std::vector<std::string> & /*names*/) {
+        return false;
+    }
+
 protected:
     std::ostream &_os;
     const Encoding _data_encoding;
@@ -104,15 +125,29 @@ protected:
 private:
     Logger *const _logger;
 
+    void outputBoringChars(const char *&p, const char *end);
     void outputUTF8(const char *start, const char *end);
     void outputLatin1(const char *start, const char *end);
     void outputMixed(const char *start, const char *end);
     void truncatedUTF8();
     void invalidUTF8(unsigned char ch);
 
+    // JSON and Python have a proper syntax for floating point numbers, so they
+    // can use the shortest representation reading back to the very same value.
+    // CSV sticks to the 6 significant digits we always had.
+    [[nodiscard]] virtual bool roundTripDoubles() const { return false; }
+
+    // The textual formats share the formatting of numbers and RowFragments,
+    // the binary one needs to know the type of each value.
+    virtual void outputInteger(long long value);
+    virtual void outputUnsignedInteger(unsigned long long value);
+    virtual void outputDouble(double value);
+    virtual void outputTime(time_t value);
+    virtual void outputRowFragment(const std::string &value);
+
     virtual void outputNull() = 0;
     virtual void outputBlob(const std::vector<char> &value) = 0;
-    virtual void outputString(const std::string &value) = 0;
+    virtual void outputString(std::string_view value) = 0;
 };
 
 enum class EmitBeginEnd { on, off };
@@ -0,0 +1,419 @@
+// Copyright (C) 2019 tribe29 GmbH - License: GNU General Public License v2
+// This file is part of Checkmk (https://checkmk.com). It is subject to the
+// terms and conditions defined in the file COPYING, which is part of this
+// source code package.
+
+#include "RendererBinary.h"
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+#include <ostream>
+#include <unordered_map>
+#include <utility>
+class Logger;
+
+using Type = RendererBinary::Type;
+using Value = RendererBinary::Value;
+
+namespace {
+void putBytes(std::ostream &os, uint64_t value, size_t size) {
+    char buf[8];
+    for (size_t i = 0; i < size; ++i) {
+        buf[i] = static_cast<char>(value >> (8 * i));
+    }
+    os.write(buf, static_cast<std::streamsize>(size));
+}
+
+void putType(std::ostream &os, Type type) {
+    os.put(static_cast<char>(type));
+}
+
+void putU32(std::ostream &os, size_t value) { putBytes(os, value, 4); }
+
+void putI64(std::ostream &os, int64_t value) {
+    putBytes(os, static_cast<uint64_t>(value), 8);
+}
+
+void putReal(std::ostream &os, double value) {
+    putBytes(os, std::bit_cast<uint64_t>(value), 8);
+}
+
+void putBytesWithLength(std::ostream &os, const std::string &value) {
+    putU32(os, value.size());
+    os.write(value.data(), static_cast<std::streamsize>(value.size()));
+}
+
+uint64_t getBytes(std::string_view &in, size_t size) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < size; ++i) {
+        value |= uint64_t{static_cast<unsigned char>(in[i])} << (8 * i);
+    }
+    in.remove_prefix(size);
+    return value;
+}
+
+// RowFragments from parallel scans and stats groups are written row by row,
+// with each value as its Type byte followed by an i64 for integers and times,
+// a double for reals, a u32 length plus the bytes for strings and blobs, and
+// a u32 number of elements plus the elements for lists and dicts. This is the
+// internal format between renderers of the same query only.
+void encodeValue(std::ostream &os, const Value &value) {
+    putType(os, value.type);
+    switch (value.type) {
+        case Type::int64:
+        case Type::time:
+            putI64(os, value.integer);
+            break;
+        case Type::real:
+            putReal(os, value.real);
+            break;
+        case Type::string:
+        case Type::blob:
+            putBytesWithLength(os, value.bytes);
+            break;
+        case Type::list:
+        case Type::dict:
+            putU32(os, value.elements.size());
+            for (const auto &element : value.elements) {
+                encodeValue(os, element);
+            }
+            break;
+        case Type::null:
+        case Type::int32:
+        case Type::mixed:
+            break;
+    }
+}
+
+Value decodeValue(std::string_view &in) {
+    Value value;
+    value.type = static_cast<Type>(getBytes(in, 1));
+    switch (value.type) {
+        case Type::int64:
+        case Type::time:
+            value.integer = static_cast<int64_t>(getBytes(in, 8));
+            break;
+        case Type::real:
+            value.real = std::bit_cast<double>(getBytes(in, 8));
+            break;
+        case Type::string:
+        case Type::blob: {
+            auto size = getBytes(in, 4);
+            value.bytes = in.substr(0, size);
+            in.remove_prefix(size);
+            break;
+        }
+        case Type::list:
+        case Type::dict: {
+            auto size = getBytes(in, 4);
+            value.elements.reserve(size);
+            for (uint64_t i = 0; i < size; ++i) {
+                value.elements.push_back(decodeValue(in));
+            }
+            break;
+        }
+        case Type::null:
+        case Type::int32:
+        case Type::mixed:
+            break;
+    }
+    return value;
+}
+
+Value makeValue(Type type) {
+    Value value;
+    value.type = type;
+    return value;
+}
+
+Value makeInteger(Type type, int64_t integer) {
+    auto value = makeValue(type);
+    value.integer = integer;
+    return value;
+}
+
+Value makeBytes(Type type, std::string bytes) {
+    auto value = makeValue(type);
+    value.bytes = std::move(bytes);
+    return value;
+}
+
+using Column = std::vector<const Value *>;
+
+bool fitsInt32(const Value *value) {
+    return std::numeric_limits<int32_t>::min() <= value->integer &&
+           value->integer <= std::numeric_limits<int32_t>::max();
+}
+
+Type typeOf(const Column &column) {
+    if (column.empty()) {
+        return Type::null;
+    }
+    auto type = column.front()->type;
+    if (!std::all_of(column.begin(), column.end(),
+                     [&](const Value *v) { return v->type == type; })) {
+        return Type::mixed;
+    }
+    if (type == Type::int64 &&
+        std::all_of(column.begin(), column.end(), fitsInt32)) {
+        return Type::int32;
+    }
+    return type;
+}
+
+// What buffering a value costs us, not counting its elements: the Value
+// itself, the bytes of strings and blobs and the unused capacity for elements.
+size_t ownMemoryUsage(const Value &value) {
+    return sizeof(Value) + value.bytes.size() +
+           (value.elements.capacity() - value.elements.size()) * sizeof(Value);
+}
+
+size_t memoryUsage(const Value &value) {
+    auto usage = ownMemoryUsage(value);
+    for (const auto &element : value.elements) {
+        usage += memoryUsage(element);
+    }
+    return usage;
+}
+
+void encodeColumn(std::ostream &os, const Column &column);
+
+void encodeStrings(std::ostream &os, const Column &column) {
+    std::unordered_map<std::string_view, size_t> indices;
+    std::vector<const std::string *> strings;
+    std::vector<size_t> row_indices;
+    row_indices.reserve(column.size());
+    for (const auto *value : column) {
+        auto [it, inserted] = indices.emplace(value->bytes, strings.size());
+        if (inserted) {
+            strings.push_back(&value->bytes);
+        }
+        row_indices.push_back(it->second);
+    }
+    putU32(os, strings.size());
+    for (const auto *str : strings) {
+        putBytesWithLength(os, *str);
+    }
+    for (auto index : row_indices) {
+        putU32(os, index);
+    }
+}
+
+// Lists have one element per entry, dicts a key and a value.
+void encodeContainers(std::ostream &os, const Column &column,
+                      size_t entry_size) {
+    std::vector<Column> parts(entry_size);
+    size_t offset = 0;
+    putU32(os, offset);
+    for (const auto *value : column) {
+        const auto &elements = value->elements;
+        for (size_t i = 0; i < elements.size(); ++i) {
+            parts[i % entry_size].push_back(&elements[i]);
+        }
+        offset += elements.size() / entry_size;
+        putU32(os, offset);
+    }
+    for (const auto &part : parts) {
+        encodeColumn(os, part);
+    }
+}
+
+void encodeMixed(std::ostream &os, const Column &column) {
+    std::vector<Column> parts(static_cast<size_t>(Type::mixed));
+    for (const auto *value : column) {
+        putType(os, value->type);
+        parts[static_cast<size_t>(value->type)].push_back(value);
+    }
+    for (size_t i = 1; i < parts.size(); ++i) {
+        if (!parts[i].empty()) {
+            encodeColumn(os, parts[i]);
+        }
+    }
+}
+
+void encodeColumn(std::ostream &os, const Column &column) {
+    auto type = typeOf(column);
+    putType(os, type);
+    switch (type) {
+        case Type::null:
+            break;
+        case Type::int32:
+            for (const auto *value : column) {
+                putU32(os, static_cast<uint32_t>(value->integer));
+            }
+            break;
+        case Type::int64:
+        case Type::time:
+            for (const auto *value : column) {
+                putI64(os, value->integer);
+            }
+            break;
+        case Type::real:
+            for (const auto *value : column) {
+                putReal(os, value->real);
+            }
+            break;
+        case Type::string:
+            encodeStrings(os, column);
+            break;
+        case Type::blob:
+            for (const auto *value : column) {
+                putBytesWithLength(os, value->bytes);
+            }
+            break;
+        case Type::list:
+            encodeContainers(os, column, 1);
+            break;
+        case Type::dict:
+            encodeContainers(os, column, 2);
+            break;
+        case Type::mixed:
+            encodeMixed(os, column);
+            break;
+    }
+}
+}  // namespace
+
+RendererBinary::RendererBinary(std::ostream &os, Logger *logger,
+                               Encoding data_encoding)
+    : Renderer(os, logger, data_encoding) {}
+
+void RendererBinary::add(Value value) {
+    _buffered += ownMemoryUsage(value);
+    if (_open.empty()) {
+        _row.push_back(std::move(value));
+    } else {
+        _open.back().elements.push_back(std::move(value));
+    }
+}
+
+// --------------------------------------------------------------------------
+
+bool RendererBinary::outputColumnHeaders(
+    const std::vector<std::string> &names) {
+    _column_headers = names;
+    return true;
+}
+
+// --------------------------------------------------------------------------
+
+void RendererBinary::beginQuery() { _in_query = true; }
+void RendererBinary::separateQueryElements() {}
+void RendererBinary::endQuery() {
+    size_t num_columns = _column_headers.size();
+    for (const auto &row : _rows) {
+        num_columns = std::max(num_columns, row.size());
+    }
+    _os << "LQB1";
+    putU32(_os, _rows.size());
+    putU32(_os, num_columns);
+    if (_column_headers.empty()) {
+        putU32(_os, 0);
+    } else {
+        _column_headers.resize(num_columns);
+        putU32(_os, num_columns);
+        for (const auto &name : _column_headers) {
+            putBytesWithLength(_os, name);
+        }
+    }
+    const Value null;
+    Column column;
+    column.reserve(_rows.size());
+    for (size_t i = 0; i < num_columns; ++i) {
+        column.clear();
+        for (const auto &row : _rows) {
+            column.push_back(i < row.size() ? &row[i] : &null);
+        }
+        encodeColumn(_os, column);
+    }
+    _column_headers.clear();
+    _rows.clear();
+    _buffered = 0;
+    _in_query = false;
+}
+
+// --------------------------------------------------------------------------
+
+void RendererBinary::beginRow() {}
+void RendererBinary::beginRowElement() {}
+void RendererBinary::endRowElement() {
+    // Without a surrounding query we are rendering a RowFragment.
+    if (!_in_query && _open.empty()) {
+        for (const auto &value : _row) {
+            encodeValue(_os, value);
+        }
+        _row.clear();
+    }
+}
+void RendererBinary::separateRowElements() {}
+void RendererBinary::endRow() {
+    _buffered += sizeof(_row) + (_row.capacity() - _row.size()) * sizeof(Value);
+    auto num_columns = _row.size();
+    _rows.push_back(std::move(_row));
+    _row.clear();
+    // All rows have the same columns, so avoid growing the next one bit by bit.
+    _row.reserve(num_columns);
+}
+
+// --------------------------------------------------------------------------
+
+void RendererBinary::beginList() { _open.push_back(makeValue(Type::list)); }
+void RendererBinary::separateListElements() {}
+void RendererBinary::endList() {
+    auto list = std::move(_open.back());
+    _open.pop_back();
+    add(std::move(list));
+}
+
+// --------------------------------------------------------------------------
+
+void RendererBinary::beginSublist() { beginList(); }
+void RendererBinary::separateSublistElements() {}
+void RendererBinary::endSublist() { endList(); }
+
+// --------------------------------------------------------------------------
+
+void RendererBinary::beginDict() { _open.push_back(makeValue(Type::dict)); }
+void RendererBinary::separateDictElements() {}
+void RendererBinary::separateDictKeyValue() {}
+void RendererBinary::endDict() { endList(); }
+
+// --------------------------------------------------------------------------
+
+void RendererBinary::outputInteger(long long value) {
+    add(makeInteger(Type::int64, value));
+}
+
+// Nothing we output comes even close to 2^63, so we simply wrap around.
+void RendererBinary::outputUnsignedInteger(unsigned long long value) {
+    add(makeInteger(Type::int64, static_cast<int64_t>(value)));
+}
+
+void RendererBinary::outputDouble(double value) {
+    auto real = makeValue(Type::real);
+    real.real = value;
+    add(std::move(real));
+}
+
+void RendererBinary::outputTime(time_t value) {
+    add(makeInteger(Type::time, value));
+}
+
+void RendererBinary::outputRowFragment(const std::string &value) {
+    std::string_view in{value};
+    while (!in.empty()) {
+        _row.push_back(decodeValue(in));
+        _buffered += memoryUsage(_row.back());
+    }
+}
+
+void RendererBinary::outputNull() { add(Value{}); }
+
+void RendererBinary::outputBlob(const std::vector<char> &value) {
+    add(makeBytes(Type::blob, std::string(value.begin(), value.end())));
+}
+
+void RendererBinary::outputString(std::string_view value) {
+    add(makeBytes(Type::string, std::string{value}));
+}
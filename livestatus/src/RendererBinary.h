@@ -0,0 +1,123 @@
+// Copyright (C) 2019 tribe29 GmbH - License: GNU General Public License v2
+// This file is part of Checkmk (https://checkmk.com). It is subject to the
+// terms and conditions defined in the file COPYING, which is part of this
+// source code package.
+
+#ifndef RendererBinary_h
+#define RendererBinary_h
+
+#include "config.h"  // IWYU pragma: keep
+
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Renderer.h"
+#include "data_encoding.h"
+class Logger;
+
+// A column-oriented binary format, so clients don't have to parse any text.
+// All numbers are little-endian, strings are passed through in the data
+// encoding of the core. A response is the magic "LQB1", the number of rows
+// (u32), the number of columns (u32), the number of column headers (u32,
+// either 0 or the number of columns) each one as a u32 length plus its bytes,
+// and then every column, each one consisting of a Type byte followed by the
+// values of all rows:
+//
+//   null:   nothing, all values are null
+//   int32:  an i32 per row
+//   int64:  an i64 per row
+//   real:   an IEEE 754 double per row
+//   time:   an i64 per row, seconds since the epoch
+//   string: the number of distinct strings (u32), each one as a u32 length
+//           plus its bytes, then an u32 index into these per row
+//   blob:   a u32 length plus the bytes per row
+//   list:   rows + 1 u32 offsets into a column holding all list elements
+//   dict:   rows + 1 u32 offsets into a column of keys and one of values
+//   mixed:  a Type byte per row, using int64 for all integers, then a
+//           column for the non-null rows of each of these types, ordered by
+//           type
+//
+// Lists and dicts nest, so a list of lists is a list column containing a
+// list column. The column headers are kept apart from the rows, so they don't
+// turn every column into a mixed one. Everything is buffered until the end of
+// the query.
+class RendererBinary final : public Renderer {
+public:
+    enum class Type : uint8_t {
+        null,
+        int32,
+        int64,
+        real,
+        time,
+        string,
+        blob,
+        list,
+        dict,
+        mixed
+    };
+
+    RendererBinary(std::ostream &os, Logger *logger, Encoding data_encoding);
+
+    void beginQuery() override;
+    void separateQueryElements() override;
+    void endQuery() override;
+
+    void beginRow() override;
+    void beginRowElement() override;
+    void endRowElement() override;
+    void separateRowElements() override;
+    void endRow() override;
+
+    void beginList() override;
+    void separateListElements() override;
+    void endList() override;
+
+    void beginSublist() override;
+    void separateSublistElements() override;
+    void endSublist() override;
+
+    void beginDict() override;
+    void separateDictElements() override;
+    void separateDictKeyValue() override;
+    void endDict() override;
+
+    [[nodiscard]] size_t bufferedSize() const override { return _buffered; }
+    bool outputColumnHeaders(const std::vector<std::string> &names) override;
+
+    // A single value of any type, lists hold their elements and dicts their
+    // keys and values alternately.
+    struct Value {
+        Type type{Type::null};
+        int64_t integer{0};
+        double real{0};
+        std::string bytes;
+        std::vector<Value> elements;
+    };
+
+private:
+    bool _in_query{false};
+    std::vector<std::string> _column_headers;
+    std::vector<std::vector<Value>> _rows;
+    std::vector<Value> _row;
+    std::vector<Value> _open;  // lists and dicts being built
+    size_t _buffered{0};
+
+    void add(Value value);
+
+    void outputInteger(long long value) override;
+    void outputUnsignedInteger(unsigned long long value) override;
+    void outputDouble(double value) override;
+    void outputTime(time_t value) override;
+    void outputRowFragment(const std::string &value) override;
+
+    void outputNull() override;
+    void outputBlob(const std::vector<char> &value) override;
+    void outputString(std::string_view value) override;
+};
+
+#endif  // RendererBinary_h
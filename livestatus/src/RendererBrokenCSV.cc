@@ -52,4 +52,6 @@ void RendererBrokenCSV::outputBlob(const std::vector<char> &value) {
     _os.write(&value[0], value.size());
 }
 
-void RendererBrokenCSV::outputString(const std::string &value) { _os << value; }
+void RendererBrokenCSV::outputString(std::string_view value) {
+    _os << value;
+}
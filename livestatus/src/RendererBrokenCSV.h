@@ -10,6 +10,7 @@
 
 #include <iosfwd>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
@@ -40,7 +41,7 @@ private:
 
 // A broken CSV renderer, just for backwards compatibility with old Livestatus
 // versions.
-class RendererBrokenCSV : public Renderer {
+class RendererBrokenCSV final : public Renderer {
 public:
     RendererBrokenCSV(std::ostream& os, Logger* logger,
                       CSVSeparators separators, Encoding data_encoding)
@@ -49,7 +50,7 @@ public:
 
     void outputNull() override;
     void outputBlob(const std::vector<char>& value) override;
-    void outputString(const std::string& value) override;
+    void outputString(std::string_view value) override;
 
     void beginQuery() override;
     void separateQueryElements() override;
@@ -5,6 +5,7 @@
 
 #include "RendererCSV.h"
 
+#include <algorithm>
 #include <ostream>
 class Logger;
 
@@ -49,18 +50,24 @@ void RendererCSV::endDict() {}
 
 void RendererCSV::outputNull() {}
 
-void RendererCSV::outputEscaped(char ch) {
-    _os << (ch == '"' ? R"("")" : std::string(1, ch));
+// Everything between double quotes is written in one go.
+void RendererCSV::outputEscaped(std::string_view value) {
+    while (true) {
+        auto pos = value.find('"');
+        _os.write(value.data(), static_cast<std::streamsize>(
+                                    std::min(pos, value.size())));
+        if (pos == std::string_view::npos) {
+            return;
+        }
+        _os << R"("")";
+        value.remove_prefix(pos + 1);
+    }
 }
 
 void RendererCSV::outputBlob(const std::vector<char> &value) {
-    for (auto ch : value) {
-        outputEscaped(ch);
-    }
+    outputEscaped(std::string_view{value.data(), value.size()});
 }
 
-void RendererCSV::outputString(const std::string &value) {
-    for (auto ch : value) {
-        outputEscaped(ch);
-    }
+void RendererCSV::outputString(std::string_view value) {
+    outputEscaped(value);
 }
@@ -10,6 +10,7 @@
 
 #include <iosfwd>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "Renderer.h"
@@ -18,13 +19,13 @@ class Logger;
 
 // Note: The CSV format is a bit underspecified, but the most "authorative"
 // reference seems to be https://tools.ietf.org/html/rfc4180.
-class RendererCSV : public Renderer {
+class RendererCSV final : public Renderer {
 public:
     RendererCSV(std::ostream &os, Logger *logger, Encoding data_encoding);
 
     void outputNull() override;
     void outputBlob(const std::vector<char> &value) override;
-    void outputString(const std::string &value) override;
+    void outputString(std::string_view value) override;
 
     void beginQuery() override;
     void separateQueryElements() override;
@@ -50,7 +51,7 @@ public:
     void endDict() override;
 
 private:
-    void outputEscaped(char ch);
+    void outputEscaped(std::string_view value);
 };
 
 #endif  // RendererCSV_h
@@ -55,8 +55,7 @@ void RendererJSON::outputBlob(const std::vector<char> &value) {
     outputUnicodeString("", &value[0], &value[value.size()], Encoding::latin1);
 }
 
-void RendererJSON::outputString(const std::string &value) {
-    // cppcheck is too dumb to see that we just take the address... :-/
-    // cppcheck-suppress containerOutOfBoundsIndexExpression
-    outputUnicodeString("", &value[0], &value[value.size()], _data_encoding);
+void RendererJSON::outputString(std::string_view value) {
+    outputUnicodeString("", value.data(), value.data() + value.size(),
+                        _data_encoding);
 }
@@ -53,8 +53,7 @@ void RendererPython3::outputBlob(const std::vector<char> &value) {
     outputByteString("b", value);
 }
 
-void RendererPython3::outputString(const std::string &value) {
-    // cppcheck is too dumb to see that we just take the address... :-/
-    // cppcheck-suppress containerOutOfBoundsIndexExpression
-    outputUnicodeString("u", &value[0], &value[value.size()], _data_encoding);
+void RendererPython3::outputString(std::string_view value) {
+    outputUnicodeString("u", value.data(), value.data() + value.size(),
+                        _data_encoding);
 }
@@ -10,19 +10,21 @@
 
 #include <iosfwd>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "Renderer.h"
 #include "data_encoding.h"
 class Logger;
 
-class RendererPython3 : public Renderer {
+class RendererPython3 final : public Renderer {
 public:
     RendererPython3(std::ostream &os, Logger *logger, Encoding data_encoding);
 
     void outputNull() override;
     void outputBlob(const std::vector<char> &value) override;
-    void outputString(const std::string &value) override;
+    void outputString(std::string_view value) override;
+    [[nodiscard]] bool roundTripDoubles() const override { return true; }
 
     void beginQuery() override;
     void separateQueryElements() override;
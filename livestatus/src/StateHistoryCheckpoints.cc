@@ -0,0 +1,119 @@
+// Copyright (C) 2019 tribe29 GmbH - License: GNU General Public License v2
+// This file is part of Checkmk (https://checkmk.com). It is subject to the
+// terms and conditions defined in the file COPYING, which is part of this
+// source code package.
+
+#include "StateHistoryCheckpoints.h"
+
+#include <utility>
+
+// static
+size_t StateHistoryCheckpoints::memoryUsage(const Checkpoint &checkpoint) {
+    size_t bytes = sizeof(Checkpoint);
+    for (const auto &[name, active] : checkpoint.notification_periods) {
+        // a map node has 4 pointers/flags besides its value
+        bytes += sizeof(std::pair<std::string, int>) + 32 + name.size();
+    }
+    for (const auto &entry : checkpoint.states) {
+        const auto &state = entry.state;
+        bytes += sizeof(Checkpoint::Entry) +
+                 entry.services.capacity() * sizeof(size_t) +
+                 state._debug_info.size() + state._notification_period.size() +
+                 state._service_period.size() + state._host_name.size() +
+                 state._service_description.size();
+    }
+    return bytes;
+}
+
+std::shared_ptr<const StateHistoryCheckpoints::Checkpoint>
+StateHistoryCheckpoints::find(config_t config, time_t logfile,
+                              time_t before) {
+    std::lock_guard<std::mutex> lg(_mutex);
+    auto *checkpoints = checkpointsFor(config, logfile);
+    if (checkpoints == nullptr) {
+        return nullptr;
+    }
+    // Keys start with the time, so the checkpoints are sorted by time, too.
+    std::shared_ptr<const Checkpoint> result;
+    for (const auto &[key, checkpoint] : *checkpoints) {
+        if (checkpoint->time >= before) {
+            break;
+        }
+        result = checkpoint;
+    }
+    return result;
+}
+
+bool StateHistoryCheckpoints::contains(config_t config, time_t logfile,
+                                       uint64_t key) {
+    std::lock_guard<std::mutex> lg(_mutex);
+    auto *checkpoints = checkpointsFor(config, logfile);
+    return checkpoints != nullptr && checkpoints->count(key) != 0;
+}
+
+void StateHistoryCheckpoints::add(
+    config_t config, time_t logfile,
+    std::shared_ptr<const Checkpoint> checkpoint) {
+    if (checkpoint->bytes > max_bytes) {
+        return;
+    }
+    std::lock_guard<std::mutex> lg(_mutex);
+    auto *checkpoints = checkpointsFor(config, logfile);
+    if (checkpoints == nullptr) {
+        _logfiles.emplace_front(logfile, checkpoints_t{});
+        if (_logfiles.size() > max_logfiles) {
+            dropLogfile();
+        }
+        checkpoints = &_logfiles.front().second;
+    }
+    auto key = checkpoint->key;
+    auto bytes = checkpoint->bytes;
+    if (checkpoints->emplace(key, std::move(checkpoint)).second) {
+        _count++;
+        _bytes += bytes;
+    }
+    while (_count > max_checkpoints || _bytes > max_bytes) {
+        dropOldest();
+    }
+}
+
+// Must be called with the mutex held. Makes the logfile the most recently
+// used one.
+StateHistoryCheckpoints::checkpoints_t *
+StateHistoryCheckpoints::checkpointsFor(config_t config, time_t logfile) {
+    if (config != _config) {
+        _logfiles.clear();
+        _count = 0;
+        _bytes = 0;
+        _config = config;
+    }
+    for (auto it = _logfiles.begin(); it != _logfiles.end(); ++it) {
+        if (it->first == logfile) {
+            _logfiles.splice(_logfiles.begin(), _logfiles, it);
+            return &_logfiles.front().second;
+        }
+    }
+    return nullptr;
+}
+
+// Must be called with the mutex held. Drops the oldest checkpoint of the least
+// recently used logfile.
+void StateHistoryCheckpoints::dropOldest() {
+    auto &checkpoints = _logfiles.back().second;
+    auto it = checkpoints.begin();
+    _count--;
+    _bytes -= it->second->bytes;
+    checkpoints.erase(it);
+    if (checkpoints.empty()) {
+        _logfiles.pop_back();
+    }
+}
+
+// Must be called with the mutex held. Drops the least recently used logfile.
+void StateHistoryCheckpoints::dropLogfile() {
+    for (const auto &[key, checkpoint] : _logfiles.back().second) {
+        _count--;
+        _bytes -= checkpoint->bytes;
+    }
+    _logfiles.pop_back();
+}
@@ -0,0 +1,88 @@
+// Copyright (C) 2019 tribe29 GmbH - License: GNU General Public License v2
+// This file is part of Checkmk (https://checkmk.com). It is subject to the
+// terms and conditions defined in the file COPYING, which is part of this
+// source code package.
+
+#ifndef StateHistoryCheckpoints_h
+#define StateHistoryCheckpoints_h
+
+#include "config.h"  // IWYU pragma: keep
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "HostServiceState.h"
+
+// Snapshots of the states of all hosts and services, taken by
+// TableStateHistory while replaying a logfile up to the start of a query. A
+// later query starting in the same logfile can continue the replay from the
+// last snapshot before its start instead of from the beginning of the
+// logfile. The snapshots refer to objects of the monitoring core, so they are
+// dropped when its configuration changes.
+class StateHistoryCheckpoints {
+public:
+    // Roughly the time between two checkpoints of a logfile.
+    static constexpr time_t interval = 3600;
+    // Only the checkpoints of the most recently used logfiles are kept, and
+    // only up to the following number and size. Beyond that, the oldest
+    // checkpoints of the least recently used logfile go first.
+    static constexpr size_t max_logfiles = 2;
+    static constexpr size_t max_checkpoints = 48;
+    static constexpr size_t max_bytes = 64 * 1024 * 1024;
+
+    struct Checkpoint {
+        // The outputs of a state are not kept, they are looked up again via
+        // the key of their log entry when the checkpoint is restored.
+        struct Entry {
+            HostServiceKey key;
+            HostServiceState state;        // without its _services, outputs
+            std::vector<size_t> services;  // indices of the _services
+            uint64_t output_key;           // 0 if there is no output
+        };
+
+        uint64_t key;  // of the last log entry applied
+        time_t time;   // of the last log entry applied
+        std::vector<Entry> states;
+        std::map<std::string, int> notification_periods;
+        bool in_nagios_initial_states;
+        size_t bytes;  // roughly, see memoryUsage()
+    };
+
+    static size_t memoryUsage(const Checkpoint &checkpoint);
+
+    // The logfile is identified by the time of its first entry.
+    using config_t = std::chrono::system_clock::time_point;
+
+    // The latest checkpoint of the logfile taken before the given time.
+    std::shared_ptr<const Checkpoint> find(config_t config, time_t logfile,
+                                           time_t before);
+    [[nodiscard]] bool contains(config_t config, time_t logfile,
+                                uint64_t key);
+    void add(config_t config, time_t logfile,
+             std::shared_ptr<const Checkpoint> checkpoint);
+
+private:
+    using checkpoints_t =
+        std::map<uint64_t, std::shared_ptr<const Checkpoint>>;
+
+    std::mutex _mutex;
+    config_t _config;
+    // most recently used logfile first
+    std::list<std::pair<time_t, checkpoints_t>> _logfiles;
+    size_t _count{0};
+    size_t _bytes{0};
+
+    checkpoints_t *checkpointsFor(config_t config, time_t logfile);
+    void dropOldest();
+    void dropLogfile();
+};
+
+#endif  // StateHistoryCheckpoints_h
@@ -0,0 +1,99 @@
+// Copyright (C) 2019 tribe29 GmbH - License: GNU General Public License v2
+// This file is part of Checkmk (https://checkmk.com). It is subject to the
+// terms and conditions defined in the file COPYING, which is part of this
+// source code package.
+
+#ifndef StateIndex_h
+#define StateIndex_h
+
+#include "config.h"  // IWYU pragma: keep
+
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+/// Keeps track of the current state of a fixed set of objects, so that all
+/// objects in a given set of states can be found without looking at every
+/// single object. Updates come from the core's main thread, lookups from the
+/// client threads, so everything is protected by a mutex.
+template <typename T>
+class StateIndex {
+public:
+    /// Objects have to be added in their natural order, which is kept when
+    /// looking up objects.
+    void add(const T *object, int state) {
+        std::lock_guard<std::mutex> lg(_mutex);
+        if (_entries.emplace(object, Entry{_entries.size(), state}).second) {
+            _by_state[bucketFor(state)].insert(object);
+        }
+    }
+
+    /// Records a new state for an object, unknown objects are ignored.
+    void update(const T *object, int state) {
+        std::lock_guard<std::mutex> lg(_mutex);
+        auto it = _entries.find(object);
+        if (it == _entries.end() || it->second.state == state) {
+            return;
+        }
+        _by_state[bucketFor(it->second.state)].erase(object);
+        _by_state[bucketFor(state)].insert(object);
+        it->second.state = state;
+    }
+
+    /// All objects in one of the given states, in their natural order. Objects
+    /// with a state outside of the bitset's range are always included, so the
+    /// result is a superset of the real answer.
+    [[nodiscard]] std::vector<const T *> objectsWithStates(
+        std::bitset<32> states) const {
+        std::vector<std::pair<size_t, const T *>> found;
+        {
+            std::lock_guard<std::mutex> lg(_mutex);
+            for (size_t bucket = 0; bucket < _by_state.size(); ++bucket) {
+                if (bucket == other_states || states[bucket]) {
+                    for (const auto *object : _by_state[bucket]) {
+                        found.emplace_back(_entries.at(object).position,
+                                           object);
+                    }
+                }
+            }
+        }
+        std::sort(found.begin(), found.end());
+        std::vector<const T *> result;
+        result.reserve(found.size());
+        for (const auto &[position, object] : found) {
+            result.push_back(object);
+        }
+        return result;
+    }
+
+    [[nodiscard]] size_t size() const {
+        std::lock_guard<std::mutex> lg(_mutex);
+        return _entries.size();
+    }
+
+private:
+    static constexpr size_t other_states = 32;
+
+    struct Entry {
+        size_t position;
+        int state;
+    };
+
+    mutable std::mutex _mutex;
+    std::unordered_map<const T *, Entry> _entries;
+    std::array<std::unordered_set<const T *>, other_states + 1> _by_state;
+
+    static size_t bucketFor(int state) {
+        return 0 <= state && static_cast<size_t>(state) < other_states
+                   ? static_cast<size_t>(state)
+                   : other_states;
+    }
+};
+
+#endif  // StateIndex_h
@@ -0,0 +1,75 @@
+// Copyright (C) 2019 tribe29 GmbH - License: GNU General Public License v2
+// This file is part of Checkmk (https://checkmk.com). It is subject to the
+// terms and conditions defined in the file COPYING, which is part of this
+// source code package.
+
+#include "StatsGroups.h"
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+
+StatsGroups::Group *StatsGroups::find(std::string_view key) const {
+    if (_slots.empty()) {
+        return nullptr;
+    }
+    return _slots[slotFor(key, std::hash<std::string_view>{}(key))].group;
+}
+
+StatsGroups::Group &StatsGroups::insert(
+    std::string key, RowFragment fragment,
+    std::vector<std::unique_ptr<Aggregator>> aggregators) {
+    // Keep the load factor below 1/2, so probe sequences stay short.
+    if (2 * (_groups.size() + 1) > _slots.size()) {
+        grow();
+    }
+    auto hash = std::hash<std::string_view>{}(key);
+    auto &slot = _slots[slotFor(key, hash)];
+    if (slot.group == nullptr) {
+        _groups.push_back(std::make_unique<Group>(Group{
+            std::move(key), std::move(fragment), std::move(aggregators)}));
+        slot = Slot{hash, _groups.back().get()};
+    }
+    return *slot.group;
+}
+
+std::vector<const StatsGroups::Group *> StatsGroups::sorted() const {
+    std::vector<const Group *> result;
+    result.reserve(_groups.size());
+    for (const auto &group : _groups) {
+        result.push_back(group.get());
+    }
+    std::stable_sort(result.begin(), result.end(),
+                     [](const Group *a, const Group *b) {
+                         return a->fragment._str < b->fragment._str;
+                     });
+    return result;
+}
+
+size_t StatsGroups::slotFor(std::string_view key, size_t hash) const {
+    // The number of slots is a power of 2 and there is always an empty one.
+    auto mask = _slots.size() - 1;
+    for (auto i = hash & mask;; i = (i + 1) & mask) {
+        const auto &slot = _slots[i];
+        if (slot.group == nullptr ||
+            (slot.hash == hash && slot.group->key == key)) {
+            return i;
+        }
+    }
+}
+
+void StatsGroups::grow() {
+    std::vector<Slot> slots(_slots.empty() ? 16 : 2 * _slots.size(),
+                            Slot{0, nullptr});
+    auto mask = slots.size() - 1;
+    for (const auto &slot : _slots) {
+        if (slot.group != nullptr) {
+            auto i = slot.hash & mask;
+            while (slots[i].group != nullptr) {
+                i = (i + 1) & mask;
+            }
+            slots[i] = slot;
+        }
+    }
+    _slots = std::move(slots);
+}
@@ -0,0 +1,56 @@
+// Copyright (C) 2019 tribe29 GmbH - License: GNU General Public License v2
+// This file is part of Checkmk (https://checkmk.com). It is subject to the
+// terms and conditions defined in the file COPYING, which is part of this
+// source code package.
+
+#ifndef StatsGroups_h
+#define StatsGroups_h
+
+#include "config.h"  // IWYU pragma: keep
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Aggregator.h"  // IWYU pragma: keep
+#include "Renderer.h"
+
+/// The groups of a stats query, found via an open-addressing hash table with
+/// linear probing on a binary group key. The rendered form of the group key
+/// is computed only once, when the group is created.
+class StatsGroups {
+public:
+    struct Group {
+        std::string key;
+        RowFragment fragment;
+        std::vector<std::unique_ptr<Aggregator>> aggregators;
+    };
+
+    [[nodiscard]] Group *find(std::string_view key) const;
+    Group &insert(std::string key, RowFragment fragment,
+                  std::vector<std::unique_ptr<Aggregator>> aggregators);
+    [[nodiscard]] size_t size() const { return _groups.size(); }
+
+    // Iteration in insertion order
+    [[nodiscard]] auto begin() const { return _groups.begin(); }
+    [[nodiscard]] auto end() const { return _groups.end(); }
+
+    /// All groups, ordered by their rendered key.
+    [[nodiscard]] std::vector<const Group *> sorted() const;
+
+private:
+    struct Slot {
+        size_t hash;
+        Group *group;  // nullptr for an empty slot
+    };
+
+    std::vector<std::unique_ptr<Group>> _groups;
+    std::vector<Slot> _slots;
+
+    [[nodiscard]] size_t slotFor(std::string_view key, size_t hash) const;
+    void grow();
+};
+
+#endif  // StatsGroups_h
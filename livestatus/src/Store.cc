@@ -9,8 +9,10 @@
 #include <filesystem>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <sstream>
 #include <stdexcept>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -23,12 +25,14 @@
 #include "Query.h"
 #include "StringUtils.h"
 #include "Table.h"
+#include "Triggers.h"
 #include "mk_logwatch.h"
 
 Store::Store(MonitoringCore *mc)
     : _mc(mc)
     , _downtimes(mc)
     , _comments(mc)
+    , _authorization_cache(mc)
     , _log_cache(mc)
     , _table_columns(mc)
     , _table_commands(mc)
@@ -109,6 +113,17 @@ void Store::registerComment(nebstruct_comment_data *data) {
     _comments.registerComment(data);
 }
 
+void Store::updateState(const host *hst) { _table_hosts.updateState(hst); }
+
+void Store::updateState(const service *svc) {
+    _table_services.updateState(svc);
+}
+
+void Store::updateStates() {
+    _table_hosts.updateStates();
+    _table_services.updateStates();
+}
+
 namespace {
 std::list<std::string> getLines(InputBuffer &input) {
     std::list<std::string> lines;
@@ -302,15 +317,38 @@ void Store::answerCommandNagios(const ExternalCommand &command) {
 bool Store::answerGetRequest(const std::list<std::string> &lines,
                              OutputBuffer &output,
                              const std::string &tablename) {
-    return Query(lines, findTable(output, tablename), _mc->dataEncoding(),
-                 _mc->maxResponseSize(), output, logger())
-        .process();
+    Query query(lines, findTable(output, tablename), _mc->dataEncoding(),
+                _mc->maxResponseSize(), output, logger());
+    auto max_bytes = _mc->queryCacheSize();
+    // Streamed responses can't be reused, so identical streaming requests
+    // must not wait for each other either.
+    if (max_bytes == 0 || !query.cacheable() || output.streaming() ||
+        !output.getError().empty()) {
+        return query.process();
+    }
+    auto cached = _query_cache.answer(
+        QueryCache::makeKey(tablename, lines, query.timezoneOffset()),
+        _mc->triggers().generation(), query.maxStaleness(), max_bytes,
+        [&]() -> std::optional<std::string> {
+            query.process();
+            // Only complete responses without errors can be reused, so
+            // nothing must have been streamed to the client already.
+            auto response = output.str();
+            if (!output.getError().empty() ||
+                static_cast<size_t>(output.os().tellp()) != response.size()) {
+                return {};
+            }
+            return response;
+        });
+    if (cached) {
+        Debug(logger()) << "answered request from query cache";
+        output.os() << *cached;
+    }
+    return query.keepalive();
 }
 
 Logger *Store::logger() const { return _mc->loggerLivestatus(); }
 
 size_t Store::numCachedLogMessages() {
-    std::lock_guard<std::mutex> lg(_log_cache._lock);
-    _log_cache.update();
     return _log_cache.numCachedLogMessages();
 }
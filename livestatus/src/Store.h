@@ -17,6 +17,7 @@
 #include <vector>
 #endif
 #include "LogCache.h"
+#include "QueryCache.h"
 #include "Table.h"
 #include "TableColumns.h"
 #include "TableCommands.h"
@@ -57,6 +58,7 @@ class Object;
 #include <mutex>
 
 #include "DowntimesOrComments.h"
+#include "auth.h"
 #include "nagios.h"
 #endif
 
@@ -84,6 +86,9 @@ public:
 
     void registerDowntime(nebstruct_downtime_data *data);
     void registerComment(nebstruct_comment_data *data);
+    void updateState(const host *hst);
+    void updateState(const service *svc);
+    void updateStates();
 #endif
     [[nodiscard]] Logger *logger() const;
     size_t numCachedLogMessages();
@@ -107,10 +112,12 @@ private:
 public:
     DowntimesOrComments _downtimes;
     DowntimesOrComments _comments;
+    AuthorizationCache _authorization_cache;
 
 private:
 #endif
     LogCache _log_cache;
+    QueryCache _query_cache;
 
 #ifdef CMC
     TableCachedStatehist _table_cached_statehist;
@@ -5,7 +5,9 @@
 
 #include "StringColumn.h"
 
+#include <cstddef>
 #include <stdexcept>
+#include <string_view>
 
 #include "Filter.h"
 #include "Renderer.h"
@@ -15,7 +17,24 @@
 void StringColumn::output(Row row, RowRenderer &r,
                           const contact * /*auth_user*/,
                           std::chrono::seconds /*timezone_offset*/) const {
-    r.output(row.isNull() ? "" : getValue(row));
+    std::string buffer;
+    r.output(row.isNull() ? std::string_view{} : getView(row, buffer));
+}
+
+bool StringColumn::appendGroupKey(
+    Row row, std::string &key, const contact * /*auth_user*/,
+    std::chrono::seconds /*timezone_offset*/) const {
+    std::string buffer;
+    auto value = row.isNull() ? std::string_view{} : getView(row, buffer);
+    auto size = value.size();
+    key.append(reinterpret_cast<const char *>(&size), sizeof(size));
+    key.append(value);
+    return true;
+}
+
+std::string_view StringColumn::getView(Row row, std::string &buffer) const {
+    buffer = getValue(row);
+    return buffer;
 }
 
 std::unique_ptr<Filter> StringColumn::createFilter(
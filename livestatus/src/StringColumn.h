@@ -11,6 +11,7 @@
 #include <chrono>
 #include <memory>
 #include <string>
+#include <string_view>
 
 #include "Column.h"
 #include "Filter.h"
@@ -31,6 +32,9 @@ public:
     void output(Row row, RowRenderer &r, const contact *auth_user,
                 std::chrono::seconds timezone_offset) const override;
 
+    bool appendGroupKey(Row row, std::string &key, const contact *auth_user,
+                        std::chrono::seconds timezone_offset) const override;
+
     [[nodiscard]] std::unique_ptr<Filter> createFilter(
         Filter::Kind kind, RelationalOperator relOp,
         const std::string &value) const override;
@@ -39,6 +43,14 @@ public:
         AggregationFactory factory) const override;
 
     [[nodiscard]] virtual std::string getValue(Row row) const = 0;
+
+    // Zero-copy variant of getValue(): The result refers to data owned by the
+    // row if possible. Only columns which really have to compute their value
+    // store it in the given buffer and return a view into it, which is what
+    // the default implementation does. The view is valid as long as the row
+    // data and the buffer are.
+    [[nodiscard]] virtual std::string_view getView(Row row,
+                                                   std::string &buffer) const;
 };
 
 #endif  // StringColumn_h
@@ -5,7 +5,10 @@
 
 #include "StringFilter.h"
 
+#include <cstddef>
+
 #include "Filter.h"
+#include "FilterProgram.h"
 #include "RegExp.h"
 #include "Row.h"
 #include "StringColumn.h"
@@ -18,7 +21,8 @@ StringFilter::StringFilter(Kind kind, const StringColumn &column,
 
 bool StringFilter::accepts(Row row, const contact * /* auth_user */,
                            std::chrono::seconds /* timezone_offset */) const {
-    std::string act_string = _column.getValue(row);
+    std::string buffer;
+    auto act_string = _column.getView(row, buffer);
     switch (oper()) {
         case RelationalOperator::equal:
         case RelationalOperator::equal_icase:
@@ -69,6 +73,64 @@ std::optional<std::string> StringFilter::stringValueRestrictionFor(
     return {};  // unreachable
 }
 
+namespace {
+// Extracts the literal prefix of a regular expression anchored with '^', being
+// conservative about everything which is not a plain literal character.
+std::optional<std::string> literalPrefixOf(const std::string &regex) {
+    if (regex.empty() || regex[0] != '^' ||
+        regex.find('|') != std::string::npos) {
+        return {};
+    }
+    std::string prefix;
+    for (size_t i = 1; i < regex.size(); ++i) {
+        char c = regex[i];
+        if (c == '*' || c == '?' || c == '{') {
+            // The previous character is optional or repeated.
+            if (!prefix.empty()) {
+                prefix.pop_back();
+            }
+            break;
+        }
+        if (c == '.' || c == '[' || c == '(' || c == ')' || c == '\\' ||
+            c == '+' || c == '^' || c == '$' || c == ']' || c == '}') {
+            break;
+        }
+        prefix += c;
+    }
+    return prefix.empty() ? std::nullopt : std::make_optional(prefix);
+}
+}  // namespace
+
+std::optional<std::string> StringFilter::stringPrefixRestrictionFor(
+    const std::string &column_name) const {
+    if (column_name != columnName()) {
+        return {};  // wrong column
+    }
+    switch (oper()) {
+        case RelationalOperator::equal:
+            return value().empty() ? std::nullopt
+                                   : std::make_optional(value());
+        case RelationalOperator::matches:
+            return literalPrefixOf(value());
+        case RelationalOperator::not_equal:
+        case RelationalOperator::doesnt_match:
+        case RelationalOperator::equal_icase:
+        case RelationalOperator::not_equal_icase:
+        case RelationalOperator::matches_icase:
+        case RelationalOperator::doesnt_match_icase:
+        case RelationalOperator::less:
+        case RelationalOperator::greater_or_equal:
+        case RelationalOperator::greater:
+        case RelationalOperator::less_or_equal:
+            return {};
+    }
+    return {};  // unreachable
+}
+
+void StringFilter::compile(FilterProgram &program) const {
+    program.emitStringComparison(_column, oper(), value(), _regExp);
+}
+
 std::unique_ptr<Filter> StringFilter::copy() const {
     return std::make_unique<StringFilter>(*this);
 }
@@ -17,6 +17,7 @@
 #include "Filter.h"
 #include "contact_fwd.h"
 #include "opids.h"
+class FilterProgram;
 class RegExp;
 class Row;
 class StringColumn;
@@ -29,6 +30,9 @@ public:
                  std::chrono::seconds timezone_offset) const override;
     [[nodiscard]] std::optional<std::string> stringValueRestrictionFor(
         const std::string &column_name) const override;
+    [[nodiscard]] std::optional<std::string> stringPrefixRestrictionFor(
+        const std::string &column_name) const override;
+    void compile(FilterProgram &program) const override;
     [[nodiscard]] std::unique_ptr<Filter> copy() const override;
     [[nodiscard]] std::unique_ptr<Filter> negate() const override;
 
@@ -10,6 +10,8 @@
 
 #include <functional>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <utility>
 
 #include "StringColumn.h"
@@ -22,37 +24,78 @@ class StringLambdaColumn : public StringColumn {
 public:
     struct Constant;
     struct Reference;
+
+    // Lambdas returning a C string, a std::string_view or a reference to an
+    // existing std::string give zero-copy access via getView(), lambdas
+    // returning a std::string by value compute the value on every access.
+    template <class F>
     StringLambdaColumn(std::string name, std::string description,
-                       ColumnOffsets offsets,
-                       std::function<std::string(const T&)> gv)
+                       ColumnOffsets offsets, F gv)
         : StringColumn(std::move(name), std::move(description),
-                       std::move(offsets))
-        , get_value_(std::move(gv)) {}
+                       std::move(offsets)) {
+        if constexpr (std::is_pointer_v<std::invoke_result_t<F, const T&>>) {
+            get_view_ = [gv = std::move(gv)](const T& t) {
+                const char* str = gv(t);
+                return str == nullptr ? std::string_view{}
+                                      : std::string_view{str};
+            };
+        } else if constexpr (yields_view<F>) {
+            get_view_ = std::move(gv);
+        } else {
+            get_value_ = std::move(gv);
+        }
+    }
 
     ~StringLambdaColumn() override = default;
 
     [[nodiscard]] std::string getValue(Row row) const override {
         using namespace std::string_literals;
         const T* data = columnData<T>(row);
-        return data == nullptr ? ""s : get_value_(*data);
+        if (data == nullptr) {
+            return ""s;
+        }
+        return get_view_ ? std::string{get_view_(*data)} : get_value_(*data);
+    }
+
+    [[nodiscard]] std::string_view getView(Row row,
+                                           std::string& buffer) const override {
+        const T* data = columnData<T>(row);
+        if (data == nullptr) {
+            return {};
+        }
+        if (get_view_) {
+            return get_view_(*data);
+        }
+        buffer = get_value_(*data);
+        return buffer;
     }
 
 private:
+    template <class F>
+    static constexpr bool yields_view = [] {
+        using R = std::invoke_result_t<F, const T&>;
+        return std::is_pointer_v<R> || std::is_lvalue_reference_v<R> ||
+               std::is_same_v<R, std::string_view>;
+    }();
+
     std::function<std::string(const T&)> get_value_;
+    std::function<std::string_view(const T&)> get_view_;
 };
 
 template <class T>
 struct StringLambdaColumn<T>::Constant : StringLambdaColumn {
     Constant(std::string name, std::string description, const std::string& x)
-        : StringLambdaColumn(std::move(name), std::move(description), {},
-                             [x](const T& /*t*/) { return x; }){};
+        : StringLambdaColumn(
+              std::move(name), std::move(description), {},
+              [x](const T& /*t*/) -> const std::string& { return x; }){};
 };
 
 template <class T>
 struct StringLambdaColumn<T>::Reference : StringLambdaColumn {
     Reference(std::string name, std::string description, const std::string& x)
-        : StringLambdaColumn(std::move(name), std::move(description), {},
-                             [&x](const T& /*t*/) { return x; }){};
+        : StringLambdaColumn(
+              std::move(name), std::move(description), {},
+              [&x](const T& /*t*/) -> const std::string& { return x; }){};
 };
 
 #endif
@@ -51,6 +51,7 @@
 #include "ServiceListStateColumn.h"
 #include "StringLambdaColumn.h"
 #include "StringPerfdataColumn.h"
+#include "ThreadPool.h"
 #include "TimeLambdaColumn.h"
 #include "TimeperiodsCache.h"
 #include "auth.h"
@@ -59,9 +60,13 @@
 
 extern host *host_list;
 extern TimeperiodsCache *g_timeperiods_cache;
+extern ThreadPool *g_scan_pool;
 
 TableHosts::TableHosts(MonitoringCore *mc) : Table(mc) {
     addColumns(this, "", ColumnOffsets{});
+    for (const auto *hst = host_list; hst != nullptr; hst = hst->next) {
+        _state_index.add(hst, hst->current_state);
+    }
 }
 
 std::string TableHosts::name() const { return "hosts"; }
@@ -759,8 +764,28 @@ void TableHosts::answerQuery(Query *query) {
         return;
     }
 
+    // do we know the possible states?
+    if (auto states = query->valueSetLeastUpperBoundFor("state");
+        states && !states->all()) {
+        Debug(logger()) << "using host state index";
+        for (const auto *r : _state_index.objectsWithStates(*states)) {
+            if (!query->processDataset(Row(r))) {
+                break;
+            }
+        }
+        return;
+    }
+
     // no index -> linear search over all hosts
     Debug(logger()) << "using full table scan";
+    if (g_scan_pool != nullptr) {
+        std::vector<Row> rows;
+        for (const auto *hst = host_list; hst != nullptr; hst = hst->next) {
+            rows.emplace_back(hst);
+        }
+        query->processDatasets(rows, g_scan_pool);
+        return;
+    }
     for (const auto *hst = host_list; hst != nullptr; hst = hst->next) {
         const host *r = hst;
         if (!query->processDataset(Row(r))) {
@@ -768,6 +793,17 @@ void TableHosts::answerQuery(Query *query) {
         }
     }
 }
+
+void TableHosts::updateState(const host *hst) {
+    _state_index.update(hst, hst->current_state);
+}
+
+void TableHosts::updateStates() {
+    for (const auto *hst = host_list; hst != nullptr; hst = hst->next) {
+        updateState(hst);
+    }
+}
+
 bool TableHosts::isAuthorized(Row row, const contact *ctc) const {
     return is_authorized_for(core(), ctc, rowData<host>(row), nullptr);
 }
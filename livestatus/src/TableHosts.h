@@ -11,8 +11,10 @@
 #include <string>
 
 #include "Row.h"
+#include "StateIndex.h"
 #include "Table.h"
 #include "contact_fwd.h"
+#include "nagios.h"
 class ColumnOffsets;
 class MonitoringCore;
 class Query;
@@ -28,6 +30,13 @@ public:
     void answerQuery(Query *query) override;
     bool isAuthorized(Row row, const contact *ctc) const override;
     [[nodiscard]] Row findObject(const std::string &objectspec) const override;
+    void updateState(const host *hst);
+    // Resyncs the state index with all hosts, needed after the core has read
+    // its retention data behind our back.
+    void updateStates();
+
+private:
+    StateIndex<host> _state_index;
 };
 
 #endif  // TableHosts_h
@@ -10,17 +10,21 @@
 #include <cstdint>
 #include <map>
 #include <memory>
-#include <mutex>
 #include <optional>
+#include <shared_mutex>
 #include <stdexcept>
 #include <utility>
+#include <vector>
 
 #include "Column.h"
 #include "IntLambdaColumn.h"
 #include "LogCache.h"
 #include "LogEntry.h"
 #include "LogEntryStringColumn.h"
+#include "LogObjectCache.h"
+#include "LogPrefetcher.h"
 #include "Logfile.h"
+#include "LogfileIndex.h"
 #include "MonitoringCore.h"
 #include "Query.h"
 #include "Row.h"
@@ -29,6 +33,7 @@
 #include "TableContacts.h"
 #include "TableHosts.h"
 #include "TableServices.h"
+#include "ThreadPool.h"
 #include "TimeLambdaColumn.h"
 
 #ifdef CMC
@@ -38,6 +43,8 @@
 #include "nagios.h"
 #endif
 
+extern ThreadPool *g_scan_pool;
+
 namespace {
 
 class LogRow {
@@ -77,7 +84,9 @@ TableLog::TableLog(MonitoringCore *mc, LogCache *log_cache)
         [](const LogEntry &r) { return static_cast<int32_t>(r._class); }));
     addColumn(std::make_unique<StringLambdaColumn<LogEntry>>(
         "message", "The complete message line including the timestamp",
-        offsets_entry, [](const LogEntry &r) { return r._message; }));
+        offsets_entry, [](const LogEntry &r) -> const std::string & {
+            return r._message;
+        }));
     addColumn(std::make_unique<StringLambdaColumn<LogEntry>>(
         "type",
         "The type of the message (text before the colon), the message itself for info messages",
@@ -90,22 +99,24 @@ TableLog::TableLog(MonitoringCore *mc, LogCache *log_cache)
         }));
     addColumn(std::make_unique<StringLambdaColumn<LogEntry>>(
         "comment", "A comment field used in various message types",
-        offsets_entry, [](const LogEntry &r) { return r._comment; }));
+        offsets_entry, [](const LogEntry &r) { return r.comment(); }));
     addColumn(std::make_unique<StringLambdaColumn<LogEntry>>(
         "plugin_output",
         "The output of the check, if any is associated with the message",
-        offsets_entry, [](const LogEntry &r) { return r._plugin_output; }));
+        offsets_entry, [](const LogEntry &r) { return r.pluginOutput(); }));
     addColumn(std::make_unique<StringLambdaColumn<LogEntry>>(
         "long_plugin_output",
         "The complete output of the check, if any is associated with the message",
         offsets_entry,
-        [](const LogEntry &r) { return r._long_plugin_output; }));
+        [](const LogEntry &r) { return r.longPluginOutput(); }));
     addColumn(std::make_unique<IntLambdaColumn<LogEntry>>(
         "state", "The state of the host or service in question", offsets_entry,
         [](const LogEntry &r) { return r._state; }));
     addColumn(std::make_unique<StringLambdaColumn<LogEntry>>(
         "state_type", "The type of the state (varies on different log classes)",
-        offsets_entry, [](const LogEntry &r) { return r._state_type; }));
+        offsets_entry, [](const LogEntry &r) -> const std::string & {
+            return r.stateType();
+        }));
     addColumn(std::make_unique<LogEntryStringColumn>(
         "state_info", "Additional information about the state", offsets_entry));
     addColumn(std::make_unique<IntLambdaColumn<LogEntry>>(
@@ -115,19 +126,27 @@ TableLog::TableLog(MonitoringCore *mc, LogCache *log_cache)
         "service_description",
         "The description of the service log entry is about (might be empty)",
         offsets_entry,
-        [](const LogEntry &r) { return r._service_description; }));
+        [](const LogEntry &r) -> const std::string & {
+            return r.serviceDescription();
+        }));
     addColumn(std::make_unique<StringLambdaColumn<LogEntry>>(
         "host_name",
         "The name of the host the log entry is about (might be empty)",
-        offsets_entry, [](const LogEntry &r) { return r._host_name; }));
+        offsets_entry, [](const LogEntry &r) -> const std::string & {
+            return r.hostName();
+        }));
     addColumn(std::make_unique<StringLambdaColumn<LogEntry>>(
         "contact_name",
         "The name of the contact the log entry is about (might be empty)",
-        offsets_entry, [](const LogEntry &r) { return r._contact_name; }));
+        offsets_entry, [](const LogEntry &r) -> const std::string & {
+            return r.contactName();
+        }));
     addColumn(std::make_unique<StringLambdaColumn<LogEntry>>(
         "command_name",
         "The name of the command of the log entry (e.g. for notifications)",
-        offsets_entry, [](const LogEntry &r) { return r._command_name; }));
+        offsets_entry, [](const LogEntry &r) -> const std::string & {
+            return r.commandName();
+        }));
 
     // join host and service tables
     TableHosts::addColumns(this, "current_host_", offsets.add([](Row r) {
@@ -150,9 +169,8 @@ std::string TableLog::name() const { return "log"; }
 std::string TableLog::namePrefix() const { return "log_"; }
 
 void TableLog::answerQuery(Query *query) {
-    std::lock_guard<std::mutex> lg(_log_cache->_lock);
-    _log_cache->update();
-    if (_log_cache->begin() == _log_cache->end()) {
+    auto logfiles = _log_cache->logfiles();
+    if (logfiles.empty()) {
         return;
     }
 
@@ -177,13 +195,13 @@ void TableLog::answerQuery(Query *query) {
        the Limit: header produces more reasonable results. */
 
     /* NEW CODE - NEWEST FIRST */
-    auto it = _log_cache->end();  // it now points beyond last log file
+    auto it = logfiles.end();  // it now points beyond last log file
     --it;  // switch to last logfile (we have at least one)
 
     // Now find newest log where 'until' is contained. The problem
     // here: For each logfile we only know the time of the *first* entry,
     // not that of the last.
-    while (it != _log_cache->begin() && it->first > until) {
+    while (it != logfiles.begin() && it->first > until) {
         // while logfiles are too new go back in history
         --it;
     }
@@ -191,38 +209,70 @@ void TableLog::answerQuery(Query *query) {
         return;  // all logfiles are too new
     }
 
+    // Archived logfiles have an index, so we can skip those which can't
+    // contain anything interesting without loading them.
+    auto host_name = query->stringValueRestrictionFor("host_name");
+    auto interesting = [classmask, host_name](const LogfileIndex *index) {
+        return index == nullptr ||
+               ((index->classes() & classmask) != 0 &&
+                (!host_name || index->mentionsHost(*host_name)));
+    };
+
+    // While we are busy with one logfile, the older ones down to the one
+    // containing 'since' can already be loaded in the background.
+    std::vector<std::shared_ptr<Logfile>> older;
+    auto it_older = it;
+    while (it_older != logfiles.begin() && it_older->first > since) {
+        --it_older;
+        older.push_back(it_older->second);
+    }
+    LogPrefetcher prefetcher{
+        g_scan_pool, std::move(older), core()->maxLinesPerLogFile(),
+        static_cast<unsigned>(classmask),
+        [interesting](Logfile &logfile) {
+            return interesting(logfile.index().get());
+        }};
+
+    LogObjectCache objects{core()};
+    std::shared_lock<std::shared_mutex> lock;
     while (true) {
-        const auto *entries =
-            it->second->getEntriesFor(core()->maxLinesPerLogFile(), classmask);
-        if (!answerQueryReverse(entries, query, since, until)) {
+        lock = std::shared_lock<std::shared_mutex>{};  // see Logfile
+        auto *logfile = it->second.get();
+        auto index = logfile->index();
+        if (index != nullptr && index->classes() != 0 &&
+            index->last() < since) {
             break;  // end of time range found
         }
-        if (it == _log_cache->begin()) {
+        if (interesting(index.get())) {
+            const auto *entries = logfile->getEntriesFor(
+                core()->maxLinesPerLogFile(), classmask, lock);
+            if (!answerQueryReverse(entries, query, objects, since,
+                                    until)) {
+                break;  // end of time range found
+            }
+        }
+        if (it == logfiles.begin()) {
             break;  // this was the oldest one
         }
         --it;
     }
 }
 
-bool TableLog::answerQueryReverse(const logfile_entries_t *entries,
-                                  Query *query, time_t since, time_t until) {
-    auto it = entries->upper_bound(Logfile::makeKey(until, 999999999));
+bool TableLog::answerQueryReverse(const LogEntries *entries, Query *query,
+                                  LogObjectCache &objects, time_t since,
+                                  time_t until) {
+    auto it = entries->upperBound(until);
     while (it != entries->begin()) {
         --it;
-        if (it->second->_time < since) {
+        auto *entry = it->entry;
+        if (entry->_time < since) {
             return false;  // time limit exceeded
         }
-        auto *entry = it->second.get();
-        Command command = core()->find_command(entry->_command_name);
         // TODO(sp): Remove ugly casts.
-        LogRow lr{
-            entry,
-            reinterpret_cast<host *>(core()->find_host(entry->_host_name)),
-            reinterpret_cast<service *>(core()->find_service(
-                entry->_host_name, entry->_service_description)),
-            reinterpret_cast<const contact *>(
-                core()->find_contact(entry->_contact_name)),
-            &command};
+        LogRow lr{entry, reinterpret_cast<host *>(objects.host(*entry)),
+                  reinterpret_cast<service *>(objects.service(*entry)),
+                  reinterpret_cast<const contact *>(objects.contact(*entry)),
+                  objects.command(*entry)};
         const LogRow *r = &lr;
         if (!query->processDataset(Row{r})) {
             return false;
@@ -12,11 +12,12 @@
 #include <memory>
 #include <string>
 
-#include "Logfile.h"
+#include "LogEntries.h"
 #include "Table.h"
 #include "contact_fwd.h"
 class Column;
 class LogCache;
+class LogObjectCache;
 class MonitoringCore;
 class Query;
 class Row;
@@ -34,8 +35,9 @@ public:
 
 private:
     LogCache *_log_cache;
-    bool answerQueryReverse(const logfile_entries_t *entries, Query *query,
-                            time_t since, time_t until);
+    bool answerQueryReverse(const LogEntries *entries, Query *query,
+                            LogObjectCache &objects, time_t since,
+                            time_t until);
 };
 
 #endif  // TableLog_h
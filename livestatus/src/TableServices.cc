@@ -47,6 +47,7 @@
 #include "StringPerfdataColumn.h"
 #include "StringUtils.h"
 #include "TableHosts.h"
+#include "ThreadPool.h"
 #include "TimeLambdaColumn.h"
 #include "TimeperiodsCache.h"
 #include "auth.h"
@@ -54,9 +55,16 @@
 
 extern service *service_list;
 extern TimeperiodsCache *g_timeperiods_cache;
+extern ThreadPool *g_scan_pool;
 
 TableServices::TableServices(MonitoringCore *mc) : Table(mc) {
     addColumns(this, "", ColumnOffsets{}, true);
+    for (const auto *svc = service_list; svc != nullptr; svc = svc->next) {
+        if (svc->description != nullptr) {
+            _services_by_description[svc->description].push_back(svc);
+        }
+        _state_index.add(svc, svc->current_state);
+    }
 }
 
 std::string TableServices::name() const { return "services"; }
@@ -631,8 +639,60 @@ void TableServices::answerQuery(Query *query) {
         return;
     }
 
+    // do we know the service description?
+    if (auto value = query->stringValueRestrictionFor("description")) {
+        Debug(logger()) << "using service description index with '" << *value
+                        << "'";
+        auto it = _services_by_description.find(*value);
+        if (it != _services_by_description.end()) {
+            for (const auto *r : it->second) {
+                if (!query->processDataset(Row(r))) {
+                    break;
+                }
+            }
+        }
+        return;
+    }
+
+    // do we know a prefix of the service description?
+    if (auto prefix = query->stringPrefixRestrictionFor("description")) {
+        Debug(logger()) << "using service description index with prefix '"
+                        << *prefix << "'";
+        for (auto it = _services_by_description.lower_bound(*prefix);
+             it != _services_by_description.end() &&
+             mk::starts_with(it->first, *prefix);
+             ++it) {
+            for (const auto *r : it->second) {
+                if (!query->processDataset(Row(r))) {
+                    return;
+                }
+            }
+        }
+        return;
+    }
+
+    // do we know the possible states?
+    if (auto states = query->valueSetLeastUpperBoundFor("state");
+        states && !states->all()) {
+        Debug(logger()) << "using service state index";
+        for (const auto *r : _state_index.objectsWithStates(*states)) {
+            if (!query->processDataset(Row(r))) {
+                break;
+            }
+        }
+        return;
+    }
+
     // no index -> iterator over *all* services
     Debug(logger()) << "using full table scan";
+    if (g_scan_pool != nullptr) {
+        std::vector<Row> rows;
+        for (const auto *svc = service_list; svc != nullptr; svc = svc->next) {
+            rows.emplace_back(svc);
+        }
+        query->processDatasets(rows, g_scan_pool);
+        return;
+    }
     for (const auto *svc = service_list; svc != nullptr; svc = svc->next) {
         const service *r = svc;
         if (!query->processDataset(Row(r))) {
@@ -641,6 +701,16 @@ void TableServices::answerQuery(Query *query) {
     }
 }
 
+void TableServices::updateState(const service *svc) {
+    _state_index.update(svc, svc->current_state);
+}
+
+void TableServices::updateStates() {
+    for (const auto *svc = service_list; svc != nullptr; svc = svc->next) {
+        updateState(svc);
+    }
+}
+
 bool TableServices::isAuthorized(Row row, const contact *ctc) const {
     const auto *svc = rowData<service>(row);
     return is_authorized_for(core(), ctc, svc->host_ptr, svc);
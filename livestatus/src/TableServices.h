@@ -8,11 +8,16 @@
 
 #include "config.h"  // IWYU pragma: keep
 
+#include <functional>
+#include <map>
 #include <string>
+#include <vector>
 
 #include "Row.h"
+#include "StateIndex.h"
 #include "Table.h"
 #include "contact_fwd.h"
+#include "nagios.h"
 class ColumnOffsets;
 class MonitoringCore;
 class Query;
@@ -28,6 +33,17 @@ public:
     void answerQuery(Query *query) override;
     bool isAuthorized(Row row, const contact *ctc) const override;
     [[nodiscard]] Row findObject(const std::string &objectspec) const override;
+    void updateState(const service *svc);
+    // Resyncs the state index with all services, needed after the core has
+    // read its retention data behind our back.
+    void updateStates();
+
+private:
+    // All services, indexed by their description. Nagios reloads all modules
+    // when its configuration changes, so we see every reload here, too.
+    std::map<std::string, std::vector<const service *>, std::less<>>
+        _services_by_description;
+    StateIndex<service> _state_index;
 };
 
 #endif  // TableServices_h
@@ -5,11 +5,12 @@
 
 #include "TableStateHistory.h"
 
+#include <algorithm>
 #include <chrono>
 #include <cstdint>
 #include <ctime>
+#include <iterator>
 #include <memory>
-#include <mutex>
 #include <optional>
 #include <ostream>
 #include <set>
@@ -23,14 +24,18 @@
 #include "HostServiceState.h"
 #include "IntLambdaColumn.h"
 #include "LogEntry.h"
+#include "LogObjectCache.h"
+#include "LogPrefetcher.h"
 #include "Logger.h"
 #include "MonitoringCore.h"
 #include "Query.h"
 #include "Row.h"
 #include "StringLambdaColumn.h"
+#include "StateHistoryCheckpoints.h"
 #include "StringUtils.h"
 #include "TableHosts.h"
 #include "TableServices.h"
+#include "ThreadPool.h"
 #include "TimeLambdaColumn.h"
 
 #ifdef CMC
@@ -54,6 +59,8 @@
 #include "nagios.h"
 #endif
 
+extern ThreadPool *g_scan_pool;
+
 namespace {
 constexpr unsigned classmask_statehist =
     (1U << static_cast<int>(LogEntry::Class::alert)) |    //
@@ -126,7 +133,9 @@ TableStateHistory::TableStateHistory(MonitoringCore *mc, LogCache *log_cache)
     addColumn(std::make_unique<StringLambdaColumn<HostServiceState>>(
         "notification_period",
         "The notification period of the host or service in question", offsets,
-        [](const HostServiceState &r) { return r._notification_period; }));
+        [](const HostServiceState &r) -> const std::string & {
+            return r._notification_period;
+        }));
     addColumn(std::make_unique<IntLambdaColumn<HostServiceState>>(
         "in_service_period",
         "Shows if the host or service is within its service period", offsets,
@@ -134,22 +143,34 @@ TableStateHistory::TableStateHistory(MonitoringCore *mc, LogCache *log_cache)
     addColumn(std::make_unique<StringLambdaColumn<HostServiceState>>(
         "service_period",
         "The service period of the host or service in question", offsets,
-        [](const HostServiceState &r) { return r._service_period; }));
+        [](const HostServiceState &r) -> const std::string & {
+            return r._service_period;
+        }));
     addColumn(std::make_unique<StringLambdaColumn<HostServiceState>>(
         "debug_info", "Debug information", offsets,
-        [](const HostServiceState &r) { return r._debug_info; }));
+        [](const HostServiceState &r) -> const std::string & {
+            return r._debug_info;
+        }));
     addColumn(std::make_unique<StringLambdaColumn<HostServiceState>>(
         "host_name", "Host name", offsets,
-        [](const HostServiceState &r) { return r._host_name; }));
+        [](const HostServiceState &r) -> const std::string & {
+            return r._host_name;
+        }));
     addColumn(std::make_unique<StringLambdaColumn<HostServiceState>>(
         "service_description", "Description of the service", offsets,
-        [](const HostServiceState &r) { return r._service_description; }));
+        [](const HostServiceState &r) -> const std::string & {
+            return r._service_description;
+        }));
     addColumn(std::make_unique<StringLambdaColumn<HostServiceState>>(
         "log_output", "Logfile output relevant for this state", offsets,
-        [](const HostServiceState &r) { return r._log_output; }));
+        [](const HostServiceState &r) -> const std::string & {
+            return r._log_output;
+        }));
     addColumn(std::make_unique<StringLambdaColumn<HostServiceState>>(
         "long_log_output", "Complete logfile output relevant for this state",
-        offsets, [](const HostServiceState &r) { return r._long_log_output; }));
+        offsets, [](const HostServiceState &r) -> const std::string & {
+            return r._long_log_output;
+        }));
 
     addColumn(std::make_unique<IntLambdaColumn<HostServiceState>>(
         "duration_ok", "OK duration of state ( until - from )", offsets,
@@ -209,39 +230,118 @@ std::string TableStateHistory::name() const { return "statehist"; }
 
 std::string TableStateHistory::namePrefix() const { return "statehist_"; }
 
-void TableStateHistory::getPreviousLogentry() {
-    while (_it_entries == _entries->begin()) {
+void TableStateHistory::getPreviousLogentry(QueryState &qs) {
+    while (qs._it_entries == qs._entries->begin()) {
         // open previous logfile
-        if (_it_logs == _log_cache->begin()) {
+        if (qs._it_logs == qs._logfiles.begin()) {
             return;
         }
-        --_it_logs;
-        _entries = _it_logs->second->getEntriesFor(core()->maxLinesPerLogFile(),
-                                                   classmask_statehist);
-        _it_entries = _entries->end();
+        --qs._it_logs;
+        qs._entries = qs._it_logs->second->getEntriesFor(
+            core()->maxLinesPerLogFile(), classmask_statehist,
+            qs._entries_lock);
+        qs._it_entries = qs._entries->end();
     }
-    --_it_entries;
+    --qs._it_entries;
 }
 
-LogEntry *TableStateHistory::getNextLogentry() {
-    if (_it_entries != _entries->end()) {
-        ++_it_entries;
+LogEntry *TableStateHistory::getNextLogentry(QueryState &qs) {
+    if (qs._it_entries != qs._entries->end()) {
+        ++qs._it_entries;
     }
 
-    while (_it_entries == _entries->end()) {
-        auto it_logs_cpy = _it_logs;
-        if (++it_logs_cpy == _log_cache->end()) {
+    while (qs._it_entries == qs._entries->end()) {
+        auto it_logs_cpy = qs._it_logs;
+        if (++it_logs_cpy == qs._logfiles.end()) {
             return nullptr;
         }
-        ++_it_logs;
-        _entries = _it_logs->second->getEntriesFor(core()->maxLinesPerLogFile(),
-                                                   classmask_statehist);
-        _it_entries = _entries->begin();
+        ++qs._it_logs;
+        qs._entries = qs._it_logs->second->getEntriesFor(
+            core()->maxLinesPerLogFile(), classmask_statehist,
+            qs._entries_lock);
+        qs._it_entries = qs._entries->begin();
     }
-    return _it_entries->second.get();
+    return qs._it_entries->entry;
 }
 
 namespace {
+using state_info_t = std::map<HostServiceKey, HostServiceState *>;
+
+// The outputs of a state are the ones of the last entry applied to it, if any.
+void setOutputs(HostServiceState &state, const LogEntry *entry) {
+    state._output_entry = entry;
+    if (entry == nullptr) {
+        state._log_output = "";
+        state._long_log_output = "";
+        return;
+    }
+    bool fix_me = (entry->_kind == LogEntryKind::state_host_initial ||
+                   entry->_kind == LogEntryKind::state_service_initial) &&
+                  entry->pluginOutput() == "(null)";
+    state._log_output = fix_me ? "" : std::string{entry->pluginOutput()};
+    state._long_log_output = entry->longPluginOutput();
+}
+
+std::shared_ptr<const StateHistoryCheckpoints::Checkpoint> takeCheckpoint(
+    const state_info_t &state_info, const LogEntries::Item &last,
+    const std::map<std::string, int> &notification_periods,
+    bool in_nagios_initial_states) {
+    auto checkpoint = std::make_shared<StateHistoryCheckpoints::Checkpoint>();
+    checkpoint->key = last.key;
+    checkpoint->time = last.entry->_time;
+    checkpoint->notification_periods = notification_periods;
+    checkpoint->in_nagios_initial_states = in_nagios_initial_states;
+    std::map<const HostServiceState *, size_t> indices;
+    for (const auto &[key, state] : state_info) {
+        indices.emplace(state, checkpoint->states.size());
+        const auto *output = state->_output_entry;
+        checkpoint->states.push_back(
+            {key, *state, {},
+             output == nullptr
+                 ? 0
+                 : LogEntries::makeKey(output->_time, output->_lineno)});
+        auto &copy = checkpoint->states.back().state;
+        copy._services.clear();
+        copy._log_output.clear();
+        copy._log_output.shrink_to_fit();
+        copy._long_log_output.clear();
+        copy._long_log_output.shrink_to_fit();
+        copy._output_entry = nullptr;
+    }
+    size_t i = 0;
+    for (const auto &[key, state] : state_info) {
+        for (const auto *svc : state->_services) {
+            checkpoint->states[i].services.push_back(indices.at(svc));
+        }
+        ++i;
+    }
+    checkpoint->bytes = StateHistoryCheckpoints::memoryUsage(*checkpoint);
+    return checkpoint;
+}
+
+// The states start at 'since' of the query restoring them, just like the ones
+// created during the replay, not at 'since' of the query taking the checkpoint.
+// Their outputs are taken from the entries of the logfile of the checkpoint.
+void restoreCheckpoint(const StateHistoryCheckpoints::Checkpoint &checkpoint,
+                       const LogEntries &entries, time_t since,
+                       state_info_t &state_info) {
+    std::vector<HostServiceState *> states;
+    for (const auto &entry : checkpoint.states) {
+        states.push_back(new HostServiceState(entry.state));
+        states.back()->_from = since;
+        auto it = entry.output_key == 0 ? entries.end()
+                                        : entries.find(entry.output_key);
+        setOutputs(*states.back(),
+                   it == entries.end() ? nullptr : it->entry);
+        state_info.emplace(entry.key, states.back());
+    }
+    for (size_t i = 0; i < states.size(); ++i) {
+        for (auto index : checkpoint.states[i].services) {
+            states[i]->_services.push_back(states[index]);
+        }
+    }
+}
+
 class TimeperiodTransition {
 public:
     explicit TimeperiodTransition(const std::string &str) {
@@ -281,93 +381,190 @@ std::unique_ptr<Filter> TableStateHistory::createPartialFilter(
 
 void TableStateHistory::answerQuery(Query *query) {
     auto object_filter = createPartialFilter(*query);
-    std::lock_guard<std::mutex> lg(_log_cache->_lock);
-    _log_cache->update();
-    if (_log_cache->begin() == _log_cache->end()) {
+    QueryState qs;
+    qs._logfiles = _log_cache->logfiles();
+    if (qs._logfiles.empty()) {
         return;
     }
 
     // This flag might be set to true by the return value of processDataset(...)
-    _abort_query = false;
+    qs._abort_query = false;
 
     // Keep track of the historic state of services/hosts here
-    std::map<HostServiceKey, HostServiceState *> state_info;
+    state_info_t state_info;
 
     // Store hosts/services that we have filtered out here
     std::set<HostServiceKey> object_blacklist;
 
+    // Whether the query wants to see a service at all. The object filter only
+    // sees its identity, just like when its state has been created.
+    auto accepted = [&](const HostServiceState &state) {
+        HostServiceState identity;
+        identity._is_host = state._is_host;
+        identity._host = state._host;
+        identity._service = state._service;
+        identity._host_name = state._host_name;
+        identity._service_description = state._service_description;
+        return object_filter->accepts(Row(&identity), query->authUser(),
+                                      query->timezoneOffset());
+    };
+
+    // When the replay before 'since' takes checkpoints, it is done for all
+    // services, so it doesn't depend on the query. Afterwards we drop the
+    // states of the services the query doesn't want.
+    auto drop_rejected = [&] {
+        for (auto it = state_info.begin(); it != state_info.end();) {
+            auto *state = it->second;
+            if (state->_is_host || accepted(*state)) {
+                ++it;
+                continue;
+            }
+            object_blacklist.insert(it->first);
+            auto it_host = state_info.find(state->_host);
+            if (it_host != state_info.end()) {
+                auto &services = it_host->second->_services;
+                services.erase(
+                    std::remove(services.begin(), services.end(), state),
+                    services.end());
+            }
+            delete state;
+            it = state_info.erase(it);
+        }
+    };
+
     // Optimize time interval for the query. In log querys there should always
     // be a time range in form of one or two filter expressions over time. We
     // use that to limit the number of logfiles we need to scan and to find the
     // optimal entry point into the logfile
     if (auto glb = query->greatestLowerBoundFor("time")) {
-        _since = *glb;
+        qs._since = *glb;
     } else {
         query->invalidRequest(
             "Start of timeframe required. e.g. Filter: time > 1234567890");
         return;
     }
-    _until = query->leastUpperBoundFor("time").value_or(time(nullptr)) + 1;
+    qs._until =
+        query->leastUpperBoundFor("time").value_or(time(nullptr)) + 1;
 
-    _query_timeframe = _until - _since - 1;
-    if (_query_timeframe == 0) {
+    qs._query_timeframe = qs._until - qs._since - 1;
+    if (qs._query_timeframe == 0) {
         query->invalidRequest("Query timeframe is 0 seconds");
         return;
     }
 
     // Switch to last logfile (we have at least one)
-    _it_logs = _log_cache->end();
-    --_it_logs;
-    auto newest_log = _it_logs;
+    qs._it_logs = qs._logfiles.end();
+    --qs._it_logs;
+    auto newest_log = qs._it_logs;
 
     // Now find the log where 'since' starts.
-    while (_it_logs != _log_cache->begin() && _it_logs->first >= _since) {
-        --_it_logs;  // go back in history
+    while (qs._it_logs != qs._logfiles.begin() &&
+           qs._it_logs->first >= qs._since) {
+        --qs._it_logs;  // go back in history
     }
 
     // Check if 'until' is within these logfiles
-    if (_it_logs->first > _until) {
+    if (qs._it_logs->first > qs._until) {
         // All logfiles are too new, invalid timeframe
         // -> No data available. Return empty result.
         return;
     }
 
+    // While we are busy with one logfile, the newer ones up to the one
+    // containing 'until' can already be loaded in the background.
+    std::vector<std::shared_ptr<Logfile>> newer;
+    for (auto it = std::next(qs._it_logs);
+         it != qs._logfiles.end() && it->first < qs._until; ++it) {
+        newer.push_back(it->second);
+    }
+    LogPrefetcher prefetcher{g_scan_pool, std::move(newer),
+                             core()->maxLinesPerLogFile(), classmask_statehist,
+                             nullptr};
+
     // Determine initial logentry
-    _entries = _it_logs->second->getEntriesFor(core()->maxLinesPerLogFile(),
-                                               classmask_statehist);
-    if (!_entries->empty() && _it_logs != newest_log) {
-        _it_entries = _entries->end();
+    qs._entries = qs._it_logs->second->getEntriesFor(
+        core()->maxLinesPerLogFile(), classmask_statehist, qs._entries_lock);
+    if (!qs._entries->empty() && qs._it_logs != newest_log) {
+        qs._it_entries = qs._entries->end();
         // Check last entry. If it's younger than _since -> use this logfile too
-        if (--_it_entries != _entries->begin()) {
-            if (_it_entries->second->_time >= _since) {
-                _it_entries = _entries->begin();
+        if (--qs._it_entries != qs._entries->begin()) {
+            if (qs._it_entries->entry->_time >= qs._since) {
+                qs._it_entries = qs._entries->begin();
             }
         }
     } else {
-        _it_entries = _entries->begin();
+        qs._it_entries = qs._entries->begin();
     }
 
+    // Continue the replay from the latest checkpoint before 'since' instead of
+    // from the start of the logfile, if there is one.
+    auto start_log = qs._it_logs;
+    auto config = core()->last_config_change();
+    bool in_nagios_initial_states = false;
+    std::optional<time_t> last_replayed;
+    if (qs._it_entries == qs._entries->begin()) {
+        if (auto checkpoint =
+                _checkpoints.find(config, start_log->first, qs._since)) {
+            auto it = qs._entries->find(checkpoint->key);
+            if (it != qs._entries->end()) {
+                restoreCheckpoint(*checkpoint, *qs._entries, qs._since,
+                                  state_info);
+                qs._notification_periods = checkpoint->notification_periods;
+                in_nagios_initial_states = checkpoint->in_nagios_initial_states;
+                qs._it_entries = it;
+                last_replayed = checkpoint->time;
+            }
+        }
+    }
+
+    // Replaying all services is only worth it if it leaves checkpoints for
+    // later queries, i.e. if the replay crosses an interval boundary before
+    // 'since'. Otherwise the services the query doesn't want are dropped as
+    // soon as they show up.
+    constexpr auto interval = StateHistoryCheckpoints::interval;
+    auto replay_start = last_replayed.value_or(start_log->first);
+    bool take_checkpoints = replay_start / interval != qs._since / interval;
+
     // From now on use getPreviousLogentry() / getNextLogentry()
+    LogObjectCache objects{core()};
     bool only_update = true;
-    bool in_nagios_initial_states = false;
 
-    while (LogEntry *entry = getNextLogentry()) {
-        if (_abort_query) {
+    while (LogEntry *entry = getNextLogentry(qs)) {
+        if (qs._abort_query) {
             break;
         }
 
-        if (entry->_time >= _until) {
-            getPreviousLogentry();
+        if (entry->_time >= qs._until) {
+            getPreviousLogentry(qs);
             break;
         }
-        if (only_update && entry->_time >= _since) {
+        if (only_update && entry->_time >= qs._since) {
             // Reached start of query timeframe. From now on let's produce real
             // output. Update _from time of every state entry
             for (auto &it_hst : state_info) {
-                it_hst.second->_from = _since;
-                it_hst.second->_until = _since;
+                it_hst.second->_from = qs._since;
+                it_hst.second->_until = qs._since;
             }
             only_update = false;
+            drop_rejected();
+        }
+
+        // Take a checkpoint whenever the replay before 'since' crosses an
+        // interval boundary, unless an earlier query has done that already.
+        if (take_checkpoints && only_update && qs._it_logs == start_log) {
+            if (last_replayed &&
+                *last_replayed / interval != entry->_time / interval) {
+                const auto &last = *std::prev(qs._it_entries);
+                if (!_checkpoints.contains(config, start_log->first,
+                                           last.key)) {
+                    _checkpoints.add(
+                        config, start_log->first,
+                        takeCheckpoint(state_info, last,
+                                       qs._notification_periods,
+                                       in_nagios_initial_states));
+                }
+            }
+            last_replayed = entry->_time;
         }
 
         if (in_nagios_initial_states &&
@@ -386,10 +583,9 @@ void TableStateHistory::answerQuery(Query *query) {
         HostServiceKey key = nullptr;
         bool is_service = false;
         // TODO(sp): Remove ugly casts.
-        auto *entry_host =
-            reinterpret_cast<host *>(core()->find_host(entry->_host_name));
-        auto *entry_service = reinterpret_cast<service *>(core()->find_service(
-            entry->_host_name, entry->_service_description));
+        auto *entry_host = reinterpret_cast<host *>(objects.host(*entry));
+        auto *entry_service =
+            reinterpret_cast<service *>(objects.service(*entry));
         switch (entry->_kind) {
             case LogEntryKind::none:
             case LogEntryKind::core_starting:
@@ -432,23 +628,20 @@ void TableStateHistory::answerQuery(Query *query) {
                     // Create state object that we also need for filtering right
                     // now
                     state = new HostServiceState();
-                    state->_is_host = entry->_service_description.empty();
+                    state->_is_host = entry->serviceDescription().empty();
                     state->_host = entry_host;
                     state->_service = entry_service;
-                    state->_host_name = entry->_host_name;
-                    state->_service_description = entry->_service_description;
+                    state->_host_name = entry->hostName();
+                    state->_service_description = entry->serviceDescription();
 
                     // No state found. Now check if this host/services is
                     // filtered out.  Note: we currently do not filter out hosts
                     // since they might be needed for service states
-                    if (!entry->_service_description.empty()) {
-                        if (!object_filter->accepts(Row(state),
-                                                    query->authUser(),
-                                                    query->timezoneOffset())) {
-                            object_blacklist.insert(key);
-                            delete state;
-                            continue;
-                        }
+                    if ((!only_update || !take_checkpoints) &&
+                        !state->_is_host && !accepted(*state)) {
+                        object_blacklist.insert(key);
+                        delete state;
+                        continue;
                     }
 
                     // Host/Service relations
@@ -467,7 +660,7 @@ void TableStateHistory::answerQuery(Query *query) {
 
                     // Store this state object for tracking state transitions
                     state_info.emplace(key, state);
-                    state->_from = _since;
+                    state->_from = qs._since;
 
                     // Get notification period of host/service
                     // If this host/service is no longer availabe in nagios ->
@@ -518,9 +711,9 @@ void TableStateHistory::answerQuery(Query *query) {
                     }
 
                     // Determine initial in_notification_period status
-                    auto tmp_period =
-                        _notification_periods.find(state->_notification_period);
-                    if (tmp_period != _notification_periods.end()) {
+                    auto tmp_period = qs._notification_periods.find(
+                        state->_notification_period);
+                    if (tmp_period != qs._notification_periods.end()) {
                         state->_in_notification_period = tmp_period->second;
                     } else {
                         state->_in_notification_period = 1;
@@ -528,8 +721,8 @@ void TableStateHistory::answerQuery(Query *query) {
 
                     // Same for service period
                     tmp_period =
-                        _notification_periods.find(state->_service_period);
-                    if (tmp_period != _notification_periods.end()) {
+                        qs._notification_periods.find(state->_service_period);
+                    if (tmp_period != qs._notification_periods.end()) {
                         state->_in_service_period = tmp_period->second;
                     } else {
                         state->_in_service_period = 1;
@@ -549,7 +742,7 @@ void TableStateHistory::answerQuery(Query *query) {
                     // Log UNMONITORED state if this host or service just
                     // appeared within the query timeframe
                     // It gets a grace period of ten minutes (nagios startup)
-                    if (!only_update && entry->_time - _since > 60 * 10) {
+                    if (!only_update && entry->_time - qs._since > 60 * 10) {
                         state->_debug_info = "UNMONITORED ";
                         state->_state = -1;
                     }
@@ -557,15 +750,15 @@ void TableStateHistory::answerQuery(Query *query) {
                     state = it_hst->second;
                 }
 
-                int state_changed =
-                    updateHostServiceState(query, entry, state, only_update);
+                int state_changed = updateHostServiceState(
+                    query, qs, entry, state, only_update);
                 // Host downtime or state changes also affect its services
                 if (entry->_kind == LogEntryKind::alert_host ||
                     entry->_kind == LogEntryKind::state_host ||
                     entry->_kind == LogEntryKind::downtime_alert_host) {
                     if (state_changed != 0) {
                         for (auto &svc : state->_services) {
-                            updateHostServiceState(query, entry, svc,
+                            updateHostServiceState(query, qs, entry, svc,
                                                    only_update);
                         }
                     }
@@ -575,9 +768,9 @@ void TableStateHistory::answerQuery(Query *query) {
             case LogEntryKind::timeperiod_transition: {
                 try {
                     TimeperiodTransition tpt(entry->_options);
-                    _notification_periods[tpt.name()] = tpt.to();
+                    qs._notification_periods[tpt.name()] = tpt.to();
                     for (auto &it_hst : state_info) {
-                        updateHostServiceState(query, entry, it_hst.second,
+                        updateHostServiceState(query, qs, entry, it_hst.second,
                                                only_update);
                     }
                 } catch (const std::logic_error &e) {
@@ -606,9 +799,13 @@ void TableStateHistory::answerQuery(Query *query) {
         }
     }
 
+    if (only_update) {
+        drop_rejected();  // 'since' has never been reached
+    }
+
     // Create final reports
     auto it_hst = state_info.begin();
-    if (!_abort_query) {
+    if (!qs._abort_query) {
         while (it_hst != state_info.end()) {
             HostServiceState *hst = it_hst->second;
 
@@ -618,19 +815,18 @@ void TableStateHistory::answerQuery(Query *query) {
                 // Log last known state up to nagios restart
                 hst->_time = hst->_last_known_time;
                 hst->_until = hst->_last_known_time;
-                process(query, hst);
+                process(query, qs, hst);
 
                 // Set absent state
                 hst->_state = -1;
                 hst->_debug_info = "UNMONITORED";
-                hst->_log_output = "";
-                hst->_long_log_output = "";
+                setOutputs(*hst, nullptr);
             }
 
-            hst->_time = _until - 1;
+            hst->_time = qs._until - 1;
             hst->_until = hst->_time;
 
-            process(query, hst);
+            process(query, qs, hst);
             ++it_hst;
         }
     }
@@ -645,7 +841,7 @@ void TableStateHistory::answerQuery(Query *query) {
     object_blacklist.clear();
 }
 
-int TableStateHistory::updateHostServiceState(Query *query,
+int TableStateHistory::updateHostServiceState(Query *query, QueryState &qs,
                                               const LogEntry *entry,
                                               HostServiceState *hs_state,
                                               bool only_update) {
@@ -657,7 +853,7 @@ int TableStateHistory::updateHostServiceState(Query *query,
         hs_state->_time = hs_state->_last_known_time;
         hs_state->_until = hs_state->_last_known_time;
         if (!only_update) {
-            process(query, hs_state);
+            process(query, qs, hs_state);
         }
 
         hs_state->_may_no_longer_exist = false;
@@ -669,14 +865,13 @@ int TableStateHistory::updateHostServiceState(Query *query,
         hs_state->_in_notification_period = 0;
         hs_state->_in_service_period = 0;
         hs_state->_is_flapping = 0;
-        hs_state->_log_output = "";
-        hs_state->_long_log_output = "";
+        setOutputs(*hs_state, nullptr);
 
         // Apply latest notification period information and set the host_state
         // to unmonitored
         auto it_status =
-            _notification_periods.find(hs_state->_notification_period);
-        if (it_status != _notification_periods.end()) {
+            qs._notification_periods.find(hs_state->_notification_period);
+        if (it_status != qs._notification_periods.end()) {
             hs_state->_in_notification_period = it_status->second;
         } else {
             // No notification period information available -> within
@@ -685,8 +880,8 @@ int TableStateHistory::updateHostServiceState(Query *query,
         }
 
         // Same for service period
-        it_status = _notification_periods.find(hs_state->_service_period);
-        if (it_status != _notification_periods.end()) {
+        it_status = qs._notification_periods.find(hs_state->_service_period);
+        if (it_status != qs._notification_periods.end()) {
             hs_state->_in_service_period = it_status->second;
         } else {
             // No service period information available -> within service period
@@ -720,7 +915,7 @@ int TableStateHistory::updateHostServiceState(Query *query,
             if (hs_state->_is_host) {
                 if (hs_state->_state != entry->_state) {
                     if (!only_update) {
-                        process(query, hs_state);
+                        process(query, qs, hs_state);
                     }
                     hs_state->_state = entry->_state;
                     hs_state->_host_down = static_cast<int>(entry->_state > 0);
@@ -731,7 +926,7 @@ int TableStateHistory::updateHostServiceState(Query *query,
             } else if (hs_state->_host_down !=
                        static_cast<int>(entry->_state > 0)) {
                 if (!only_update) {
-                    process(query, hs_state);
+                    process(query, qs, hs_state);
                 }
                 hs_state->_host_down = static_cast<int>(entry->_state > 0);
                 hs_state->_debug_info = "SVC HOST STATE";
@@ -743,7 +938,7 @@ int TableStateHistory::updateHostServiceState(Query *query,
         case LogEntryKind::alert_service: {
             if (hs_state->_state != entry->_state) {
                 if (!only_update) {
-                    process(query, hs_state);
+                    process(query, qs, hs_state);
                 }
                 hs_state->_debug_info = "SVC ALERT";
                 hs_state->_state = entry->_state;
@@ -752,11 +947,11 @@ int TableStateHistory::updateHostServiceState(Query *query,
         }
         case LogEntryKind::downtime_alert_host: {
             int downtime_active =
-                mk::starts_with(entry->_state_type, "STARTED") ? 1 : 0;
+                mk::starts_with(entry->stateType(), "STARTED") ? 1 : 0;
 
             if (hs_state->_in_host_downtime != downtime_active) {
                 if (!only_update) {
-                    process(query, hs_state);
+                    process(query, qs, hs_state);
                 }
                 hs_state->_debug_info =
                     hs_state->_is_host ? "HOST DOWNTIME" : "SVC HOST DOWNTIME";
@@ -771,10 +966,10 @@ int TableStateHistory::updateHostServiceState(Query *query,
         }
         case LogEntryKind::downtime_alert_service: {
             int downtime_active =
-                mk::starts_with(entry->_state_type, "STARTED") ? 1 : 0;
+                mk::starts_with(entry->stateType(), "STARTED") ? 1 : 0;
             if (hs_state->_in_downtime != downtime_active) {
                 if (!only_update) {
-                    process(query, hs_state);
+                    process(query, qs, hs_state);
                 }
                 hs_state->_debug_info = "DOWNTIME SERVICE";
                 hs_state->_in_downtime = downtime_active;
@@ -784,10 +979,10 @@ int TableStateHistory::updateHostServiceState(Query *query,
         case LogEntryKind::flapping_host:
         case LogEntryKind::flapping_service: {
             int flapping_active =
-                mk::starts_with(entry->_state_type, "STARTED") ? 1 : 0;
+                mk::starts_with(entry->stateType(), "STARTED") ? 1 : 0;
             if (hs_state->_is_flapping != flapping_active) {
                 if (!only_update) {
-                    process(query, hs_state);
+                    process(query, qs, hs_state);
                 }
                 hs_state->_debug_info = "FLAPPING ";
                 hs_state->_is_flapping = flapping_active;
@@ -805,7 +1000,7 @@ int TableStateHistory::updateHostServiceState(Query *query,
                     tpt.name() == hs_state->_notification_period) {
                     if (tpt.to() != hs_state->_in_notification_period) {
                         if (!only_update) {
-                            process(query, hs_state);
+                            process(query, qs, hs_state);
                         }
                         hs_state->_debug_info = "TIMEPERIOD ";
                         hs_state->_in_notification_period = tpt.to();
@@ -816,7 +1011,7 @@ int TableStateHistory::updateHostServiceState(Query *query,
                     tpt.name() == hs_state->_service_period) {
                     if (tpt.to() != hs_state->_in_service_period) {
                         if (!only_update) {
-                            process(query, hs_state);
+                            process(query, qs, hs_state);
                         }
                         hs_state->_debug_info = "TIMEPERIOD ";
                         hs_state->_in_service_period = tpt.to();
@@ -832,20 +1027,17 @@ int TableStateHistory::updateHostServiceState(Query *query,
     }
 
     if (entry->_kind != LogEntryKind::timeperiod_transition) {
-        bool fix_me = (entry->_kind == LogEntryKind::state_host_initial ||
-                       entry->_kind == LogEntryKind::state_service_initial) &&
-                      entry->_plugin_output == "(null)";
-        hs_state->_log_output = fix_me ? "" : entry->_plugin_output;
-        hs_state->_long_log_output = entry->_long_plugin_output;
+        setOutputs(*hs_state, entry);
     }
 
     return state_changed;
 }
 
-void TableStateHistory::process(Query *query, HostServiceState *hs_state) {
+void TableStateHistory::process(Query *query, QueryState &qs,
+                                HostServiceState *hs_state) {
     hs_state->_duration = hs_state->_until - hs_state->_from;
     hs_state->_duration_part = static_cast<double>(hs_state->_duration) /
-                               static_cast<double>(_query_timeframe);
+                               static_cast<double>(qs._query_timeframe);
 
     hs_state->_duration_unmonitored = 0;
     hs_state->_duration_part_unmonitored = 0;
@@ -889,7 +1081,7 @@ void TableStateHistory::process(Query *query, HostServiceState *hs_state) {
 
     // if (hs_state->_duration > 0)
     HostServiceState *r = hs_state;
-    _abort_query = !query->processDataset(Row(r));
+    qs._abort_query = !query->processDataset(Row(r));
 
     hs_state->_from = hs_state->_until;
 }
@@ -10,10 +10,13 @@
 
 #include <map>
 #include <memory>
+#include <shared_mutex>
 #include <string>
 
 #include "LogCache.h"
+#include "LogEntries.h"
 #include "Logfile.h"
+#include "StateHistoryCheckpoints.h"
 #include "Table.h"
 class Column;
 class Filter;
@@ -41,28 +44,34 @@ public:
         std::string colname) const override;
     static std::unique_ptr<Filter> createPartialFilter(const Query &query);
 
-protected:
-    bool _abort_query;
-
 private:
     LogCache *_log_cache;
+    StateHistoryCheckpoints _checkpoints;
 
-    int _query_timeframe;
-    int _since;
-    int _until;
+    // Everything needed while answering a single query, so several queries
+    // can be answered concurrently.
+    struct QueryState {
+        int _query_timeframe;
+        int _since;
+        int _until;
+        bool _abort_query;
 
-    // Notification periods information, name: active(1)/inactive(0)
-    std::map<std::string, int> _notification_periods;
+        // Notification periods information, name: active(1)/inactive(0)
+        std::map<std::string, int> _notification_periods;
 
-    // Helper functions to traverse through logfiles
-    logfiles_t::const_iterator _it_logs;
-    const logfile_entries_t *_entries;
-    logfile_entries_t::const_iterator _it_entries;
+        // Helper functions to traverse through logfiles
+        logfiles_t _logfiles;
+        logfiles_t::const_iterator _it_logs;
+        const LogEntries *_entries;
+        LogEntries::const_iterator _it_entries;
+        std::shared_lock<std::shared_mutex> _entries_lock;
+    };
 
-    void getPreviousLogentry();
-    LogEntry *getNextLogentry();
-    void process(Query *query, HostServiceState *hs_state);
-    int updateHostServiceState(Query *query, const LogEntry *entry,
+    void getPreviousLogentry(QueryState &qs);
+    LogEntry *getNextLogentry(QueryState &qs);
+    void process(Query *query, QueryState &qs, HostServiceState *hs_state);
+    int updateHostServiceState(Query *query, QueryState &qs,
+                               const LogEntry *entry,
                                HostServiceState *hs_state, bool only_update);
 };
 
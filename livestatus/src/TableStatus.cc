@@ -75,6 +75,15 @@ TableStatus::TableStatus(MonitoringCore *mc) : Table(mc) {
                       Counter::commands);
     addCounterColumns("livechecks", "checks executed via livecheck", offsets,
                       Counter::livechecks);
+    addCounterColumns("log_cache_hits",
+                      "log file accesses served from the log cache", offsets,
+                      Counter::log_cache_hits);
+    addCounterColumns("log_cache_misses",
+                      "log file accesses which had to read from disk", offsets,
+                      Counter::log_cache_misses);
+    addCounterColumns("log_cache_evictions",
+                      "log files or classes flushed from the log cache",
+                      offsets, Counter::log_cache_evictions);
     // NOTE: The NEB queues accepted connections, so we never have overflows
     // here. Nevertheless, we provide these columns for consistency with CMC,
     // always returning zero.
@@ -0,0 +1,98 @@
+// Copyright (C) 2019 tribe29 GmbH - License: GNU General Public License v2
+// This file is part of Checkmk (https://checkmk.com). It is subject to the
+// terms and conditions defined in the file COPYING, which is part of this
+// source code package.
+
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+namespace {
+// The state of a single run() call, shared with the helping workers. Every
+// participant claims task numbers until there are none left, so it doesn't
+// matter how many workers actually join in.
+struct Batch {
+    Batch(size_t n, const std::function<void(size_t)> &task)
+        : _n(n), _task(task) {}
+
+    void work() {
+        for (auto i = _next++; i < _n; i = _next++) {
+            try {
+                _task(i);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(_mutex);
+                if (!_exception) {
+                    _exception = std::current_exception();
+                }
+            }
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (++_done == _n) {
+                _all_done.notify_all();
+            }
+        }
+    }
+
+    void wait() {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _all_done.wait(lock, [&] { return _done == _n; });
+        if (_exception) {
+            std::rethrow_exception(_exception);
+        }
+    }
+
+private:
+    const size_t _n;
+    const std::function<void(size_t)> &_task;
+    std::atomic<size_t> _next{0};
+    std::mutex _mutex;
+    std::condition_variable _all_done;
+    size_t _done{0};
+    std::exception_ptr _exception;
+};
+}  // namespace
+
+ThreadPool::ThreadPool(size_t num_threads) {
+    for (size_t i = 0; i < num_threads; ++i) {
+        _threads.emplace_back([this] {
+            while (auto job = _queue.pop()) {
+                (*job)();
+            }
+        });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    _queue.join();
+    for (auto &thread : _threads) {
+        thread.join();
+    }
+}
+
+void ThreadPool::run(size_t n, const std::function<void(size_t)> &task) {
+    auto batch = std::make_shared<Batch>(n, task);
+    // We work on the batch ourselves, so one helper less is enough.
+    auto helpers = std::min(size(), n == 0 ? 0 : n - 1);
+    for (size_t i = 0; i < helpers; ++i) {
+        (void)_queue.push([batch] { batch->work(); },
+                          queue_overflow_strategy::wait);
+    }
+    batch->work();
+    batch->wait();
+}
+
+void ThreadPool::post(std::function<void()> job) {
+    (void)_queue.push(
+        [job = std::move(job)] {
+            try {
+                job();
+            } catch (...) {
+            }
+        },
+        queue_overflow_strategy::wait);
+}
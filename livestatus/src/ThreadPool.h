@@ -0,0 +1,45 @@
+// Copyright (C) 2019 tribe29 GmbH - License: GNU General Public License v2
+// This file is part of Checkmk (https://checkmk.com). It is subject to the
+// terms and conditions defined in the file COPYING, which is part of this
+// source code package.
+
+#ifndef ThreadPool_h
+#define ThreadPool_h
+
+#include "config.h"  // IWYU pragma: keep
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#include "Queue.h"
+
+/// A fixed set of worker threads for splitting up a single piece of work or
+/// doing some work in the background.
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t num_threads);
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+    ~ThreadPool();
+
+    [[nodiscard]] size_t size() const { return _threads.size(); }
+
+    /// Calls task(0), ..., task(n - 1) on the workers and the calling thread,
+    /// returning when all calls are done. The first exception thrown by a
+    /// task is rethrown here.
+    void run(size_t n, const std::function<void(size_t)> &task);
+
+    /// Queues a job for the workers without waiting for it. Exceptions
+    /// thrown by the job are silently dropped, and so are jobs which are
+    /// still queued when the pool is destroyed.
+    void post(std::function<void()> job);
+
+private:
+    Queue<std::deque<std::function<void()>>> _queue;
+    std::vector<std::thread> _threads;
+};
+
+#endif  // ThreadPool_h
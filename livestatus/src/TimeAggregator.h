@@ -27,6 +27,11 @@ public:
             _column->getValue(row, timezone_offset)));
     }
 
+    void merge(const Aggregator &other) override {
+        _aggregation->merge(
+            *static_cast<const TimeAggregator &>(other)._aggregation);
+    }
+
     void output(RowRenderer &r) const override {
         r.output(_aggregation->value());
     }
@@ -6,6 +6,7 @@
 #include "TimeColumn.h"
 
 #include <chrono>
+#include <ctime>
 
 #include "Aggregator.h"
 #include "Filter.h"
@@ -19,6 +20,15 @@ void TimeColumn::output(Row row, RowRenderer &r, const contact * /*auth_user*/,
     r.output(getValue(row, timezone_offset));
 }
 
+bool TimeColumn::appendGroupKey(Row row, std::string &key,
+                                const contact * /*auth_user*/,
+                                std::chrono::seconds timezone_offset) const {
+    auto value =
+        std::chrono::system_clock::to_time_t(getValue(row, timezone_offset));
+    key.append(reinterpret_cast<const char *>(&value), sizeof(value));
+    return true;
+}
+
 std::unique_ptr<Filter> TimeColumn::createFilter(
     Filter::Kind kind, RelationalOperator relOp,
     const std::string &value) const {
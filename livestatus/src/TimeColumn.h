@@ -29,6 +29,9 @@ public:
     void output(Row row, RowRenderer &r, const contact *auth_user,
                 std::chrono::seconds timezone_offset) const override;
 
+    bool appendGroupKey(Row row, std::string &key, const contact *auth_user,
+                        std::chrono::seconds timezone_offset) const override;
+
     [[nodiscard]] std::unique_ptr<Filter> createFilter(
         Filter::Kind kind, RelationalOperator relOp,
         const std::string &value) const override;
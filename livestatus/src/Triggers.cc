@@ -39,6 +39,7 @@ Triggers::Kind Triggers::find(const std::string &name) {
 }
 
 void Triggers::notify_all(Kind trigger) {
+    ++_generation;
     condition_variable_for(Kind::all).notify_all();
     condition_variable_for(trigger).notify_all();
 }
@@ -8,8 +8,10 @@
 
 #include "config.h"  // IWYU pragma: keep
 
+#include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <cstdint>
 #include <mutex>
 #include <string>
 
@@ -30,6 +32,10 @@ public:
 
     void notify_all(Kind trigger);
 
+    // Increased by every notify_all(), so cached query results can tell if
+    // anything might have changed since they have been computed.
+    [[nodiscard]] uint64_t generation() const { return _generation; }
+
     template <class Rep, class Period, class Predicate>
     void wait_for(Kind trigger,
                   const std::chrono::duration<Rep, Period> &rel_time,
@@ -45,6 +51,7 @@ public:
 
 private:
     std::mutex _mutex;
+    std::atomic<uint64_t> _generation{0};
     std::condition_variable _cond_all;
     std::condition_variable _cond_check;
     std::condition_variable _cond_state;
@@ -5,9 +5,16 @@
 
 #include "auth.h"
 
+#include <mutex>
+#include <utility>
+
 #include "MonitoringCore.h"
+#include "Store.h"
 #include "contact_fwd.h"
 
+extern host *host_list;
+extern service *service_list;
+
 contact *unknown_auth_user() { return reinterpret_cast<contact *>(0xdeadbeaf); }
 
 namespace {
@@ -33,9 +40,14 @@ bool service_has_contact(MonitoringCore *mc, const host *hst,
 
 bool is_authorized_for(MonitoringCore *mc, const contact *ctc, const host *hst,
                        const service *svc) {
-    return ctc != unknown_auth_user() &&
-           (svc == nullptr ? host_has_contact(hst, ctc)
-                           : service_has_contact(mc, hst, svc, ctc));
+    if (ctc == unknown_auth_user()) {
+        return false;
+    }
+    if (auto *store = mc->impl<Store>()) {
+        return store->_authorization_cache.isAuthorized(ctc, hst, svc);
+    }
+    return svc == nullptr ? host_has_contact(hst, ctc)
+                          : service_has_contact(mc, hst, svc, ctc);
 }
 
 bool is_authorized_for_host_group(MonitoringCore *mc, const hostgroup *hg,
@@ -103,3 +115,82 @@ bool is_authorized_for_service_group(MonitoringCore *mc, const servicegroup *sg,
     }
     return true;
 }
+
+bool AuthorizationCache::isAuthorized(const contact *ctc, const host *hst,
+                                      const service *svc) {
+    auto config_change = _mc->last_config_change();
+    std::shared_ptr<const Positions> positions;
+    {
+        std::shared_lock<std::shared_mutex> lock(_mutex);
+        if (_positions && _positions->config_change == config_change) {
+            auto it = _permissions.find(ctc);
+            if (it != _permissions.end()) {
+                return lookup(*_positions, *it->second, ctc, hst, svc);
+            }
+            positions = _positions;
+        }
+    }
+    // Computing the permissions takes a while, so we do it without blocking
+    // other readers. Concurrent requests for a new contact may compute its
+    // permissions more than once, but only the first result is kept.
+    if (!positions) {
+        positions = computePositions(config_change);
+    }
+    auto permissions = computePermissions(*positions, ctc);
+    auto result = lookup(*positions, *permissions, ctc, hst, svc);
+    std::unique_lock<std::shared_mutex> lock(_mutex);
+    if (!_positions || _positions->config_change != config_change) {
+        _positions = positions;
+        _permissions.clear();
+    }
+    if (_positions == positions) {
+        _permissions.emplace(ctc, std::move(permissions));
+    }
+    return result;
+}
+
+bool AuthorizationCache::lookup(const Positions &positions,
+                                const Permissions &permissions,
+                                const contact *ctc, const host *hst,
+                                const service *svc) const {
+    if (svc == nullptr) {
+        auto pos = positions.hosts.find(hst);
+        return pos == positions.hosts.end() ? host_has_contact(hst, ctc)
+                                            : permissions.hosts[pos->second];
+    }
+    auto pos = positions.services.find(svc);
+    return pos == positions.services.end()
+               ? service_has_contact(_mc, hst, svc, ctc)
+               : permissions.services[pos->second];
+}
+
+std::unique_ptr<const AuthorizationCache::Permissions>
+AuthorizationCache::computePermissions(const Positions &positions,
+                                       const contact *ctc) const {
+    auto permissions = std::make_unique<Permissions>();
+    permissions->hosts.resize(positions.hosts.size());
+    for (const auto &[hst, pos] : positions.hosts) {
+        permissions->hosts[pos] = host_has_contact(hst, ctc);
+    }
+    permissions->services.resize(positions.services.size());
+    for (const auto &[svc, pos] : positions.services) {
+        permissions->services[pos] =
+            service_has_contact(_mc, svc->host_ptr, svc, ctc);
+    }
+    return permissions;
+}
+
+// static
+std::shared_ptr<const AuthorizationCache::Positions>
+AuthorizationCache::computePositions(
+    std::chrono::system_clock::time_point config_change) {
+    auto positions = std::make_shared<Positions>();
+    positions->config_change = config_change;
+    for (const auto *hst = host_list; hst != nullptr; hst = hst->next) {
+        positions->hosts.emplace(hst, positions->hosts.size());
+    }
+    for (const auto *svc = service_list; svc != nullptr; svc = svc->next) {
+        positions->services.emplace(svc, positions->services.size());
+    }
+    return positions;
+}
@@ -11,6 +11,13 @@
 #ifdef CMC
 #include "contact_fwd.h"
 #else
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
 #include "nagios.h"
 #endif
 
@@ -29,6 +36,45 @@ bool is_authorized_for_host_group(MonitoringCore *mc, const hostgroup *hg,
                                   const contact *ctc);
 bool is_authorized_for_service_group(MonitoringCore *mc, const servicegroup *sg,
                                      const contact *ctc);
+
+/// Remembers for each contact which hosts and services it is a contact for,
+/// using a dense bitset over the positions of the objects in host_list and
+/// service_list. The bitset for a contact is computed on first use, everything
+/// is thrown away when the configuration changes.
+class AuthorizationCache {
+public:
+    explicit AuthorizationCache(MonitoringCore *mc) : _mc(mc) {}
+    bool isAuthorized(const contact *ctc, const host *hst, const service *svc);
+
+private:
+    struct Positions {
+        std::chrono::system_clock::time_point config_change;
+        std::unordered_map<const host *, size_t> hosts;
+        std::unordered_map<const service *, size_t> services;
+    };
+
+    struct Permissions {
+        std::vector<bool> hosts;
+        std::vector<bool> services;
+    };
+
+    MonitoringCore *const _mc;
+    std::shared_mutex _mutex;
+    // Never modified once shared, so the permissions can be computed from it
+    // without holding the lock.
+    std::shared_ptr<const Positions> _positions;
+    std::unordered_map<const contact *, std::unique_ptr<const Permissions>>
+        _permissions;
+
+    [[nodiscard]] bool lookup(const Positions &positions,
+                              const Permissions &permissions,
+                              const contact *ctc, const host *hst,
+                              const service *svc) const;
+    [[nodiscard]] std::unique_ptr<const Permissions> computePermissions(
+        const Positions &positions, const contact *ctc) const;
+    static std::shared_ptr<const Positions> computePositions(
+        std::chrono::system_clock::time_point config_change);
+};
 #endif
 
 #endif  // auth_h
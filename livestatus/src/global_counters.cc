@@ -10,7 +10,7 @@
 #include <vector>
 
 namespace {
-constexpr int num_counters = 10;
+constexpr int num_counters = 13;
 
 struct CounterInfo {
     std::mutex mutex;
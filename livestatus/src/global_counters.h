@@ -20,7 +20,10 @@ enum class Counter {
     log_messages,
     commands,
     livechecks,
-    overflows
+    overflows,
+    log_cache_hits,
+    log_cache_misses,
+    log_cache_evictions
 };
 
 // TODO(sp): We really need an OO version of this. :-P
@@ -14,16 +14,20 @@
 
 #include <fcntl.h>
 #include <pthread.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
 #include <sys/socket.h>
 #include <sys/stat.h>
 #include <sys/un.h>
 #include <unistd.h>
 
 #include <algorithm>
+#include <array>
 #include <atomic>
 #include <cerrno>
 #include <chrono>
 #include <cstddef>
+#include <cstdint>
 #include <cstdlib>
 #include <cstring>
 #include <deque>
@@ -32,6 +36,8 @@
 #include <optional>
 #include <sstream>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "Average.h"
@@ -43,6 +49,7 @@
 #include "Poller.h"
 #include "Queue.h"
 #include "RegExp.h"
+#include "ThreadPool.h"
 #include "TimeperiodsCache.h"
 #include "Triggers.h"
 #include "auth.h"
@@ -101,10 +108,15 @@ Encoding fl_data_encoding{Encoding::utf8};
 
 static Logger *fl_logger_nagios = nullptr;
 static LogLevel fl_livestatus_log_level = LogLevel::notice;
-using ClientQueue_t = Queue<std::deque<int>>;
-static ClientQueue_t *fl_client_queue = nullptr;
 TimeperiodsCache *g_timeperiods_cache = nullptr;
 
+// Workers for scanning large tables in parallel and for prefetching logfiles,
+// null if disabled. Note that a parallel scan sends nothing before all of its
+// chunks are done, so even with "ResponseHeader: chunked16" the client gets
+// the first bytes of a large response later than with a sequential scan.
+static size_t fl_num_scan_threads = 0;
+ThreadPool *g_scan_pool = nullptr;
+
 /* simple statistics data for TableStatus */
 extern host *host_list;
 extern service *service_list;
@@ -118,6 +130,74 @@ Average g_avg_livestatus_usage;
 
 static NagiosCore *fl_core = nullptr;
 
+namespace {
+// A client connection together with its request buffer. Idle keep-alive
+// connections are owned by the main thread, which watches them via epoll, and
+// a connection is only handed over to a client thread when a complete request
+// is waiting in its buffer.
+class ClientConnection {
+public:
+    explicit ClientConnection(int fd)
+        : _fd(fd)
+        , _input_buffer(fd, fl_should_terminate, fl_core->loggerLivestatus(),
+                        fl_query_timeout, fl_idle_timeout)
+        , _idle_since(std::chrono::system_clock::now()) {}
+    ClientConnection(const ClientConnection &) = delete;
+    ClientConnection &operator=(const ClientConnection &) = delete;
+    ClientConnection(ClientConnection &&) = delete;
+    ClientConnection &operator=(ClientConnection &&) = delete;
+    ~ClientConnection() { close(_fd); }
+
+    [[nodiscard]] int fd() const { return _fd; }
+    InputBuffer &inputBuffer() { return _input_buffer; }
+
+    void startIdling() {
+        _idle_since = std::chrono::system_clock::now();
+        _query_started = std::nullopt;
+    }
+
+    void queryDataArrived() {
+        if (!_query_started) {
+            _query_started = std::chrono::system_clock::now();
+        }
+    }
+
+    [[nodiscard]] bool timedOut(std::chrono::system_clock::time_point now,
+                                Logger *logger) const {
+        if (_query_started) {
+            if (fl_query_timeout != 0ms &&
+                now - *_query_started >= fl_query_timeout) {
+                Informational(logger)
+                    << "Timeout of " << fl_query_timeout.count()
+                    << " ms exceeded while reading query";
+                return true;
+            }
+        } else if (fl_idle_timeout != 0ms &&
+                   now - _idle_since >= fl_idle_timeout) {
+            Informational(logger)
+                << "Idle timeout of " << fl_idle_timeout.count()
+                << " ms exceeded. Going to close connection.";
+            return true;
+        }
+        return false;
+    }
+
+private:
+    int _fd;
+    InputBuffer _input_buffer;
+    std::chrono::system_clock::time_point _idle_since;
+    std::optional<std::chrono::system_clock::time_point> _query_started;
+};
+}  // namespace
+
+// connections with a complete request, waiting for a client thread
+using ClientQueue_t = Queue<std::deque<std::unique_ptr<ClientConnection>>>;
+static ClientQueue_t *fl_client_queue = nullptr;
+// keep-alive connections handed back from the client threads to the main
+// thread, signalled via fl_reactor_wakeup_fd
+static ClientQueue_t *fl_idle_queue = nullptr;
+static int fl_reactor_wakeup_fd = -1;
+
 namespace {
 void update_status() {
     bool any_event_handler_enabled{false};
@@ -187,45 +267,211 @@ void livestatus_cleanup_after_fork() {
     }
 }
 
-void *main_thread(void *data) {
-    tl_info = static_cast<ThreadInfo *>(data);
-    auto *logger = fl_core->loggerLivestatus();
-    auto last_update_status = std::chrono::system_clock::now();
-    while (!fl_should_terminate) {
-        do_statistics();
-        auto now = std::chrono::system_clock::now();
-        if (now - last_update_status >= 5s) {
-            update_status();
-            last_update_status = now;
+namespace {
+void enqueue_client_connection(std::unique_ptr<ClientConnection> connection,
+                               Logger *logger) {
+    switch (fl_client_queue->push(std::move(connection),
+                                  queue_overflow_strategy::pop_oldest)) {
+        case queue_status::overflow:
+        case queue_status::joinable: {
+            generic_error ge("cannot enqueue client socket");
+            Warning(logger) << ge;
+            break;
         }
-        if (!Poller{}.wait(2500ms, g_unix_socket, PollEvents::in, logger)) {
-            if (errno == ETIMEDOUT) {
-                continue;
-            }
+        case queue_status::ok:
             break;
+    }
+    g_num_queued_connections++;
+}
+
+// The main thread multiplexes the listening socket and all idle keep-alive
+// connections with a single epoll instance, so that an idle client does not
+// tie up one of the client threads.
+class Reactor {
+public:
+    explicit Reactor(Logger *logger)
+        : _logger(logger), _epoll_fd(epoll_create1(EPOLL_CLOEXEC)) {
+        if (_epoll_fd == -1) {
+            generic_error ge("cannot create epoll instance");
+            Alert(_logger) << ge;
+            return;
         }
+        watch(g_unix_socket);
+        watch(fl_reactor_wakeup_fd);
+    }
+    Reactor(const Reactor &) = delete;
+    Reactor &operator=(const Reactor &) = delete;
+    Reactor(Reactor &&) = delete;
+    Reactor &operator=(Reactor &&) = delete;
+    ~Reactor() {
+        if (_epoll_fd != -1) {
+            close(_epoll_fd);
+        }
+    }
+
+    [[nodiscard]] bool ok() const { return _epoll_fd != -1; }
+
+    // Returns false on a fatal error.
+    template <typename Rep, typename Period>
+    bool runOnce(std::chrono::duration<Rep, Period> timeout) {
+        std::array<epoll_event, 64> events{};
+        int n = 0;
+        do {
+            n = epoll_wait(
+                _epoll_fd, events.data(), static_cast<int>(events.size()),
+                static_cast<int>(
+                    std::chrono::duration_cast<std::chrono::milliseconds>(
+                        timeout)
+                        .count()));
+        } while (n == -1 && errno == EINTR);
+        if (n == -1) {
+            generic_error ge("epoll_wait failed");
+            Error(_logger) << ge;
+            return false;
+        }
+        for (int i = 0; i < n; i++) {
+            int fd = events[i].data.fd;  // NOLINT
+            if (fd == g_unix_socket) {
+                acceptConnection();
+            } else if (fd == fl_reactor_wakeup_fd) {
+                takeBackIdleConnections();
+            } else {
+                readFrom(fd);
+            }
+        }
+        closeTimedOutConnections();
+        return true;
+    }
+
+private:
+    Logger *_logger;
+    int _epoll_fd;
+    std::unordered_map<int, std::unique_ptr<ClientConnection>> _idle;
+    std::chrono::system_clock::time_point _last_timeout_check;
+
+    void watch(int fd) const {
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.fd = fd;  // NOLINT
+        if (epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, fd, &ev) == -1) {
+            generic_error ge("cannot watch file descriptor " +
+                             std::to_string(fd));
+            Warning(_logger) << ge;
+        }
+    }
+
+    void unwatch(int fd) const {
+        epoll_ctl(_epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+    }
+
+    void acceptConnection() {
         int cc = accept4(g_unix_socket, nullptr, nullptr, SOCK_CLOEXEC);
         if (cc == -1) {
             generic_error ge("cannot accept client connection");
-            Warning(logger) << ge;
-            continue;
+            Warning(_logger) << ge;
+            return;
         }
         if (cc > g_max_fd_ever) {
             g_max_fd_ever = cc;
         }
-        switch (
-            fl_client_queue->push(cc, queue_overflow_strategy::pop_oldest)) {
-            case queue_status::overflow:
-            case queue_status::joinable: {
-                generic_error ge("cannot enqueue client socket");
-                Warning(logger) << ge;
+        counterIncrement(Counter::connections);
+        Debug(_logger) << "accepted client connection on fd " << cc;
+        makeIdle(std::make_unique<ClientConnection>(cc));
+    }
+
+    void takeBackIdleConnections() {
+        uint64_t count = 0;
+        if (read(fl_reactor_wakeup_fd, &count, sizeof(count)) == -1 &&
+            errno != EAGAIN) {
+            generic_error ge("cannot read from wakeup file descriptor");
+            Warning(_logger) << ge;
+        }
+        while (auto connection = fl_idle_queue->try_pop()) {
+            makeIdle(std::move(*connection));
+        }
+    }
+
+    void makeIdle(std::unique_ptr<ClientConnection> connection) {
+        connection->startIdling();
+        if (connection->inputBuffer().hasCompleteRequest()) {
+            enqueue_client_connection(std::move(connection), _logger);
+            return;
+        }
+        if (connection->inputBuffer().hasBufferedData()) {
+            connection->queryDataArrived();
+        }
+        int fd = connection->fd();
+        watch(fd);
+        _idle[fd] = std::move(connection);
+    }
+
+    void readFrom(int fd) {
+        auto it = _idle.find(fd);
+        if (it == _idle.end()) {
+            unwatch(fd);
+            return;
+        }
+        auto &input_buffer = it->second->inputBuffer();
+        switch (input_buffer.readAvailableData()) {
+            case InputBuffer::Result::data_read:
+                if (!input_buffer.hasCompleteRequest()) {
+                    if (input_buffer.hasBufferedData()) {
+                        it->second->queryDataArrived();
+                    }
+                    return;
+                }
                 break;
-            }
-            case queue_status::ok:
+            case InputBuffer::Result::eof:
+                if (!input_buffer.hasBufferedData()) {
+                    unwatch(fd);
+                    _idle.erase(it);
+                    return;
+                }
+                // Let a client thread report a possibly incomplete request.
+                break;
+            default:
+                // line_too_long: the client thread reports the error.
                 break;
         }
-        g_num_queued_connections++;
-        counterIncrement(Counter::connections);
+        unwatch(fd);
+        auto connection = std::move(it->second);
+        _idle.erase(it);
+        enqueue_client_connection(std::move(connection), _logger);
+    }
+
+    void closeTimedOutConnections() {
+        auto now = std::chrono::system_clock::now();
+        if (now - _last_timeout_check < 1s) {
+            return;
+        }
+        _last_timeout_check = now;
+        for (auto it = _idle.begin(); it != _idle.end();) {
+            if (it->second->timedOut(now, _logger)) {
+                unwatch(it->first);
+                it = _idle.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+};
+}  // namespace
+
+void *main_thread(void *data) {
+    tl_info = static_cast<ThreadInfo *>(data);
+    auto *logger = fl_core->loggerLivestatus();
+    auto last_update_status = std::chrono::system_clock::now();
+    Reactor reactor{logger};
+    while (!fl_should_terminate && reactor.ok()) {
+        do_statistics();
+        auto now = std::chrono::system_clock::now();
+        if (now - last_update_status >= 5s) {
+            update_status();
+            last_update_status = now;
+        }
+        if (!reactor.runOnce(2500ms)) {
+            break;
+        }
     }
     Notice(logger) << "socket thread has terminated";
     return voidp;
@@ -235,26 +481,41 @@ void *client_thread(void *data) {
     tl_info = static_cast<ThreadInfo *>(data);
     auto *logger = fl_core->loggerLivestatus();
     while (!fl_should_terminate) {
-        g_num_queued_connections--;
-        g_livestatus_active_connections++;
-        if (auto cc = fl_client_queue->pop()) {
-            Debug(logger) << "accepted client connection on fd " << *cc;
-            InputBuffer input_buffer(*cc, fl_should_terminate, logger,
-                                     fl_query_timeout, fl_idle_timeout);
+        if (auto connection = fl_client_queue->pop()) {
+            g_num_queued_connections--;
+            g_livestatus_active_connections++;
+            auto &input_buffer = (*connection)->inputBuffer();
             bool keepalive = true;
             unsigned requestnr = 0;
+            // Answer all requests which are already buffered, waiting for
+            // further ones is the job of the main thread.
             while (keepalive && !fl_should_terminate) {
                 if (++requestnr > 1) {
                     Debug(logger) << "handling request " << requestnr
                                   << " on same connection";
                 }
                 counterIncrement(Counter::requests);
-                OutputBuffer output_buffer(*cc, fl_should_terminate, logger);
-                keepalive = fl_core->answerRequest(input_buffer, output_buffer);
+                OutputBuffer output_buffer((*connection)->fd(),
+                                           fl_should_terminate, logger);
+                keepalive =
+                    fl_core->answerRequest(input_buffer, output_buffer) &&
+                    !output_buffer.writeFailed();
+                if (!input_buffer.hasCompleteRequest()) {
+                    break;
+                }
+            }
+            if (keepalive && !fl_should_terminate &&
+                fl_idle_queue->push(std::move(*connection),
+                                    queue_overflow_strategy::wait) ==
+                    queue_status::ok) {
+                uint64_t one = 1;
+                if (write(fl_reactor_wakeup_fd, &one, sizeof(one)) == -1) {
+                    generic_error ge("cannot wake up main thread");
+                    Warning(logger) << ge;
+                }
             }
-            close(*cc);
+            g_livestatus_active_connections--;
         }
-        g_livestatus_active_connections--;
     }
     return voidp;
 }
@@ -291,7 +552,8 @@ private:
     class LivestatusFormatter : public Formatter {
         void format(std::ostream &os, const LogRecord &record) override {
             os << FormattedTimePoint(record.getTimePoint()) << " ["
-               << tl_info->name << "] " << record.getMessage();
+               << (tl_info == nullptr ? "scan worker" : tl_info->name)
+               << "] " << record.getMessage();
         }
     };
 };
@@ -320,6 +582,12 @@ void start_threads() {
     pthread_atfork(livestatus_count_fork, nullptr,
                    livestatus_cleanup_after_fork);
 
+    fl_reactor_wakeup_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (fl_reactor_wakeup_fd == -1) {
+        generic_error ge("cannot create wakeup file descriptor");
+        Alert(fl_logger_nagios) << ge;
+    }
+
     pthread_attr_t attr;
     pthread_attr_init(&attr);
     size_t defsize = 0;
@@ -350,6 +618,12 @@ void start_threads() {
         }
     }
 
+    if (fl_num_scan_threads > 0) {
+        Informational(fl_logger_nagios)
+            << "starting " << fl_num_scan_threads << " scan threads";
+        g_scan_pool = new ThreadPool(fl_num_scan_threads);
+    }
+
     g_thread_running = 1;
     pthread_attr_destroy(&attr);
 }
@@ -362,8 +636,8 @@ void terminate_threads() {
         Informational(fl_logger_nagios)
             << "waiting for client threads to terminate...";
         fl_client_queue->join();
-        while (auto fd = fl_client_queue->try_pop()) {
-            close(*fd);
+        fl_idle_queue->join();
+        while (fl_client_queue->try_pop()) {
         }
         for (const auto &info : fl_thread_info) {
             if (pthread_join(info.id, nullptr) != 0) {
@@ -371,6 +645,13 @@ void terminate_threads() {
                     << "could not join thread " << info.name;
             }
         }
+        while (fl_idle_queue->try_pop()) {
+        }
+        // No client thread is using the scan threads anymore.
+        delete g_scan_pool;
+        g_scan_pool = nullptr;
+        close(fl_reactor_wakeup_fd);
+        fl_reactor_wakeup_fd = -1;
         Informational(fl_logger_nagios)
             << "main thread + " << g_livestatus_threads
             << " client threads have finished";
@@ -467,11 +748,17 @@ int broker_check(int event_type, void *data) {
         auto *c = static_cast<nebstruct_service_check_data *>(data);
         if (c->type == NEBTYPE_SERVICECHECK_PROCESSED) {
             counterIncrement(Counter::service_checks);
+            if (c->object_ptr != nullptr) {
+                fl_core->updateState(static_cast<service *>(c->object_ptr));
+            }
         }
     } else if (event_type == NEBCALLBACK_HOST_CHECK_DATA) {
         auto *c = static_cast<nebstruct_host_check_data *>(data);
         if (c->type == NEBTYPE_HOSTCHECK_PROCESSED) {
             counterIncrement(Counter::host_checks);
+            if (c->object_ptr != nullptr) {
+                fl_core->updateState(static_cast<host *>(c->object_ptr));
+            }
         }
     }
     fl_core->triggers().notify_all(Triggers::Kind::check);
@@ -523,8 +810,15 @@ int broker_command(int event_type __attribute__((__unused__)), void *data) {
     return 0;
 }
 
-int broker_state(int event_type __attribute__((__unused__)),
-                 void *data __attribute__((__unused__))) {
+int broker_state(int event_type __attribute__((__unused__)), void *data) {
+    auto *sc = static_cast<nebstruct_statechange_data *>(data);
+    if (sc->type == NEBTYPE_STATECHANGE_END && sc->object_ptr != nullptr) {
+        if (sc->statechange_type == SERVICE_STATECHANGE) {
+            fl_core->updateState(static_cast<service *>(sc->object_ptr));
+        } else if (sc->statechange_type == HOST_STATECHANGE) {
+            fl_core->updateState(static_cast<host *>(sc->object_ptr));
+        }
+    }
     counterIncrement(Counter::neb_callbacks);
     fl_core->triggers().notify_all(Triggers::Kind::state);
     return 0;
@@ -580,10 +874,14 @@ int broker_process(int event_type __attribute__((__unused__)), void *data) {
             fl_core = new NagiosCore(fl_paths, fl_limits, fl_authorization,
                                      fl_data_encoding);
             fl_client_queue = new ClientQueue_t{};
+            fl_idle_queue = new ClientQueue_t{};
             g_timeperiods_cache = new TimeperiodsCache(fl_logger_nagios);
             break;
         case NEBTYPE_PROCESS_EVENTLOOPSTART:
             g_timeperiods_cache->update(from_timeval(ps->timestamp));
+            // The retention data has been read in the meantime, without any
+            // broker callbacks for the changed states.
+            fl_core->updateStates();
             start_threads();
             break;
         default:
@@ -672,15 +970,15 @@ void register_callbacks() {
     neb_register_callback(NEBCALLBACK_DOWNTIME_DATA, g_nagios_handle, 0,
                           broker_downtime);  // dynamic data
     neb_register_callback(NEBCALLBACK_SERVICE_CHECK_DATA, g_nagios_handle, 0,
-                          broker_check);  // only for statistics
+                          broker_check);  // statistics and state index
     neb_register_callback(NEBCALLBACK_HOST_CHECK_DATA, g_nagios_handle, 0,
-                          broker_check);  // only for statistics
+                          broker_check);  // statistics and state index
     neb_register_callback(NEBCALLBACK_LOG_DATA, g_nagios_handle, 0,
                           broker_log);  // only for trigger 'log'
     neb_register_callback(NEBCALLBACK_EXTERNAL_COMMAND_DATA, g_nagios_handle, 0,
                           broker_command);  // only for trigger 'command'
     neb_register_callback(NEBCALLBACK_STATE_CHANGE_DATA, g_nagios_handle, 0,
-                          broker_state);  // only for trigger 'state'
+                          broker_state);  // trigger 'state' and state index
     neb_register_callback(NEBCALLBACK_ADAPTIVE_PROGRAM_DATA, g_nagios_handle, 0,
                           broker_program);  // only for trigger 'program'
     neb_register_callback(NEBCALLBACK_PROCESS_DATA, g_nagios_handle, 0,
@@ -766,6 +1064,11 @@ void livestatus_parse_arguments(Logger *logger, const char *args_orig) {
                 Notice(logger)
                     << "setting max number of cached log messages to "
                     << fl_limits._max_cached_messages;
+            } else if (left == "max_cached_log_bytes") {
+                fl_limits._max_cached_log_bytes =
+                    strtoul(right.c_str(), nullptr, 10);
+                Notice(logger) << "setting max size of cached log messages to "
+                               << fl_limits._max_cached_log_bytes << " bytes";
             } else if (left == "max_lines_per_logfile") {
                 fl_limits._max_lines_per_logfile =
                     strtoul(right.c_str(), nullptr, 10);
@@ -783,6 +1086,11 @@ void livestatus_parse_arguments(Logger *logger, const char *args_orig) {
                     << fl_limits._max_response_size << " bytes ("
                     << (fl_limits._max_response_size / (1024.0 * 1024.0))
                     << " MB)";
+            } else if (left == "query_cache_size") {
+                fl_limits._query_cache_size =
+                    strtoul(right.c_str(), nullptr, 10);
+                Notice(logger) << "setting size of query cache to "
+                               << fl_limits._query_cache_size << " bytes";
             } else if (left == "num_client_threads") {
                 int c = atoi(right.c_str());
                 if (c <= 0 || c > 1000) {
@@ -793,6 +1101,15 @@ void livestatus_parse_arguments(Logger *logger, const char *args_orig) {
                         << "setting number of client threads to " << c;
                     g_livestatus_threads = c;
                 }
+            } else if (left == "num_scan_threads") {
+                int c = atoi(right.c_str());
+                if (c < 0 || c > 1000) {
+                    Warning(logger) << "cannot set num_scan_threads to " << c
+                                    << ", must be >= 0 and <= 1000";
+                } else {
+                    Notice(logger) << "setting number of scan threads to " << c;
+                    fl_num_scan_threads = c;
+                }
             } else if (left == "query_timeout") {
                 int c = atoi(right.c_str());
                 if (c < 0) {
@@ -968,6 +1285,9 @@ extern "C" int nebmodule_deinit(int flags __attribute__((__unused__)),
     delete fl_client_queue;
     fl_client_queue = nullptr;
 
+    delete fl_idle_queue;
+    fl_idle_queue = nullptr;
+
     delete fl_core;
     fl_core = nullptr;
 
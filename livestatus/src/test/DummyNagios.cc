@@ -33,10 +33,6 @@ service *find_service(char * /*unused*/, char * /*unused*/) { return nullptr; }
 servicegroup *find_servicegroup(char * /*unused*/) { return nullptr; }
 time_t get_next_log_rotation_time(void) { return 0; }
 char *get_program_version(void) { return nullptr; }
-int is_contact_for_host(host * /*unused*/, contact * /*unused*/) { return 0; }
-int is_contact_for_service(service * /*unused*/, contact * /*unused*/) {
-    return 0;
-}
 int is_contact_member_of_contactgroup(contactgroup * /*unused*/,
                                       contact * /*unused*/) {
     return 0;
@@ -91,7 +87,7 @@ hostgroup *hostgroup_list;
 host *host_list;
 int interval_length;
 char *log_archive_path;
-char log_file[256];
+char *log_file;
 int log_initial_states;
 char *macro_user[256];
 int nagios_pid;
@@ -0,0 +1,112 @@
+// Copyright (C) 2019 tribe29 GmbH - License: GNU General Public License v2
+// This file is part of Checkmk (https://checkmk.com). It is subject to the
+// terms and conditions defined in the file COPYING, which is part of this
+// source code package.
+
+#include <ctime>
+#include <vector>
+
+#include "NagiosCore.h"
+#include "auth.h"
+#include "data_encoding.h"
+#include "gtest/gtest.h"
+#include "nagios.h"
+#include "test_utilities.h"
+
+extern host *host_list;
+extern service *service_list;
+extern time_t program_start;
+
+namespace {
+// A core without a store, so is_authorized_for() doesn't use the cache.
+class UncachedCore : public NagiosCore {
+public:
+    explicit UncachedCore(NagiosAuthorization authorization)
+        : NagiosCore(NagiosPaths{}, NagiosLimits{}, authorization,
+                     Encoding::utf8) {}
+
+private:
+    [[nodiscard]] void *implInternal() const override { return nullptr; }
+};
+
+class AuthorizationCacheTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        host1.next = &host2;
+        host_list = &host1;
+        service1.next = &service2;
+        service_list = &service1;
+        program_start = 1;
+        host1.contacts = &contacts1;
+        service2.contacts = &contacts2;
+    }
+
+    void TearDown() override {
+        host_list = nullptr;
+        service_list = nullptr;
+    }
+
+    // Compares the cached answers with the ones computed from scratch for
+    // all contacts and objects, including ones unknown to the cache.
+    void expectSameAnswers(AuthorizationCache &cache,
+                           NagiosAuthorization authorization) {
+        UncachedCore uncached{authorization};
+        for (const auto *ctc : {&contact1, &contact2}) {
+            for (const auto *hst : {&host1, &host2, &host3}) {
+                EXPECT_EQ(is_authorized_for(&uncached, ctc, hst, nullptr),
+                          cache.isAuthorized(ctc, hst, nullptr));
+            }
+            for (const auto *svc : {&service1, &service2, &service3}) {
+                EXPECT_EQ(is_authorized_for(&uncached, ctc, svc->host_ptr, svc),
+                          cache.isAuthorized(ctc, svc->host_ptr, svc));
+            }
+        }
+    }
+
+    contact contact1{};
+    contact contact2{};
+    contactsmember contacts1{nullptr, &contact1, nullptr};
+    contactsmember contacts2{nullptr, &contact2, nullptr};
+    TestHost host1{{}};
+    TestHost host2{{}};
+    TestHost host3{{}};  // not in host_list
+    TestService service1{&host1, {}};
+    TestService service2{&host2, {}};
+    TestService service3{&host1, {}};  // not in service_list
+};
+}  // namespace
+
+TEST_F(AuthorizationCacheTest, LooseServiceAuthorization) {
+    NagiosAuthorization authorization{AuthorizationKind::loose,
+                                      AuthorizationKind::strict};
+    NagiosCore core{NagiosPaths{}, NagiosLimits{}, authorization,
+                    Encoding::utf8};
+    AuthorizationCache cache{&core};
+    EXPECT_TRUE(cache.isAuthorized(&contact1, &host1, &service1));
+    expectSameAnswers(cache, authorization);
+}
+
+TEST_F(AuthorizationCacheTest, StrictServiceAuthorization) {
+    NagiosAuthorization authorization{AuthorizationKind::strict,
+                                      AuthorizationKind::strict};
+    NagiosCore core{NagiosPaths{}, NagiosLimits{}, authorization,
+                    Encoding::utf8};
+    AuthorizationCache cache{&core};
+    EXPECT_FALSE(cache.isAuthorized(&contact1, &host1, &service1));
+    EXPECT_TRUE(cache.isAuthorized(&contact2, &host2, &service2));
+    expectSameAnswers(cache, authorization);
+}
+
+TEST_F(AuthorizationCacheTest, ForgetsEverythingWhenTheConfigChanges) {
+    NagiosCore core{NagiosPaths{}, NagiosLimits{}, NagiosAuthorization{},
+                    Encoding::utf8};
+    AuthorizationCache cache{&core};
+    EXPECT_FALSE(cache.isAuthorized(&contact2, &host2, nullptr));
+
+    // Nagios restarts for config changes, so they are only noticed then.
+    host2.contacts = &contacts2;
+    EXPECT_FALSE(cache.isAuthorized(&contact2, &host2, nullptr));
+    program_start = 2;
+    EXPECT_TRUE(cache.isAuthorized(&contact2, &host2, nullptr));
+    expectSameAnswers(cache, NagiosAuthorization{});
+}
@@ -116,3 +116,12 @@ TEST_F(CrashReportTableFixture, TestGetOneCrashReport) {
                                           uuid + "/" + crash_info + "\n",
                                       "Filter: id = " + uuid + "\n"}));
 }
+
+TEST_F(CrashReportTableFixture, TestStatsGroupedByComponent) {
+    ASSERT_TRUE(fs::exists(basepath));
+    EXPECT_EQ(component + ";1;0\n",
+              mk::test::query(table, {"Columns: component\n",
+                                      "Stats: id = " + uuid + "\n",
+                                      "Stats: id != " + uuid + "\n"}));
+    EXPECT_EQ("1\n", mk::test::query(table, {"Stats: id = " + uuid + "\n"}));
+}
@@ -0,0 +1,124 @@
+// Copyright (C) 2019 tribe29 GmbH - License: GNU General Public License v2
+// This file is part of Checkmk (https://checkmk.com). It is subject to the
+// terms and conditions defined in the file COPYING, which is part of this
+// source code package.
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "AndingFilter.h"
+#include "Column.h"
+#include "Filter.h"
+#include "FilterProgram.h"
+#include "IntFilter.h"
+#include "IntLambdaColumn.h"
+#include "OringFilter.h"
+#include "Row.h"
+#include "StringFilter.h"
+#include "StringLambdaColumn.h"
+#include "gtest/gtest.h"
+#include "opids.h"
+
+namespace {
+struct Thing {
+    int state;
+    std::string name;
+};
+
+class FilterProgramTest : public ::testing::Test {
+protected:
+    std::unique_ptr<Filter> state(RelationalOperator op, int value) const {
+        return std::make_unique<IntFilter>(Filter::Kind::row, state_column, op,
+                                           std::to_string(value));
+    }
+
+    std::unique_ptr<Filter> name(RelationalOperator op,
+                                 const std::string &value) const {
+        return std::make_unique<StringFilter>(Filter::Kind::row, name_column,
+                                              op, value);
+    }
+
+    static Filters filters(std::unique_ptr<Filter> a,
+                           std::unique_ptr<Filter> b) {
+        Filters result;
+        result.push_back(std::move(a));
+        result.push_back(std::move(b));
+        return result;
+    }
+
+    // The compiled program must agree with the filter tree on all things.
+    void check(const Filter &filter) const {
+        FilterProgram program{filter};
+        for (const auto &thing : things) {
+            EXPECT_EQ(filter.accepts(Row{&thing}, nullptr, {}),
+                      program.accepts(Row{&thing}, nullptr, {}))
+                << filter << "\nfor " << thing.name;
+        }
+    }
+
+    IntLambdaColumn<Thing> state_column{
+        "state", "The state", {}, [](const Thing &t) { return t.state; }};
+    StringLambdaColumn<Thing> name_column{
+        "name", "The name", {}, [](const Thing &t) { return t.name; }};
+    std::vector<Thing> things{
+        {0, "alpha"}, {1, "beta"}, {2, "gamma"}, {3, "Alpha"}, {2, ""}};
+};
+}  // namespace
+
+TEST_F(FilterProgramTest, EmptyProgramAcceptsEverything) {
+    Thing thing{0, "x"};
+    EXPECT_TRUE(FilterProgram{}.accepts(Row{&thing}, nullptr, {}));
+}
+
+TEST_F(FilterProgramTest, Tautology) {
+    check(*AndingFilter::make(Filter::Kind::row, {}));
+}
+
+TEST_F(FilterProgramTest, Contradiction) {
+    check(*OringFilter::make(Filter::Kind::row, {}));
+}
+
+TEST_F(FilterProgramTest, IntComparisons) {
+    for (auto op : {RelationalOperator::equal, RelationalOperator::not_equal,
+                    RelationalOperator::less, RelationalOperator::greater,
+                    RelationalOperator::less_or_equal,
+                    RelationalOperator::greater_or_equal,
+                    RelationalOperator::matches_icase}) {
+        check(*state(op, 2));
+    }
+}
+
+TEST_F(FilterProgramTest, StringComparisons) {
+    for (auto op :
+         {RelationalOperator::equal, RelationalOperator::not_equal,
+          RelationalOperator::equal_icase, RelationalOperator::not_equal_icase,
+          RelationalOperator::matches, RelationalOperator::doesnt_match,
+          RelationalOperator::matches_icase,
+          RelationalOperator::doesnt_match_icase, RelationalOperator::less,
+          RelationalOperator::greater, RelationalOperator::less_or_equal,
+          RelationalOperator::greater_or_equal}) {
+        check(*name(op, "alpha"));
+        check(*name(op, "^.a"));
+    }
+}
+
+TEST_F(FilterProgramTest, Junctions) {
+    auto problems = AndingFilter::make(
+        Filter::Kind::row,
+        filters(name(RelationalOperator::matches_icase, "a$"),
+                state(RelationalOperator::not_equal, 0)));
+    check(*problems);
+    check(*problems->negate());
+
+    auto nested = OringFilter::make(
+        Filter::Kind::row,
+        filters(std::move(problems),
+                AndingFilter::make(
+                    Filter::Kind::row,
+                    filters(state(RelationalOperator::greater, 1),
+                            name(RelationalOperator::equal, "")))));
+    check(*nested);
+    check(*nested->negate());
+}
@@ -0,0 +1,86 @@
+// Copyright (C) 2019 tribe29 GmbH - License: GNU General Public License v2
+// This file is part of Checkmk (https://checkmk.com). It is subject to the
+// terms and conditions defined in the file COPYING, which is part of this
+// source code package.
+
+#include <cstddef>
+#include <ctime>
+#include <string>
+#include <vector>
+
+#include "LogEntries.h"
+#include "LogEntry.h"
+#include "gtest/gtest.h"
+
+namespace {
+std::string alert(time_t t) {
+    return "[" + std::to_string(t) + "] HOST ALERT: h;DOWN;HARD;1;argh";
+}
+
+std::string command(time_t t) {
+    return "[" + std::to_string(t) + "] EXTERNAL COMMAND: FOO;bar";
+}
+
+LogEntry *add(LogEntries &entries, size_t lineno, const std::string &line) {
+    return entries.add(LogEntry::classify(line), lineno, line);
+}
+
+std::vector<size_t> linenos(const LogEntries &entries) {
+    std::vector<size_t> result;
+    for (const auto &item : entries) {
+        result.push_back(item.entry->_lineno);
+    }
+    return result;
+}
+
+constexpr unsigned bit(LogEntry::Class log_class) {
+    return 1U << static_cast<int>(log_class);
+}
+}  // namespace
+
+TEST(LogEntries, KeepsEntriesSorted) {
+    LogEntries entries;
+    // Alerts first, then commands, like loading a missing class later does.
+    ASSERT_NE(nullptr, add(entries, 1, alert(1000000010)));
+    ASSERT_NE(nullptr, add(entries, 3, alert(1000000030)));
+    ASSERT_NE(nullptr, add(entries, 2, command(1000000020)));
+    ASSERT_NE(nullptr, add(entries, 4, command(1000000030)));
+    entries.sort();
+    EXPECT_EQ((std::vector<size_t>{1, 2, 3, 4}), linenos(entries));
+
+    // Invalid and duplicate lines are not added.
+    EXPECT_EQ(nullptr, add(entries, 5, "garbage"));
+    EXPECT_EQ(nullptr, add(entries, 3, alert(1000000030)));
+    EXPECT_EQ(nullptr, add(entries, 4, command(1000000030)));
+    EXPECT_EQ(4U, entries.size());
+
+    EXPECT_EQ(1, entries.lowerBound(1000000010)->entry->_lineno);
+    EXPECT_EQ(2, entries.lowerBound(1000000011)->entry->_lineno);
+    EXPECT_EQ(3, entries.upperBound(1000000020)->entry->_lineno);
+    EXPECT_EQ(entries.end(), entries.upperBound(1000000030));
+    EXPECT_EQ(entries.begin(), entries.lowerBound(0));
+}
+
+TEST(LogEntries, EraseDropsWholeClasses) {
+    LogEntries entries;
+    for (size_t i = 0; i < 100; ++i) {
+        auto t = static_cast<time_t>(1000000000 + i);
+        add(entries, i, i % 3 == 0 ? command(t) : alert(t));
+    }
+    auto usage = entries.erase(bit(LogEntry::Class::ext_command));
+    EXPECT_EQ(34U, usage.messages);
+    EXPECT_LT(34 * sizeof(LogEntry), usage.bytes);
+    ASSERT_EQ(66U, entries.size());
+    for (auto it = entries.begin(); it != entries.end(); ++it) {
+        EXPECT_EQ(LogEntry::Class::alert, it->entry->_class);
+        if (it != entries.begin()) {
+            EXPECT_LT((it - 1)->key, it->key);
+        }
+    }
+
+    usage = entries.erase(bit(LogEntry::Class::ext_command));
+    EXPECT_EQ(0U, usage.messages);
+    usage = entries.erase(LogEntry::all_classes);
+    EXPECT_EQ(66U, usage.messages);
+    EXPECT_TRUE(entries.empty());
+}
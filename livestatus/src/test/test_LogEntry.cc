@@ -97,16 +97,16 @@ TEST(LogEntry, InitialHostState) {
                           .append(";7;Krasser Output;Laaang"),
                       e._options);
             EXPECT_EQ("INITIAL HOST STATE"s, e._type);
-            EXPECT_EQ("huey", e._host_name);
-            EXPECT_EQ("", e._service_description);
-            EXPECT_EQ("", e._command_name);
-            EXPECT_EQ("", e._contact_name);
+            EXPECT_EQ("huey", e.hostName());
+            EXPECT_EQ("", e.serviceDescription());
+            EXPECT_EQ("", e.commandName());
+            EXPECT_EQ("", e.contactName());
             EXPECT_EQ(static_cast<int>(state), e._state);
-            EXPECT_EQ(state_type, e._state_type);
+            EXPECT_EQ(state_type, e.stateType());
             EXPECT_EQ(7, e._attempt);
-            EXPECT_EQ("Krasser Output", e._plugin_output);
-            EXPECT_EQ("Laaang", e._long_plugin_output);
-            EXPECT_EQ("", e._comment);
+            EXPECT_EQ("Krasser Output", e.pluginOutput());
+            EXPECT_EQ("Laaang", e.longPluginOutput());
+            EXPECT_EQ("", e.comment());
             EXPECT_EQ(parens(state_type, state_name), e.state_info());
         }
     }
@@ -123,16 +123,16 @@ TEST(LogEntry, InitialHostStateWithoutLongOutput) {
     EXPECT_EQ(line, e._message);
     EXPECT_EQ("huey;UP;HARD;7;Krasser Output"s, e._options);
     EXPECT_EQ("INITIAL HOST STATE"s, e._type);
-    EXPECT_EQ("huey", e._host_name);
-    EXPECT_EQ("", e._service_description);
-    EXPECT_EQ("", e._command_name);
-    EXPECT_EQ("", e._contact_name);
+    EXPECT_EQ("huey", e.hostName());
+    EXPECT_EQ("", e.serviceDescription());
+    EXPECT_EQ("", e.commandName());
+    EXPECT_EQ("", e.contactName());
     EXPECT_EQ(static_cast<int>(HostState::up), e._state);
-    EXPECT_EQ("HARD", e._state_type);
+    EXPECT_EQ("HARD", e.stateType());
     EXPECT_EQ(7, e._attempt);
-    EXPECT_EQ("Krasser Output", e._plugin_output);
-    EXPECT_EQ("", e._long_plugin_output);
-    EXPECT_EQ("", e._comment);
+    EXPECT_EQ("Krasser Output", e.pluginOutput());
+    EXPECT_EQ("", e.longPluginOutput());
+    EXPECT_EQ("", e.comment());
     EXPECT_EQ("HARD (UP)", e.state_info());
 }
 
@@ -148,16 +148,16 @@ TEST(LogEntry, InitialHostStateWithMultiLine) {
     EXPECT_EQ("huey;UP;HARD;7;Krasser Output;Laaanger\\nLong\\nOutput"s,
               e._options);
     EXPECT_EQ("INITIAL HOST STATE"s, e._type);
-    EXPECT_EQ("huey", e._host_name);
-    EXPECT_EQ("", e._service_description);
-    EXPECT_EQ("", e._command_name);
-    EXPECT_EQ("", e._contact_name);
+    EXPECT_EQ("huey", e.hostName());
+    EXPECT_EQ("", e.serviceDescription());
+    EXPECT_EQ("", e.commandName());
+    EXPECT_EQ("", e.contactName());
     EXPECT_EQ(static_cast<int>(HostState::up), e._state);
-    EXPECT_EQ("HARD", e._state_type);
+    EXPECT_EQ("HARD", e.stateType());
     EXPECT_EQ(7, e._attempt);
-    EXPECT_EQ("Krasser Output", e._plugin_output);
-    EXPECT_EQ("Laaanger\nLong\nOutput", e._long_plugin_output);
-    EXPECT_EQ("", e._comment);
+    EXPECT_EQ("Krasser Output", e.pluginOutput());
+    EXPECT_EQ("Laaanger\nLong\nOutput", e.longPluginOutput());
+    EXPECT_EQ("", e.comment());
     EXPECT_EQ("HARD (UP)", e.state_info());
 }
 
@@ -182,16 +182,16 @@ TEST(LogEntry, CurrentHostState) {
                           .append(";8;Voll krasser Output;long"),
                       e._options);
             EXPECT_EQ("CURRENT HOST STATE"s, e._type);
-            EXPECT_EQ("dewey", e._host_name);
-            EXPECT_EQ("", e._service_description);
-            EXPECT_EQ("", e._command_name);
-            EXPECT_EQ("", e._contact_name);
+            EXPECT_EQ("dewey", e.hostName());
+            EXPECT_EQ("", e.serviceDescription());
+            EXPECT_EQ("", e.commandName());
+            EXPECT_EQ("", e.contactName());
             EXPECT_EQ(static_cast<int>(state), e._state);
-            EXPECT_EQ(state_type, e._state_type);
+            EXPECT_EQ(state_type, e.stateType());
             EXPECT_EQ(8, e._attempt);
-            EXPECT_EQ("Voll krasser Output", e._plugin_output);
-            EXPECT_EQ("long", e._long_plugin_output);
-            EXPECT_EQ("", e._comment);
+            EXPECT_EQ("Voll krasser Output", e.pluginOutput());
+            EXPECT_EQ("long", e.longPluginOutput());
+            EXPECT_EQ("", e.comment());
             EXPECT_EQ(parens(state_type, state_name), e.state_info());
         }
     }
@@ -217,16 +217,16 @@ TEST(LogEntry, HostAlert) {
                           .append(";1234;Komisch...;Lalalang"),
                       e._options);
             EXPECT_EQ("HOST ALERT"s, e._type);
-            EXPECT_EQ("huey", e._host_name);
-            EXPECT_EQ("", e._service_description);
-            EXPECT_EQ("", e._command_name);
-            EXPECT_EQ("", e._contact_name);
+            EXPECT_EQ("huey", e.hostName());
+            EXPECT_EQ("", e.serviceDescription());
+            EXPECT_EQ("", e.commandName());
+            EXPECT_EQ("", e.contactName());
             EXPECT_EQ(static_cast<int>(state), e._state);
-            EXPECT_EQ(state_type, e._state_type);
+            EXPECT_EQ(state_type, e.stateType());
             EXPECT_EQ(1234, e._attempt);
-            EXPECT_EQ("Komisch...", e._plugin_output);
-            EXPECT_EQ("Lalalang", e._long_plugin_output);
-            EXPECT_EQ("", e._comment);
+            EXPECT_EQ("Komisch...", e.pluginOutput());
+            EXPECT_EQ("Lalalang", e.longPluginOutput());
+            EXPECT_EQ("", e.comment());
             EXPECT_EQ(parens(state_type, state_name), e.state_info());
         }
     }
@@ -244,16 +244,16 @@ TEST(LogEntry, HostDowntimeAlert) {
         EXPECT_EQ(line, e._message);
         EXPECT_EQ("huey;" + state_type + ";Komisch...", e._options);
         EXPECT_EQ("HOST DOWNTIME ALERT"s, e._type);
-        EXPECT_EQ("huey", e._host_name);
-        EXPECT_EQ("", e._service_description);
-        EXPECT_EQ("", e._command_name);
-        EXPECT_EQ("", e._contact_name);
+        EXPECT_EQ("huey", e.hostName());
+        EXPECT_EQ("", e.serviceDescription());
+        EXPECT_EQ("", e.commandName());
+        EXPECT_EQ("", e.contactName());
         EXPECT_EQ(static_cast<int>(HostState::up), e._state);
-        EXPECT_EQ(state_type, e._state_type);
+        EXPECT_EQ(state_type, e.stateType());
         EXPECT_EQ(0, e._attempt);
-        EXPECT_EQ("", e._plugin_output);
-        EXPECT_EQ("", e._long_plugin_output);
-        EXPECT_EQ("Komisch...", e._comment);
+        EXPECT_EQ("", e.pluginOutput());
+        EXPECT_EQ("", e.longPluginOutput());
+        EXPECT_EQ("Komisch...", e.comment());
         EXPECT_EQ(state_type, e.state_info());
     }
 }
@@ -270,16 +270,16 @@ TEST(LogEntry, HostAcknowledgeAlert) {
         EXPECT_EQ(line, e._message);
         EXPECT_EQ("huey;" + state_type + ";King Kong;foo bar", e._options);
         EXPECT_EQ("HOST ACKNOWLEDGE ALERT"s, e._type);
-        EXPECT_EQ("huey", e._host_name);
-        EXPECT_EQ("", e._service_description);
-        EXPECT_EQ("", e._command_name);
-        EXPECT_EQ("King Kong", e._contact_name);
+        EXPECT_EQ("huey", e.hostName());
+        EXPECT_EQ("", e.serviceDescription());
+        EXPECT_EQ("", e.commandName());
+        EXPECT_EQ("King Kong", e.contactName());
         EXPECT_EQ(static_cast<int>(HostState::up), e._state);
-        EXPECT_EQ(state_type, e._state_type);
+        EXPECT_EQ(state_type, e.stateType());
         EXPECT_EQ(0, e._attempt);
-        EXPECT_EQ("", e._plugin_output);
-        EXPECT_EQ("", e._long_plugin_output);
-        EXPECT_EQ("foo bar", e._comment);
+        EXPECT_EQ("", e.pluginOutput());
+        EXPECT_EQ("", e.longPluginOutput());
+        EXPECT_EQ("foo bar", e.comment());
         EXPECT_EQ(state_type, e.state_info());
     }
 }
@@ -296,16 +296,16 @@ TEST(LogEntry, HostFlappingAlert) {
         EXPECT_EQ(line, e._message);
         EXPECT_EQ("huey;" + state_type + ";foo bar", e._options);
         EXPECT_EQ("HOST FLAPPING ALERT"s, e._type);
-        EXPECT_EQ("huey", e._host_name);
-        EXPECT_EQ("", e._service_description);
-        EXPECT_EQ("", e._command_name);
-        EXPECT_EQ("", e._contact_name);
+        EXPECT_EQ("huey", e.hostName());
+        EXPECT_EQ("", e.serviceDescription());
+        EXPECT_EQ("", e.commandName());
+        EXPECT_EQ("", e.contactName());
         EXPECT_EQ(static_cast<int>(HostState::up), e._state);
-        EXPECT_EQ(state_type, e._state_type);
+        EXPECT_EQ(state_type, e.stateType());
         EXPECT_EQ(0, e._attempt);
-        EXPECT_EQ("", e._plugin_output);
-        EXPECT_EQ("", e._long_plugin_output);
-        EXPECT_EQ("foo bar", e._comment);
+        EXPECT_EQ("", e.pluginOutput());
+        EXPECT_EQ("", e.longPluginOutput());
+        EXPECT_EQ("foo bar", e.comment());
         EXPECT_EQ(state_type, e.state_info());
     }
 }
@@ -331,16 +331,16 @@ TEST(LogEntry, InitialServiceState) {
                           .append(";1;Langweiliger Output;long"),
                       e._options);
             EXPECT_EQ("INITIAL SERVICE STATE"s, e._type);
-            EXPECT_EQ("louie", e._host_name);
-            EXPECT_EQ("servus 1", e._service_description);
-            EXPECT_EQ("", e._command_name);
-            EXPECT_EQ("", e._contact_name);
+            EXPECT_EQ("louie", e.hostName());
+            EXPECT_EQ("servus 1", e.serviceDescription());
+            EXPECT_EQ("", e.commandName());
+            EXPECT_EQ("", e.contactName());
             EXPECT_EQ(static_cast<int>(state), e._state);
-            EXPECT_EQ(state_type, e._state_type);
+            EXPECT_EQ(state_type, e.stateType());
             EXPECT_EQ(1, e._attempt);
-            EXPECT_EQ("Langweiliger Output", e._plugin_output);
-            EXPECT_EQ("long", e._long_plugin_output);
-            EXPECT_EQ("", e._comment);
+            EXPECT_EQ("Langweiliger Output", e.pluginOutput());
+            EXPECT_EQ("long", e.longPluginOutput());
+            EXPECT_EQ("", e.comment());
             EXPECT_EQ(parens(state_type, state_name), e.state_info());
         }
     }
@@ -367,16 +367,16 @@ TEST(LogEntry, CurrentServiceState) {
                           .append(";2;Irgendein Output;lang"),
                       e._options);
             EXPECT_EQ("CURRENT SERVICE STATE"s, e._type);
-            EXPECT_EQ("donald", e._host_name);
-            EXPECT_EQ("gruezi 2", e._service_description);
-            EXPECT_EQ("", e._command_name);
-            EXPECT_EQ("", e._contact_name);
+            EXPECT_EQ("donald", e.hostName());
+            EXPECT_EQ("gruezi 2", e.serviceDescription());
+            EXPECT_EQ("", e.commandName());
+            EXPECT_EQ("", e.contactName());
             EXPECT_EQ(static_cast<int>(state), e._state);
-            EXPECT_EQ(state_type, e._state_type);
+            EXPECT_EQ(state_type, e.stateType());
             EXPECT_EQ(2, e._attempt);
-            EXPECT_EQ("Irgendein Output", e._plugin_output);
-            EXPECT_EQ("lang", e._long_plugin_output);
-            EXPECT_EQ("", e._comment);
+            EXPECT_EQ("Irgendein Output", e.pluginOutput());
+            EXPECT_EQ("lang", e.longPluginOutput());
+            EXPECT_EQ("", e.comment());
             EXPECT_EQ(parens(state_type, state_name), e.state_info());
         }
     }
@@ -403,16 +403,16 @@ TEST(LogEntry, ServiceAlert) {
                           .append(";1234;Komisch...;lang"),
                       e._options);
             EXPECT_EQ("SERVICE ALERT"s, e._type);
-            EXPECT_EQ("huey", e._host_name);
-            EXPECT_EQ("hi!", e._service_description);
-            EXPECT_EQ("", e._command_name);
-            EXPECT_EQ("", e._contact_name);
+            EXPECT_EQ("huey", e.hostName());
+            EXPECT_EQ("hi!", e.serviceDescription());
+            EXPECT_EQ("", e.commandName());
+            EXPECT_EQ("", e.contactName());
             EXPECT_EQ(static_cast<int>(state), e._state);
-            EXPECT_EQ(state_type, e._state_type);
+            EXPECT_EQ(state_type, e.stateType());
             EXPECT_EQ(1234, e._attempt);
-            EXPECT_EQ("Komisch...", e._plugin_output);
-            EXPECT_EQ("lang", e._long_plugin_output);
-            EXPECT_EQ("", e._comment);
+            EXPECT_EQ("Komisch...", e.pluginOutput());
+            EXPECT_EQ("lang", e.longPluginOutput());
+            EXPECT_EQ("", e.comment());
             EXPECT_EQ(parens(state_type, state_name), e.state_info());
         }
     }
@@ -430,16 +430,16 @@ TEST(LogEntry, ServiceDowntimeAlert) {
         EXPECT_EQ(line, e._message);
         EXPECT_EQ("huey;hi, ho!;" + state_type + ";Komisch...", e._options);
         EXPECT_EQ("SERVICE DOWNTIME ALERT"s, e._type);
-        EXPECT_EQ("huey", e._host_name);
-        EXPECT_EQ("hi, ho!", e._service_description);
-        EXPECT_EQ("", e._command_name);
-        EXPECT_EQ("", e._contact_name);
+        EXPECT_EQ("huey", e.hostName());
+        EXPECT_EQ("hi, ho!", e.serviceDescription());
+        EXPECT_EQ("", e.commandName());
+        EXPECT_EQ("", e.contactName());
         EXPECT_EQ(static_cast<int>(ServiceState::ok), e._state);
-        EXPECT_EQ(state_type, e._state_type);
+        EXPECT_EQ(state_type, e.stateType());
         EXPECT_EQ(0, e._attempt);
-        EXPECT_EQ("", e._plugin_output);
-        EXPECT_EQ("", e._long_plugin_output);
-        EXPECT_EQ("Komisch...", e._comment);
+        EXPECT_EQ("", e.pluginOutput());
+        EXPECT_EQ("", e.longPluginOutput());
+        EXPECT_EQ("Komisch...", e.comment());
         EXPECT_EQ(state_type, e.state_info());
     }
 }
@@ -456,16 +456,16 @@ TEST(LogEntry, ServiceAcknowledgeAlert) {
         EXPECT_EQ(line, e._message);
         EXPECT_EQ("huey;hi!;" + state_type + ";King Kong;foo bar", e._options);
         EXPECT_EQ("SERVICE ACKNOWLEDGE ALERT"s, e._type);
-        EXPECT_EQ("huey", e._host_name);
-        EXPECT_EQ("hi!", e._service_description);
-        EXPECT_EQ("", e._command_name);
-        EXPECT_EQ("King Kong", e._contact_name);
+        EXPECT_EQ("huey", e.hostName());
+        EXPECT_EQ("hi!", e.serviceDescription());
+        EXPECT_EQ("", e.commandName());
+        EXPECT_EQ("King Kong", e.contactName());
         EXPECT_EQ(static_cast<int>(ServiceState::ok), e._state);
-        EXPECT_EQ(state_type, e._state_type);
+        EXPECT_EQ(state_type, e.stateType());
         EXPECT_EQ(0, e._attempt);
-        EXPECT_EQ("", e._plugin_output);
-        EXPECT_EQ("", e._long_plugin_output);
-        EXPECT_EQ("foo bar", e._comment);
+        EXPECT_EQ("", e.pluginOutput());
+        EXPECT_EQ("", e.longPluginOutput());
+        EXPECT_EQ("foo bar", e.comment());
         EXPECT_EQ(state_type, e.state_info());
     }
 }
@@ -482,16 +482,16 @@ TEST(LogEntry, ServiceFlappingAlert) {
         EXPECT_EQ(line, e._message);
         EXPECT_EQ("huey;hi!;" + state_type + ";foo bar", e._options);
         EXPECT_EQ("SERVICE FLAPPING ALERT"s, e._type);
-        EXPECT_EQ("huey", e._host_name);
-        EXPECT_EQ("hi!", e._service_description);
-        EXPECT_EQ("", e._command_name);
-        EXPECT_EQ("", e._contact_name);
+        EXPECT_EQ("huey", e.hostName());
+        EXPECT_EQ("hi!", e.serviceDescription());
+        EXPECT_EQ("", e.commandName());
+        EXPECT_EQ("", e.contactName());
         EXPECT_EQ(static_cast<int>(ServiceState::ok), e._state);
-        EXPECT_EQ(state_type, e._state_type);
+        EXPECT_EQ(state_type, e.stateType());
         EXPECT_EQ(0, e._attempt);
-        EXPECT_EQ("", e._plugin_output);
-        EXPECT_EQ("", e._long_plugin_output);
-        EXPECT_EQ("foo bar", e._comment);
+        EXPECT_EQ("", e.pluginOutput());
+        EXPECT_EQ("", e.longPluginOutput());
+        EXPECT_EQ("foo bar", e.comment());
         EXPECT_EQ(state_type, e.state_info());
     }
 }
@@ -506,16 +506,16 @@ TEST(LogEntry, TimeperiodTransition) {
     EXPECT_EQ(line, e._message);
     EXPECT_EQ("denominazione;-1;1"s, e._options);
     EXPECT_EQ("TIMEPERIOD TRANSITION"s, e._type);
-    EXPECT_EQ("", e._host_name);
-    EXPECT_EQ("", e._service_description);
-    EXPECT_EQ("", e._command_name);
-    EXPECT_EQ("", e._contact_name);
+    EXPECT_EQ("", e.hostName());
+    EXPECT_EQ("", e.serviceDescription());
+    EXPECT_EQ("", e.commandName());
+    EXPECT_EQ("", e.contactName());
     EXPECT_EQ(0, e._state);
-    EXPECT_EQ("", e._state_type);
+    EXPECT_EQ("", e.stateType());
     EXPECT_EQ(0, e._attempt);
-    EXPECT_EQ("", e._plugin_output);
-    EXPECT_EQ("", e._long_plugin_output);
-    EXPECT_EQ("", e._comment);
+    EXPECT_EQ("", e.pluginOutput());
+    EXPECT_EQ("", e.longPluginOutput());
+    EXPECT_EQ("", e.comment());
     EXPECT_EQ("", e.state_info());
 }
 
@@ -535,16 +535,16 @@ TEST(LogEntry, HostNotification) {
                       ";commando;viel output...;Tolkien;The Hobbit;lalala"s,
                   e._options);
         EXPECT_EQ("HOST NOTIFICATION"s, e._type);
-        EXPECT_EQ("donald", e._host_name);
-        EXPECT_EQ("", e._service_description);
-        EXPECT_EQ("commando", e._command_name);
-        EXPECT_EQ("King Kong", e._contact_name);
+        EXPECT_EQ("donald", e.hostName());
+        EXPECT_EQ("", e.serviceDescription());
+        EXPECT_EQ("commando", e.commandName());
+        EXPECT_EQ("King Kong", e.contactName());
         EXPECT_EQ(state, e._state);
-        EXPECT_EQ(state_name, e._state_type);
+        EXPECT_EQ(state_name, e.stateType());
         EXPECT_EQ(0, e._attempt);
-        EXPECT_EQ("viel output...", e._plugin_output);
-        EXPECT_EQ("lalala", e._long_plugin_output);
-        EXPECT_EQ("The Hobbit", e._comment);
+        EXPECT_EQ("viel output...", e.pluginOutput());
+        EXPECT_EQ("lalala", e.longPluginOutput());
+        EXPECT_EQ("The Hobbit", e.comment());
         EXPECT_EQ(info, e.state_info());
     }
 }
@@ -565,16 +565,16 @@ TEST(LogEntry, ServiceNotification) {
                       ";commando;viel output...;Tolkien;The Hobbit;lalala"s,
                   e._options);
         EXPECT_EQ("SERVICE NOTIFICATION"s, e._type);
-        EXPECT_EQ("donald", e._host_name);
-        EXPECT_EQ("duck", e._service_description);
-        EXPECT_EQ("commando", e._command_name);
-        EXPECT_EQ("King Kong", e._contact_name);
+        EXPECT_EQ("donald", e.hostName());
+        EXPECT_EQ("duck", e.serviceDescription());
+        EXPECT_EQ("commando", e.commandName());
+        EXPECT_EQ("King Kong", e.contactName());
         EXPECT_EQ(state, e._state);
-        EXPECT_EQ(state_name, e._state_type);
+        EXPECT_EQ(state_name, e.stateType());
         EXPECT_EQ(0, e._attempt);
-        EXPECT_EQ("viel output...", e._plugin_output);
-        EXPECT_EQ("lalala", e._long_plugin_output);
-        EXPECT_EQ("The Hobbit", e._comment);
+        EXPECT_EQ("viel output...", e.pluginOutput());
+        EXPECT_EQ("lalala", e.longPluginOutput());
+        EXPECT_EQ("The Hobbit", e.comment());
         EXPECT_EQ(info, e.state_info());
     }
 }
@@ -595,16 +595,16 @@ TEST(LogEntry, HostNotificationResult) {
                       ";commando;viel output...;blah blubb",
                   e._options);
         EXPECT_EQ("HOST NOTIFICATION RESULT"s, e._type);
-        EXPECT_EQ("donald", e._host_name);
-        EXPECT_EQ("", e._service_description);
-        EXPECT_EQ("commando", e._command_name);
-        EXPECT_EQ("King Kong", e._contact_name);
+        EXPECT_EQ("donald", e.hostName());
+        EXPECT_EQ("", e.serviceDescription());
+        EXPECT_EQ("commando", e.commandName());
+        EXPECT_EQ("King Kong", e.contactName());
         EXPECT_EQ(code, e._state);
-        EXPECT_EQ(code_name, e._state_type);
+        EXPECT_EQ(code_name, e.stateType());
         EXPECT_EQ(0, e._attempt);
-        EXPECT_EQ("viel output...", e._plugin_output);
-        EXPECT_EQ("", e._long_plugin_output);
-        EXPECT_EQ("blah blubb", e._comment);
+        EXPECT_EQ("viel output...", e.pluginOutput());
+        EXPECT_EQ("", e.longPluginOutput());
+        EXPECT_EQ("blah blubb", e.comment());
         EXPECT_EQ(parens("EXIT_CODE", info), e.state_info());
     }
 }
@@ -626,16 +626,16 @@ TEST(LogEntry, ServiceNotificationResult) {
                       ";commando;viel output...;blah blubb",
                   e._options);
         EXPECT_EQ("SERVICE NOTIFICATION RESULT"s, e._type);
-        EXPECT_EQ("donald", e._host_name);
-        EXPECT_EQ("duck", e._service_description);
-        EXPECT_EQ("commando", e._command_name);
-        EXPECT_EQ("King Kong", e._contact_name);
+        EXPECT_EQ("donald", e.hostName());
+        EXPECT_EQ("duck", e.serviceDescription());
+        EXPECT_EQ("commando", e.commandName());
+        EXPECT_EQ("King Kong", e.contactName());
         EXPECT_EQ(code, e._state);
-        EXPECT_EQ(code_name, e._state_type);
+        EXPECT_EQ(code_name, e.stateType());
         EXPECT_EQ(0, e._attempt);
-        EXPECT_EQ("viel output...", e._plugin_output);
-        EXPECT_EQ("", e._long_plugin_output);
-        EXPECT_EQ("blah blubb", e._comment);
+        EXPECT_EQ("viel output...", e.pluginOutput());
+        EXPECT_EQ("", e.longPluginOutput());
+        EXPECT_EQ("blah blubb", e.comment());
         EXPECT_EQ(parens("EXIT_CODE", info), e.state_info());
     }
 }
@@ -656,16 +656,16 @@ TEST(LogEntry, HostNotificationProgress) {
         EXPECT_EQ("King Kong;donald;" + code_name + ";commando;viel output...",
                   e._options);
         EXPECT_EQ("HOST NOTIFICATION PROGRESS"s, e._type);
-        EXPECT_EQ("donald", e._host_name);
-        EXPECT_EQ("", e._service_description);
-        EXPECT_EQ("commando", e._command_name);
-        EXPECT_EQ("King Kong", e._contact_name);
+        EXPECT_EQ("donald", e.hostName());
+        EXPECT_EQ("", e.serviceDescription());
+        EXPECT_EQ("commando", e.commandName());
+        EXPECT_EQ("King Kong", e.contactName());
         EXPECT_EQ(code, e._state);
-        EXPECT_EQ(code_name, e._state_type);
+        EXPECT_EQ(code_name, e.stateType());
         EXPECT_EQ(0, e._attempt);
-        EXPECT_EQ("viel output...", e._plugin_output);
-        EXPECT_EQ("", e._long_plugin_output);
-        EXPECT_EQ("", e._comment);
+        EXPECT_EQ("viel output...", e.pluginOutput());
+        EXPECT_EQ("", e.longPluginOutput());
+        EXPECT_EQ("", e.comment());
         EXPECT_EQ(parens("EXIT_CODE", info), e.state_info());
     }
 }
@@ -687,16 +687,16 @@ TEST(LogEntry, ServiceNotificationProgress) {
             "King Kong;donald;duck;" + code_name + ";commando;viel output...",
             e._options);
         EXPECT_EQ("SERVICE NOTIFICATION PROGRESS"s, e._type);
-        EXPECT_EQ("donald", e._host_name);
-        EXPECT_EQ("duck", e._service_description);
-        EXPECT_EQ("commando", e._command_name);
-        EXPECT_EQ("King Kong", e._contact_name);
+        EXPECT_EQ("donald", e.hostName());
+        EXPECT_EQ("duck", e.serviceDescription());
+        EXPECT_EQ("commando", e.commandName());
+        EXPECT_EQ("King Kong", e.contactName());
         EXPECT_EQ(code, e._state);
-        EXPECT_EQ(code_name, e._state_type);
+        EXPECT_EQ(code_name, e.stateType());
         EXPECT_EQ(0, e._attempt);
-        EXPECT_EQ("viel output...", e._plugin_output);
-        EXPECT_EQ("", e._long_plugin_output);
-        EXPECT_EQ("", e._comment);
+        EXPECT_EQ("viel output...", e.pluginOutput());
+        EXPECT_EQ("", e.longPluginOutput());
+        EXPECT_EQ("", e.comment());
         EXPECT_EQ(parens("EXIT_CODE", info), e.state_info());
     }
 }
@@ -711,15 +711,15 @@ TEST(LogEntry, HostAlertHandlerStarted) {
     EXPECT_EQ(line, e._message);
     EXPECT_EQ("donald;commando"s, e._options);
     EXPECT_EQ("HOST ALERT HANDLER STARTED"s, e._type);
-    EXPECT_EQ("donald", e._host_name);
-    EXPECT_EQ("", e._service_description);
-    EXPECT_EQ("commando", e._command_name);
-    EXPECT_EQ("", e._contact_name);
+    EXPECT_EQ("donald", e.hostName());
+    EXPECT_EQ("", e.serviceDescription());
+    EXPECT_EQ("commando", e.commandName());
+    EXPECT_EQ("", e.contactName());
     EXPECT_EQ(static_cast<int>(HostState::up), e._state);
-    EXPECT_EQ("", e._state_type);
+    EXPECT_EQ("", e.stateType());
     EXPECT_EQ(0, e._attempt);
-    EXPECT_EQ("", e._plugin_output);
-    EXPECT_EQ("", e._comment);
+    EXPECT_EQ("", e.pluginOutput());
+    EXPECT_EQ("", e.comment());
     EXPECT_EQ("", e.state_info());
 }
 
@@ -734,15 +734,15 @@ TEST(LogEntry, ServiceAlertHandlerStarted) {
     EXPECT_EQ(line, e._message);
     EXPECT_EQ("donald;duck;commando"s, e._options);
     EXPECT_EQ("SERVICE ALERT HANDLER STARTED"s, e._type);
-    EXPECT_EQ("donald", e._host_name);
-    EXPECT_EQ("duck", e._service_description);
-    EXPECT_EQ("commando", e._command_name);
-    EXPECT_EQ("", e._contact_name);
+    EXPECT_EQ("donald", e.hostName());
+    EXPECT_EQ("duck", e.serviceDescription());
+    EXPECT_EQ("commando", e.commandName());
+    EXPECT_EQ("", e.contactName());
     EXPECT_EQ(static_cast<int>(ServiceState::ok), e._state);
-    EXPECT_EQ("", e._state_type);
+    EXPECT_EQ("", e.stateType());
     EXPECT_EQ(0, e._attempt);
-    EXPECT_EQ("", e._plugin_output);
-    EXPECT_EQ("", e._comment);
+    EXPECT_EQ("", e.pluginOutput());
+    EXPECT_EQ("", e.comment());
     EXPECT_EQ("", e.state_info());
 }
 
@@ -762,16 +762,16 @@ TEST(LogEntry, HostAlertHandlerStopped) {
         EXPECT_EQ("donald;commando;"s + code_name + ";es war einmal...",
                   e._options);
         EXPECT_EQ("HOST ALERT HANDLER STOPPED"s, e._type);
-        EXPECT_EQ("donald", e._host_name);
-        EXPECT_EQ("", e._service_description);
-        EXPECT_EQ("commando", e._command_name);
-        EXPECT_EQ("", e._contact_name);
+        EXPECT_EQ("donald", e.hostName());
+        EXPECT_EQ("", e.serviceDescription());
+        EXPECT_EQ("commando", e.commandName());
+        EXPECT_EQ("", e.contactName());
         EXPECT_EQ(code, e._state);
-        EXPECT_EQ("", e._state_type);
+        EXPECT_EQ("", e.stateType());
         EXPECT_EQ(0, e._attempt);
-        EXPECT_EQ("es war einmal...", e._plugin_output);
-        EXPECT_EQ("", e._long_plugin_output);
-        EXPECT_EQ("", e._comment);
+        EXPECT_EQ("es war einmal...", e.pluginOutput());
+        EXPECT_EQ("", e.longPluginOutput());
+        EXPECT_EQ("", e.comment());
         EXPECT_EQ(parens("EXIT_CODE", info), e.state_info());
     }
 }
@@ -792,16 +792,16 @@ TEST(LogEntry, ServiceAlertHandlerStopped) {
         EXPECT_EQ("donald;duck;commando;"s + code_name + ";once upon a time...",
                   e._options);
         EXPECT_EQ("SERVICE ALERT HANDLER STOPPED"s, e._type);
-        EXPECT_EQ("donald", e._host_name);
-        EXPECT_EQ("duck", e._service_description);
-        EXPECT_EQ("commando", e._command_name);
-        EXPECT_EQ("", e._contact_name);
+        EXPECT_EQ("donald", e.hostName());
+        EXPECT_EQ("duck", e.serviceDescription());
+        EXPECT_EQ("commando", e.commandName());
+        EXPECT_EQ("", e.contactName());
         EXPECT_EQ(code, e._state);
-        EXPECT_EQ("", e._state_type);
+        EXPECT_EQ("", e.stateType());
         EXPECT_EQ(0, e._attempt);
-        EXPECT_EQ("once upon a time...", e._plugin_output);
-        EXPECT_EQ("", e._long_plugin_output);
-        EXPECT_EQ("", e._comment);
+        EXPECT_EQ("once upon a time...", e.pluginOutput());
+        EXPECT_EQ("", e.longPluginOutput());
+        EXPECT_EQ("", e.comment());
         EXPECT_EQ(parens("EXIT_CODE", info), e.state_info());
     }
 }
@@ -822,15 +822,15 @@ TEST(LogEntry, PassiveServiceCheck) {
                       ";Isch hab Ruecken!",
                   e._options);
         EXPECT_EQ("PASSIVE SERVICE CHECK"s, e._type);
-        EXPECT_EQ("donald", e._host_name);
-        EXPECT_EQ("duck", e._service_description);
-        EXPECT_EQ("", e._command_name);
-        EXPECT_EQ("", e._contact_name);
+        EXPECT_EQ("donald", e.hostName());
+        EXPECT_EQ("duck", e.serviceDescription());
+        EXPECT_EQ("", e.commandName());
+        EXPECT_EQ("", e.contactName());
         EXPECT_EQ(static_cast<int>(state), e._state);
-        EXPECT_EQ("", e._state_type);
+        EXPECT_EQ("", e.stateType());
         EXPECT_EQ(0, e._attempt);
-        EXPECT_EQ("Isch hab Ruecken!", e._plugin_output);
-        EXPECT_EQ("", e._comment);
+        EXPECT_EQ("Isch hab Ruecken!", e.pluginOutput());
+        EXPECT_EQ("", e.comment());
         EXPECT_EQ(parens("PASSIVE", state_name), e.state_info());
     }
 }
@@ -851,15 +851,15 @@ TEST(LogEntry, PassiveHostCheck) {
                       ";Isch hab Ruecken!",
                   e._options);
         EXPECT_EQ("PASSIVE HOST CHECK"s, e._type);
-        EXPECT_EQ("donald", e._host_name);
-        EXPECT_EQ("", e._service_description);
-        EXPECT_EQ("", e._command_name);
-        EXPECT_EQ("", e._contact_name);
+        EXPECT_EQ("donald", e.hostName());
+        EXPECT_EQ("", e.serviceDescription());
+        EXPECT_EQ("", e.commandName());
+        EXPECT_EQ("", e.contactName());
         EXPECT_EQ(static_cast<int>(state), e._state);
-        EXPECT_EQ("", e._state_type);
+        EXPECT_EQ("", e.stateType());
         EXPECT_EQ(0, e._attempt);
-        EXPECT_EQ("Isch hab Ruecken!", e._plugin_output);
-        EXPECT_EQ("", e._comment);
+        EXPECT_EQ("Isch hab Ruecken!", e.pluginOutput());
+        EXPECT_EQ("", e.comment());
         EXPECT_EQ(parens("PASSIVE", state_name), e.state_info());
     }
 }
@@ -874,15 +874,15 @@ TEST(LogEntry, ExternalCommand) {
     EXPECT_EQ(line, e._message);
     EXPECT_EQ("commando"s, e._options);
     EXPECT_EQ("EXTERNAL COMMAND"s, e._type);
-    EXPECT_EQ("", e._host_name);
-    EXPECT_EQ("", e._service_description);
-    EXPECT_EQ("", e._command_name);
-    EXPECT_EQ("", e._contact_name);
+    EXPECT_EQ("", e.hostName());
+    EXPECT_EQ("", e.serviceDescription());
+    EXPECT_EQ("", e.commandName());
+    EXPECT_EQ("", e.contactName());
     EXPECT_EQ(0, e._state);
-    EXPECT_EQ("", e._state_type);
+    EXPECT_EQ("", e.stateType());
     EXPECT_EQ(0, e._attempt);
-    EXPECT_EQ("", e._plugin_output);
-    EXPECT_EQ("", e._comment);
+    EXPECT_EQ("", e.pluginOutput());
+    EXPECT_EQ("", e.comment());
     EXPECT_EQ("", e.state_info());
 }
 
@@ -896,15 +896,15 @@ TEST(LogEntry, LogVersion) {
     EXPECT_EQ(line, e._message);
     EXPECT_EQ("2.0"s, e._options);
     EXPECT_EQ("LOG VERSION: 2.0"s, e._type);
-    EXPECT_EQ("", e._host_name);
-    EXPECT_EQ("", e._service_description);
-    EXPECT_EQ("", e._command_name);
-    EXPECT_EQ("", e._contact_name);
+    EXPECT_EQ("", e.hostName());
+    EXPECT_EQ("", e.serviceDescription());
+    EXPECT_EQ("", e.commandName());
+    EXPECT_EQ("", e.contactName());
     EXPECT_EQ(0, e._state);
-    EXPECT_EQ("", e._state_type);
+    EXPECT_EQ("", e.stateType());
     EXPECT_EQ(0, e._attempt);
-    EXPECT_EQ("", e._plugin_output);
-    EXPECT_EQ("", e._comment);
+    EXPECT_EQ("", e.pluginOutput());
+    EXPECT_EQ("", e.comment());
     EXPECT_EQ("", e.state_info());
 }
 
@@ -918,15 +918,15 @@ TEST(LogEntry, LogInitialStates) {
     EXPECT_EQ(line, e._message);
     EXPECT_EQ(""s, e._options);
     EXPECT_EQ("logging initial states"s, e._type);
-    EXPECT_EQ("", e._host_name);
-    EXPECT_EQ("", e._service_description);
-    EXPECT_EQ("", e._command_name);
-    EXPECT_EQ("", e._contact_name);
+    EXPECT_EQ("", e.hostName());
+    EXPECT_EQ("", e.serviceDescription());
+    EXPECT_EQ("", e.commandName());
+    EXPECT_EQ("", e.contactName());
     EXPECT_EQ(0, e._state);
-    EXPECT_EQ("", e._state_type);
+    EXPECT_EQ("", e.stateType());
     EXPECT_EQ(0, e._attempt);
-    EXPECT_EQ("", e._plugin_output);
-    EXPECT_EQ("", e._comment);
+    EXPECT_EQ("", e.pluginOutput());
+    EXPECT_EQ("", e.comment());
     EXPECT_EQ("", e.state_info());
 }
 
@@ -940,15 +940,15 @@ TEST(LogEntry, CoreStarting1) {
     EXPECT_EQ(line, e._message);
     EXPECT_EQ(""s, e._options);
     EXPECT_EQ("starting..."s, e._type);
-    EXPECT_EQ("", e._host_name);
-    EXPECT_EQ("", e._service_description);
-    EXPECT_EQ("", e._command_name);
-    EXPECT_EQ("", e._contact_name);
+    EXPECT_EQ("", e.hostName());
+    EXPECT_EQ("", e.serviceDescription());
+    EXPECT_EQ("", e.commandName());
+    EXPECT_EQ("", e.contactName());
     EXPECT_EQ(0, e._state);
-    EXPECT_EQ("", e._state_type);
+    EXPECT_EQ("", e.stateType());
     EXPECT_EQ(0, e._attempt);
-    EXPECT_EQ("", e._plugin_output);
-    EXPECT_EQ("", e._comment);
+    EXPECT_EQ("", e.pluginOutput());
+    EXPECT_EQ("", e.comment());
     EXPECT_EQ("", e.state_info());
 }
 
@@ -962,15 +962,15 @@ TEST(LogEntry, CoreStarting2) {
     EXPECT_EQ(line, e._message);
     EXPECT_EQ(""s, e._options);
     EXPECT_EQ("active mode..."s, e._type);
-    EXPECT_EQ("", e._host_name);
-    EXPECT_EQ("", e._service_description);
-    EXPECT_EQ("", e._command_name);
-    EXPECT_EQ("", e._contact_name);
+    EXPECT_EQ("", e.hostName());
+    EXPECT_EQ("", e.serviceDescription());
+    EXPECT_EQ("", e.commandName());
+    EXPECT_EQ("", e.contactName());
     EXPECT_EQ(0, e._state);
-    EXPECT_EQ("", e._state_type);
+    EXPECT_EQ("", e.stateType());
     EXPECT_EQ(0, e._attempt);
-    EXPECT_EQ("", e._plugin_output);
-    EXPECT_EQ("", e._comment);
+    EXPECT_EQ("", e.pluginOutput());
+    EXPECT_EQ("", e.comment());
     EXPECT_EQ("", e.state_info());
 }
 
@@ -984,15 +984,15 @@ TEST(LogEntry, CoreStopping1) {
     EXPECT_EQ(line, e._message);
     EXPECT_EQ(""s, e._options);
     EXPECT_EQ("shutting down..."s, e._type);
-    EXPECT_EQ("", e._host_name);
-    EXPECT_EQ("", e._service_description);
-    EXPECT_EQ("", e._command_name);
-    EXPECT_EQ("", e._contact_name);
+    EXPECT_EQ("", e.hostName());
+    EXPECT_EQ("", e.serviceDescription());
+    EXPECT_EQ("", e.commandName());
+    EXPECT_EQ("", e.contactName());
     EXPECT_EQ(0, e._state);
-    EXPECT_EQ("", e._state_type);
+    EXPECT_EQ("", e.stateType());
     EXPECT_EQ(0, e._attempt);
-    EXPECT_EQ("", e._plugin_output);
-    EXPECT_EQ("", e._comment);
+    EXPECT_EQ("", e.pluginOutput());
+    EXPECT_EQ("", e.comment());
     EXPECT_EQ("", e.state_info());
 }
 
@@ -1006,15 +1006,15 @@ TEST(LogEntry, CoreStopping2) {
     EXPECT_EQ(line, e._message);
     EXPECT_EQ(""s, e._options);
     EXPECT_EQ("Bailing out"s, e._type);
-    EXPECT_EQ("", e._host_name);
-    EXPECT_EQ("", e._service_description);
-    EXPECT_EQ("", e._command_name);
-    EXPECT_EQ("", e._contact_name);
+    EXPECT_EQ("", e.hostName());
+    EXPECT_EQ("", e.serviceDescription());
+    EXPECT_EQ("", e.commandName());
+    EXPECT_EQ("", e.contactName());
     EXPECT_EQ(0, e._state);
-    EXPECT_EQ("", e._state_type);
+    EXPECT_EQ("", e.stateType());
     EXPECT_EQ(0, e._attempt);
-    EXPECT_EQ("", e._plugin_output);
-    EXPECT_EQ("", e._comment);
+    EXPECT_EQ("", e.pluginOutput());
+    EXPECT_EQ("", e.comment());
     EXPECT_EQ("", e.state_info());
 }
 
@@ -1028,15 +1028,15 @@ TEST(LogEntry, CoreStopping3) {
     EXPECT_EQ(line, e._message);
     EXPECT_EQ(""s, e._options);
     EXPECT_EQ("standby mode..."s, e._type);
-    EXPECT_EQ("", e._host_name);
-    EXPECT_EQ("", e._service_description);
-    EXPECT_EQ("", e._command_name);
-    EXPECT_EQ("", e._contact_name);
+    EXPECT_EQ("", e.hostName());
+    EXPECT_EQ("", e.serviceDescription());
+    EXPECT_EQ("", e.commandName());
+    EXPECT_EQ("", e.contactName());
     EXPECT_EQ(0, e._state);
-    EXPECT_EQ("", e._state_type);
+    EXPECT_EQ("", e.stateType());
     EXPECT_EQ(0, e._attempt);
-    EXPECT_EQ("", e._plugin_output);
-    EXPECT_EQ("", e._comment);
+    EXPECT_EQ("", e.pluginOutput());
+    EXPECT_EQ("", e.comment());
     EXPECT_EQ("", e.state_info());
 }
 
@@ -1050,15 +1050,15 @@ TEST(LogEntry, InvalidTimeStamp) {
     EXPECT_EQ(line, e._message);
     EXPECT_EQ(""s, e._options);
     EXPECT_EQ(""s, e._type);
-    EXPECT_EQ("", e._host_name);
-    EXPECT_EQ("", e._service_description);
-    EXPECT_EQ("", e._command_name);
-    EXPECT_EQ("", e._contact_name);
+    EXPECT_EQ("", e.hostName());
+    EXPECT_EQ("", e.serviceDescription());
+    EXPECT_EQ("", e.commandName());
+    EXPECT_EQ("", e.contactName());
     EXPECT_EQ(0, e._state);
-    EXPECT_EQ("", e._state_type);
+    EXPECT_EQ("", e.stateType());
     EXPECT_EQ(0, e._attempt);
-    EXPECT_EQ("", e._plugin_output);
-    EXPECT_EQ("", e._comment);
+    EXPECT_EQ("", e.pluginOutput());
+    EXPECT_EQ("", e.comment());
     EXPECT_EQ("", e.state_info());
 }
 
@@ -1072,15 +1072,15 @@ TEST(LogEntry, NoColon) {
     EXPECT_EQ(line, e._message);
     EXPECT_EQ(""s, e._options);
     EXPECT_EQ("this is total;nonsense"s, e._type);
-    EXPECT_EQ("", e._host_name);
-    EXPECT_EQ("", e._service_description);
-    EXPECT_EQ("", e._command_name);
-    EXPECT_EQ("", e._contact_name);
+    EXPECT_EQ("", e.hostName());
+    EXPECT_EQ("", e.serviceDescription());
+    EXPECT_EQ("", e.commandName());
+    EXPECT_EQ("", e.contactName());
     EXPECT_EQ(0, e._state);
-    EXPECT_EQ("", e._state_type);
+    EXPECT_EQ("", e.stateType());
     EXPECT_EQ(0, e._attempt);
-    EXPECT_EQ("", e._plugin_output);
-    EXPECT_EQ("", e._comment);
+    EXPECT_EQ("", e.pluginOutput());
+    EXPECT_EQ("", e.comment());
     EXPECT_EQ("", e.state_info());
 }
 
@@ -1102,16 +1102,16 @@ TEST(LogEntry, HostNotificationSwapped) {
                       ";viel output...;Tolkien;The Hobbit;lalala"s,
                   e._options);
         EXPECT_EQ("HOST NOTIFICATION"s, e._type);
-        EXPECT_EQ("donald", e._host_name);
-        EXPECT_EQ("", e._service_description);
-        EXPECT_EQ("check-mk-notify", e._command_name);
-        EXPECT_EQ("King Kong", e._contact_name);
+        EXPECT_EQ("donald", e.hostName());
+        EXPECT_EQ("", e.serviceDescription());
+        EXPECT_EQ("check-mk-notify", e.commandName());
+        EXPECT_EQ("King Kong", e.contactName());
         EXPECT_EQ(state, e._state);
-        EXPECT_EQ(state_name, e._state_type);
+        EXPECT_EQ(state_name, e.stateType());
         EXPECT_EQ(0, e._attempt);
-        EXPECT_EQ("viel output...", e._plugin_output);
-        EXPECT_EQ("lalala", e._long_plugin_output);
-        EXPECT_EQ("The Hobbit", e._comment);
+        EXPECT_EQ("viel output...", e.pluginOutput());
+        EXPECT_EQ("lalala", e.longPluginOutput());
+        EXPECT_EQ("The Hobbit", e.comment());
         EXPECT_EQ(info, e.state_info());
     }
 }
@@ -1134,16 +1134,16 @@ TEST(LogEntry, ServiceNotificationSwapped) {
                       ";viel output...;Tolkien;The Hobbit;lalala"s,
                   e._options);
         EXPECT_EQ("SERVICE NOTIFICATION"s, e._type);
-        EXPECT_EQ("donald", e._host_name);
-        EXPECT_EQ("duck", e._service_description);
-        EXPECT_EQ("check-mk-notify", e._command_name);
-        EXPECT_EQ("King Kong", e._contact_name);
+        EXPECT_EQ("donald", e.hostName());
+        EXPECT_EQ("duck", e.serviceDescription());
+        EXPECT_EQ("check-mk-notify", e.commandName());
+        EXPECT_EQ("King Kong", e.contactName());
         EXPECT_EQ(state, e._state);
-        EXPECT_EQ(state_name, e._state_type);
+        EXPECT_EQ(state_name, e.stateType());
         EXPECT_EQ(0, e._attempt);
-        EXPECT_EQ("viel output...", e._plugin_output);
-        EXPECT_EQ("lalala", e._long_plugin_output);
-        EXPECT_EQ("The Hobbit", e._comment);
+        EXPECT_EQ("viel output...", e.pluginOutput());
+        EXPECT_EQ("lalala", e.longPluginOutput());
+        EXPECT_EQ("The Hobbit", e.comment());
         EXPECT_EQ(info, e.state_info());
     }
 }
@@ -1165,16 +1165,16 @@ TEST(LogEntry, HostNotificationResultSwapped) {
                       ";viel output...;blah blubb",
                   e._options);
         EXPECT_EQ("HOST NOTIFICATION RESULT"s, e._type);
-        EXPECT_EQ("donald", e._host_name);
-        EXPECT_EQ("", e._service_description);
-        EXPECT_EQ("check-mk-notify", e._command_name);
-        EXPECT_EQ("King Kong", e._contact_name);
+        EXPECT_EQ("donald", e.hostName());
+        EXPECT_EQ("", e.serviceDescription());
+        EXPECT_EQ("check-mk-notify", e.commandName());
+        EXPECT_EQ("King Kong", e.contactName());
         EXPECT_EQ(code, e._state);
-        EXPECT_EQ(code_name, e._state_type);
+        EXPECT_EQ(code_name, e.stateType());
         EXPECT_EQ(0, e._attempt);
-        EXPECT_EQ("viel output...", e._plugin_output);
-        EXPECT_EQ("", e._long_plugin_output);
-        EXPECT_EQ("blah blubb", e._comment);
+        EXPECT_EQ("viel output...", e.pluginOutput());
+        EXPECT_EQ("", e.longPluginOutput());
+        EXPECT_EQ("blah blubb", e.comment());
         EXPECT_EQ(parens("EXIT_CODE", info), e.state_info());
     }
 }
@@ -1196,16 +1196,16 @@ TEST(LogEntry, ServiceNotificationResultSwapped) {
                       ";viel output...;blah blubb",
                   e._options);
         EXPECT_EQ("SERVICE NOTIFICATION RESULT"s, e._type);
-        EXPECT_EQ("donald", e._host_name);
-        EXPECT_EQ("duck", e._service_description);
-        EXPECT_EQ("check-mk-notify", e._command_name);
-        EXPECT_EQ("King Kong", e._contact_name);
+        EXPECT_EQ("donald", e.hostName());
+        EXPECT_EQ("duck", e.serviceDescription());
+        EXPECT_EQ("check-mk-notify", e.commandName());
+        EXPECT_EQ("King Kong", e.contactName());
         EXPECT_EQ(code, e._state);
-        EXPECT_EQ(code_name, e._state_type);
+        EXPECT_EQ(code_name, e.stateType());
         EXPECT_EQ(0, e._attempt);
-        EXPECT_EQ("viel output...", e._plugin_output);
-        EXPECT_EQ("", e._long_plugin_output);
-        EXPECT_EQ("blah blubb", e._comment);
+        EXPECT_EQ("viel output...", e.pluginOutput());
+        EXPECT_EQ("", e.longPluginOutput());
+        EXPECT_EQ("blah blubb", e.comment());
         EXPECT_EQ(parens("EXIT_CODE", info), e.state_info());
     }
 }
@@ -1227,16 +1227,16 @@ TEST(LogEntry, HostNotificationProgressSwapped) {
             "King Kong;donald;check-mk-notify;" + code_name + ";viel output...",
             e._options);
         EXPECT_EQ("HOST NOTIFICATION PROGRESS"s, e._type);
-        EXPECT_EQ("donald", e._host_name);
-        EXPECT_EQ("", e._service_description);
-        EXPECT_EQ("check-mk-notify", e._command_name);
-        EXPECT_EQ("King Kong", e._contact_name);
+        EXPECT_EQ("donald", e.hostName());
+        EXPECT_EQ("", e.serviceDescription());
+        EXPECT_EQ("check-mk-notify", e.commandName());
+        EXPECT_EQ("King Kong", e.contactName());
         EXPECT_EQ(code, e._state);
-        EXPECT_EQ(code_name, e._state_type);
+        EXPECT_EQ(code_name, e.stateType());
         EXPECT_EQ(0, e._attempt);
-        EXPECT_EQ("viel output...", e._plugin_output);
-        EXPECT_EQ("", e._long_plugin_output);
-        EXPECT_EQ("", e._comment);
+        EXPECT_EQ("viel output...", e.pluginOutput());
+        EXPECT_EQ("", e.longPluginOutput());
+        EXPECT_EQ("", e.comment());
         EXPECT_EQ(parens("EXIT_CODE", info), e.state_info());
     }
 }
@@ -1258,16 +1258,58 @@ TEST(LogEntry, ServiceNotificationProgressSwapped) {
                       ";viel output...",
                   e._options);
         EXPECT_EQ("SERVICE NOTIFICATION PROGRESS"s, e._type);
-        EXPECT_EQ("donald", e._host_name);
-        EXPECT_EQ("duck", e._service_description);
-        EXPECT_EQ("check-mk-notify", e._command_name);
-        EXPECT_EQ("King Kong", e._contact_name);
+        EXPECT_EQ("donald", e.hostName());
+        EXPECT_EQ("duck", e.serviceDescription());
+        EXPECT_EQ("check-mk-notify", e.commandName());
+        EXPECT_EQ("King Kong", e.contactName());
         EXPECT_EQ(code, e._state);
-        EXPECT_EQ(code_name, e._state_type);
+        EXPECT_EQ(code_name, e.stateType());
         EXPECT_EQ(0, e._attempt);
-        EXPECT_EQ("viel output...", e._plugin_output);
-        EXPECT_EQ("", e._long_plugin_output);
-        EXPECT_EQ("", e._comment);
+        EXPECT_EQ("viel output...", e.pluginOutput());
+        EXPECT_EQ("", e.longPluginOutput());
+        EXPECT_EQ("", e.comment());
         EXPECT_EQ(parens("EXIT_CODE", info), e.state_info());
     }
 }
+
+TEST(LogEntry, ClassifyAgreesWithConstructor) {
+    strings lines{
+        "[1551424305] HOST ALERT: huey;UP;HARD;1;foo",
+        "[1551424305] SERVICE NOTIFICATION: King Kong;donald;duck;OK;cmd;bar",
+        "[1551424305] CURRENT SERVICE STATE: donald;duck;OK;HARD;1;baz",
+        "[1551424305] EXTERNAL COMMAND: ACKNOWLEDGE_HOST_PROBLEM;huey",
+        "[1551424305] LOG VERSION: 2.0",
+        "[1551424305] Nagios 3.5.1 starting... (PID=42)",
+        "[1551424305] Caught SIGTERM, shutting down...",
+        "[1551424305] HOST ALERT without a colon",
+        "[1551424305] Warning: some random message",
+        "[1551424305]",
+        "1551424305 HOST ALERT: huey;UP;HARD;1;foo",
+        ""};
+    for (const auto& line : lines) {
+        EXPECT_EQ(LogEntry(1, line)._class, LogEntry::classify(line)) << line;
+    }
+}
+
+TEST(LogEntry, SummarizeAgreesWithConstructor) {
+    strings lines{
+        "[1551424305] HOST ALERT: huey;UP;HARD;1;foo",
+        "[1551424305] SERVICE NOTIFICATION: King Kong;donald;duck;OK;cmd;bar",
+        "[1551424305] HOST NOTIFICATION: King Kong",
+        "[1551424305] CURRENT SERVICE STATE: donald;duck;OK;HARD;1;baz",
+        "[1551424305] PASSIVE HOST CHECK: dewey",
+        "[1551424305] EXTERNAL COMMAND: ACKNOWLEDGE_HOST_PROBLEM;huey",
+        "[1551424305] LOG VERSION: 2.0",
+        "[1551424305] Warning: some random message",
+        "[15514243xx] HOST ALERT: huey;UP;HARD;1;foo",
+        "[abcdefghij] HOST ALERT: huey;UP;HARD;1;foo",
+        "1551424305 HOST ALERT: huey;UP;HARD;1;foo",
+        ""};
+    for (const auto& line : lines) {
+        LogEntry e(1, line);
+        auto summary = LogEntry::summarize(line);
+        EXPECT_EQ(e._class, summary.log_class) << line;
+        EXPECT_EQ(e._time, summary.time) << line;
+        EXPECT_EQ(e.hostName(), summary.host_name) << line;
+    }
+}
@@ -0,0 +1,71 @@
+// Copyright (C) 2019 tribe29 GmbH - License: GNU General Public License v2
+// This file is part of Checkmk (https://checkmk.com). It is subject to the
+// terms and conditions defined in the file COPYING, which is part of this
+// source code package.
+
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+
+#include "LogCache.h"
+#include "LogEntries.h"
+#include "LogEntry.h"
+#include "Logfile.h"
+#include "Logger.h"
+#include "NagiosCore.h"
+#include "data_encoding.h"
+#include "gtest/gtest.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+class LogfileFixture : public ::testing::Test {
+protected:
+    void SetUp() override {
+        fs::create_directories(basepath);
+        append("[1000000000] LOG VERSION: 2.0\n");
+    }
+
+    void TearDown() override { fs::remove_all(basepath); }
+
+    void append(const std::string &lines) const {
+        std::ofstream(path, std::ios::app) << lines;
+    }
+
+    size_t numEntries(Logfile &logfile) const {
+        std::shared_lock<std::shared_mutex> lock;
+        return logfile.getEntriesFor(1000, LogEntry::all_classes, lock)
+            ->size();
+    }
+
+    fs::path basepath = fs::temp_directory_path() / "logfile_tests";
+    fs::path path = basepath / "nagios.log";
+    NagiosCore core{NagiosPaths{}, NagiosLimits{}, NagiosAuthorization{},
+                    Encoding::utf8};
+    LogCache log_cache{&core};
+    Logger *const logger{Logger::getLogger("test")};
+};
+}  // namespace
+
+TEST_F(LogfileFixture, ReadsWhatHasBeenAddedToTheWatchedLogfile) {
+    Logfile logfile{logger, &log_cache, path, true};
+    EXPECT_EQ(1U, numEntries(logfile));
+    append("[1000000001] HOST ALERT: huey;DOWN;HARD;1;argh\n");
+    append("[1000000002] HOST ALERT: huey;UP;HARD;1;phew\n");
+    EXPECT_EQ(3U, numEntries(logfile));
+    EXPECT_EQ(3U, numEntries(logfile));
+}
+
+TEST_F(LogfileFixture, SurvivesTruncationOfTheWatchedLogfile) {
+    Logfile logfile{logger, &log_cache, path, true};
+    append("[1000000001] HOST ALERT: huey;DOWN;HARD;1;argh\n");
+    EXPECT_EQ(2U, numEntries(logfile));
+    fs::resize_file(path, 0);
+    append("[1000000002] HOST ALERT: huey;UP;HARD;1;phew\n");
+    // Entries read before are kept, lines at offsets already read are not
+    // read again.
+    EXPECT_EQ(2U, numEntries(logfile));
+}
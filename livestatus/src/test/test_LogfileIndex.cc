@@ -0,0 +1,101 @@
+// Copyright (C) 2019 tribe29 GmbH - License: GNU General Public License v2
+// This file is part of Checkmk (https://checkmk.com). It is subject to the
+// terms and conditions defined in the file COPYING, which is part of this
+// source code package.
+
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "LogEntry.h"
+#include "LogfileIndex.h"
+#include "gtest/gtest.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+constexpr unsigned bit(LogEntry::Class log_class) {
+    return 1U << static_cast<int>(log_class);
+}
+
+std::string makeLogfile(size_t num_alerts) {
+    std::string contents = "[1000000000] LOG VERSION: 2.0\n";
+    for (size_t i = 0; i < num_alerts; ++i) {
+        contents += "[" + std::to_string(1000002000 + i) +
+                    "] HOST ALERT: host" + std::to_string(i % 3) +
+                    ";DOWN;HARD;1;argh\n";
+    }
+    contents += "garbage\n[1000009000] EXTERNAL COMMAND: FOO;bar";
+    return contents;
+}
+}  // namespace
+
+TEST(LogfileIndex, Build) {
+    auto contents = makeLogfile(LogfileIndex::lines_per_bucket);
+    auto index = LogfileIndex::build({contents.size(), 42}, contents);
+    EXPECT_EQ(1000000000, index.first());
+    EXPECT_EQ(1000009000, index.last());
+    EXPECT_EQ(bit(LogEntry::Class::program) | bit(LogEntry::Class::alert) |
+                  bit(LogEntry::Class::ext_command),
+              index.classes());
+    EXPECT_TRUE(index.mentionsHost("host0"));
+    EXPECT_TRUE(index.mentionsHost("host2"));
+    EXPECT_FALSE(index.mentionsHost("host3"));
+    EXPECT_TRUE(index.mentionsHost(""));
+
+    const auto &buckets = index.buckets();
+    ASSERT_EQ(2U, buckets.size());
+    EXPECT_EQ(0U, buckets[0].offset);
+    EXPECT_EQ(0U, buckets[0].lineno);
+    EXPECT_EQ(1000000000, buckets[0].first);
+    EXPECT_EQ(bit(LogEntry::Class::program) | bit(LogEntry::Class::alert),
+              buckets[0].classes);
+    EXPECT_EQ(buckets[0].length, buckets[1].offset);
+    EXPECT_EQ(contents.size(), buckets[1].offset + buckets[1].length);
+    EXPECT_EQ(LogfileIndex::lines_per_bucket, buckets[1].lineno);
+    EXPECT_EQ(1000009000, buckets[1].last);
+    EXPECT_EQ(bit(LogEntry::Class::alert) | bit(LogEntry::Class::ext_command),
+              buckets[1].classes);
+}
+
+class LogfileIndexFixture : public ::testing::Test {
+protected:
+    void SetUp() override { fs::create_directories(basepath); }
+    void TearDown() override { fs::remove_all(basepath); }
+
+    fs::path basepath = fs::temp_directory_path() / "logfile_index_tests";
+};
+
+TEST_F(LogfileIndexFixture, SaveAndLoad) {
+    auto contents = makeLogfile(3000);
+    LogfileIndex::Stamp stamp{contents.size(), 42};
+    auto index = LogfileIndex::build(stamp, contents);
+    auto path = LogfileIndex::pathFor(basepath / "nagios.log");
+    EXPECT_EQ(basepath / "nagios.log.idx", path);
+    EXPECT_TRUE(LogfileIndex::isIndexFile(path));
+    EXPECT_FALSE(LogfileIndex::isIndexFile(basepath / "nagios.log"));
+    ASSERT_TRUE(index.save(path));
+
+    auto loaded = LogfileIndex::load(path, stamp);
+    ASSERT_TRUE(loaded);
+    EXPECT_EQ(index.first(), loaded->first());
+    EXPECT_EQ(index.last(), loaded->last());
+    EXPECT_EQ(index.classes(), loaded->classes());
+    EXPECT_TRUE(loaded->mentionsHost("host1"));
+    ASSERT_EQ(index.buckets().size(), loaded->buckets().size());
+    for (size_t i = 0; i < index.buckets().size(); ++i) {
+        EXPECT_EQ(index.buckets()[i].offset, loaded->buckets()[i].offset);
+        EXPECT_EQ(index.buckets()[i].length, loaded->buckets()[i].length);
+        EXPECT_EQ(index.buckets()[i].classes, loaded->buckets()[i].classes);
+    }
+
+    // An index for another version of the logfile is ignored.
+    EXPECT_FALSE(LogfileIndex::load(path, {contents.size(), 43}));
+    EXPECT_FALSE(LogfileIndex::load(path, {contents.size() + 1, 42}));
+    EXPECT_FALSE(LogfileIndex::load(basepath / "missing.idx", stamp));
+
+    // Truncated files are ignored, too.
+    fs::resize_file(path, fs::file_size(path) - 1);
+    EXPECT_FALSE(LogfileIndex::load(path, stamp));
+}
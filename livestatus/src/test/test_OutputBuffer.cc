@@ -0,0 +1,156 @@
+// Copyright (C) 2019 tribe29 GmbH - License: GNU General Public License v2
+// This file is part of Checkmk (https://checkmk.com). It is subject to the
+// terms and conditions defined in the file COPYING, which is part of this
+// source code package.
+
+#include <unistd.h>
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "Logger.h"
+#include "OutputBuffer.h"
+#include "gtest/gtest.h"
+
+namespace {
+struct Frame {
+    std::string code;
+    std::string data;
+};
+
+class OutputBufferTest : public ::testing::Test {
+protected:
+    void SetUp() override { ASSERT_EQ(0, pipe(fds_.data())); }
+
+    void TearDown() override {
+        if (fds_[0] != -1) {
+            close(fds_[0]);
+        }
+    }
+
+    // Runs the given producer on an OutputBuffer writing into our pipe while
+    // we concurrently read everything the OutputBuffer writes.
+    template <typename F>
+    std::string run(OutputBuffer::ResponseHeader header, F producer) {
+        std::string received;
+        std::thread reader{[&] {
+            std::array<char, 4096> buf{};
+            ssize_t n = 0;
+            while ((n = read(fds_[0], buf.data(), buf.size())) > 0) {
+                received.append(buf.data(), n);
+            }
+        }};
+        {
+            OutputBuffer output{fds_[1], termination_flag_, logger_};
+            output.setResponseHeader(header);
+            producer(output);
+        }
+        close(fds_[1]);
+        reader.join();
+        return received;
+    }
+
+    static std::vector<Frame> frames(const std::string &str) {
+        std::vector<Frame> result;
+        size_t pos = 0;
+        while (pos + 16 <= str.size()) {
+            auto code = str.substr(pos, 3);
+            auto size = std::stoul(str.substr(pos + 4, 11));
+            result.push_back({code, str.substr(pos + 16, size)});
+            pos += 16 + size;
+        }
+        EXPECT_EQ(str.size(), pos);
+        return result;
+    }
+
+    std::array<int, 2> fds_{-1, -1};
+    bool termination_flag_{false};
+    Logger *const logger_{Logger::getLogger("test")};
+};
+}  // namespace
+
+TEST_F(OutputBufferTest, Fixed16) {
+    auto received =
+        run(OutputBuffer::ResponseHeader::fixed16,
+            [](OutputBuffer &output) { output.os() << "Hello, world!\n"; });
+    EXPECT_EQ("200          14\nHello, world!\n", received);
+}
+
+TEST_F(OutputBufferTest, Fixed16ErrorReplacesData) {
+    auto received = run(OutputBuffer::ResponseHeader::fixed16,
+                        [](OutputBuffer &output) {
+                            output.os() << "partial";
+                            output.setError(
+                                OutputBuffer::ResponseCode::limit_exceeded,
+                                "too much");
+                        });
+    EXPECT_EQ("413           9\ntoo much\n", received);
+}
+
+TEST_F(OutputBufferTest, Chunked16StreamsAndTerminates) {
+    std::string expected;
+    for (int i = 0; i < 50000; ++i) {
+        expected += "line " + std::to_string(i) + "\n";
+    }
+    auto received = run(OutputBuffer::ResponseHeader::chunked16,
+                        [&](OutputBuffer &output) {
+                            output.os() << expected;
+                            EXPECT_EQ(expected.size(),
+                                      static_cast<size_t>(output.os().tellp()));
+                            // Most of it has already been written.
+                            EXPECT_LT(output.str().size(),
+                                      OutputBuffer::chunk_size + 1);
+                        });
+    auto fs = frames(received);
+    ASSERT_LT(2UL, fs.size());
+    std::string data;
+    for (const auto &f : fs) {
+        EXPECT_EQ("200", f.code);
+        data += f.data;
+    }
+    EXPECT_EQ(expected, data);
+    EXPECT_TRUE(fs.back().data.empty());
+}
+
+TEST_F(OutputBufferTest, Chunked16ReportsErrorsMidStream) {
+    auto received = run(OutputBuffer::ResponseHeader::chunked16,
+                        [](OutputBuffer &output) {
+                            output.os() << std::string(
+                                3 * OutputBuffer::chunk_size, 'x');
+                            output.setError(
+                                OutputBuffer::ResponseCode::limit_exceeded,
+                                "too much");
+                            output.os() << "ignored";
+                        });
+    auto fs = frames(received);
+    ASSERT_LT(1UL, fs.size());
+    EXPECT_EQ("413", fs.back().code);
+    EXPECT_EQ("too much\n", fs.back().data);
+    for (size_t i = 0; i + 1 < fs.size(); ++i) {
+        EXPECT_EQ("200", fs[i].code);
+        EXPECT_FALSE(fs[i].data.empty());
+    }
+}
+
+TEST_F(OutputBufferTest, Chunked16GivesUpOnStalledClients) {
+    using namespace std::chrono_literals;
+    auto start = std::chrono::steady_clock::now();
+    {
+        // Nobody reads from the pipe, so it fills up after a few chunks.
+        OutputBuffer output{fds_[1], termination_flag_, logger_};
+        output.setResponseHeader(OutputBuffer::ResponseHeader::chunked16);
+        output.setChunkTimeout(200ms);
+        for (int i = 0; i < 100 && !output.writeFailed(); ++i) {
+            output.os() << std::string(OutputBuffer::chunk_size, 'x');
+        }
+        EXPECT_TRUE(output.writeFailed());
+    }
+    EXPECT_GT(5s, std::chrono::steady_clock::now() - start);
+    close(fds_[1]);
+}
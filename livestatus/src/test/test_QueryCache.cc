@@ -0,0 +1,130 @@
+// Copyright (C) 2019 tribe29 GmbH - License: GNU General Public License v2
+// This file is part of Checkmk (https://checkmk.com). It is subject to the
+// terms and conditions defined in the file COPYING, which is part of this
+// source code package.
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <list>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "QueryCache.h"
+#include "gtest/gtest.h"
+
+using namespace std::chrono_literals;
+
+namespace {
+// Answers a request, returning the cached response or "computed <response>".
+// The cache can hold 10 bytes of responses.
+std::string ask(QueryCache &cache, const std::string &key, uint64_t generation,
+                std::chrono::seconds max_staleness,
+                const std::optional<std::string> &response) {
+    constexpr size_t max_bytes = 10;
+    auto cached = cache.answer(key, generation, max_staleness, max_bytes,
+                               [&] { return response; });
+    return cached ? *cached : "computed " + response.value_or("nothing");
+}
+}  // namespace
+
+TEST(QueryCache, KeyIgnoresTransportHeaders) {
+    auto key = QueryCache::makeKey(
+        "hosts",
+        {"Columns: name", "KeepAlive: on", "ResponseHeader: fixed16",
+         "Localtime: 1600000000", "MaxStaleness: 10", "AuthUser: hansi  ", "",
+         "ignored"},
+        3600s);
+    EXPECT_EQ("hosts\n3600\nColumns: name\nAuthUser: hansi", key);
+    EXPECT_NE(key, QueryCache::makeKey("services", {"Columns: name"}, 3600s));
+}
+
+TEST(QueryCache, ReusesResponsesUntilTheGenerationChanges) {
+    QueryCache cache;
+    EXPECT_EQ("computed a", ask(cache, "k", 1, 0s, "a"));
+    EXPECT_EQ("a", ask(cache, "k", 1, 0s, "b"));
+    EXPECT_EQ("computed c", ask(cache, "k", 2, 0s, "c"));
+    EXPECT_EQ("c", ask(cache, "k", 2, 0s, "d"));
+    EXPECT_EQ("computed e", ask(cache, "other", 2, 0s, "e"));
+}
+
+TEST(QueryCache, ReusesStaleResponsesIfAllowed) {
+    QueryCache cache;
+    EXPECT_EQ("computed a", ask(cache, "k", 1, 0s, "a"));
+    EXPECT_EQ("a", ask(cache, "k", 2, 60s, "b"));
+    EXPECT_EQ("computed c", ask(cache, "k", 2, 0s, "c"));
+}
+
+TEST(QueryCache, CachesOnlyWhatItIsGiven) {
+    QueryCache cache;
+    EXPECT_EQ("computed nothing", ask(cache, "k", 1, 0s, std::nullopt));
+    EXPECT_EQ("computed a", ask(cache, "k", 1, 0s, "a"));
+    EXPECT_THROW(cache.answer("e", 1, 0s, 10,
+                              []() -> std::optional<std::string> {
+                                  throw std::runtime_error("boom");
+                              }),
+                 std::runtime_error);
+    EXPECT_EQ("computed b", ask(cache, "e", 1, 0s, "b"));
+    EXPECT_EQ(2U, cache.size());
+}
+
+TEST(QueryCache, EvictsLeastRecentlyUsedResponses) {
+    QueryCache cache;
+    ask(cache, "a", 1, 0s, "1234");
+    ask(cache, "b", 1, 0s, "1234");
+    EXPECT_EQ("1234", ask(cache, "a", 1, 0s, "x"));
+    ask(cache, "c", 1, 0s, "1234");
+    EXPECT_EQ(8U, cache.size());
+    EXPECT_EQ("1234", ask(cache, "a", 1, 0s, "x"));
+    EXPECT_EQ("computed x", ask(cache, "b", 1, 0s, "x"));
+    EXPECT_EQ("computed much too large",
+              ask(cache, "d", 1, 0s, "much too large"));
+    EXPECT_EQ("computed x", ask(cache, "d", 1, 0s, "x"));
+}
+
+TEST(QueryCache, ComputesConcurrentIdenticalRequestsOnce) {
+    QueryCache cache;
+    std::atomic<int> computations{0};
+    std::atomic<int> hits{0};
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 8; ++i) {
+        threads.emplace_back([&] {
+            auto cached = cache.answer("k", 1, 0s, 10, [&] {
+                ++computations;
+                std::this_thread::sleep_for(50ms);
+                return std::optional<std::string>{"response"};
+            });
+            if (cached && *cached == "response") {
+                ++hits;
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(1, computations);
+    EXPECT_EQ(7, hits);
+}
+
+TEST(QueryCache, StopsWaitingForSlowComputations) {
+    QueryCache cache{20ms};
+    std::promise<void> started;
+    std::promise<void> release;
+    std::thread slow{[&] {
+        cache.answer("k", 1, 0s, 10, [&] {
+            started.set_value();
+            release.get_future().wait();
+            return std::optional<std::string>{"slow"};
+        });
+    }};
+    started.get_future().wait();
+    EXPECT_EQ("computed fast", ask(cache, "k", 1, 0s, "fast"));
+    release.set_value();
+    slow.join();
+    EXPECT_EQ("slow", ask(cache, "k", 1, 0s, "x"));
+}
@@ -0,0 +1,222 @@
+// Copyright (C) 2019 tribe29 GmbH - License: GNU General Public License v2
+// This file is part of Checkmk (https://checkmk.com). It is subject to the
+// terms and conditions defined in the file COPYING, which is part of this
+// source code package.
+
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Renderer.h"
+#include "RendererBrokenCSV.h"
+#include "data_encoding.h"
+#include "gtest/gtest.h"
+
+using namespace std::string_literals;
+
+namespace {
+std::string render(OutputFormat format, Encoding data_encoding,
+                   const std::function<void(Renderer &)> &f) {
+    std::ostringstream os;
+    CSVSeparators separators{"\n", ";", ",", "|"};
+    auto renderer =
+        Renderer::make(format, os, nullptr, separators, data_encoding);
+    f(*renderer);
+    return os.str();
+}
+
+std::string renderString(OutputFormat format, Encoding data_encoding,
+                         const std::string &str) {
+    return render(format, data_encoding,
+                  [&](Renderer &r) { r.output(std::string_view{str}); });
+}
+
+std::string renderBlob(OutputFormat format, const std::string &str) {
+    return render(format, Encoding::utf8, [&](Renderer &r) {
+        r.output(std::vector<char>{str.begin(), str.end()});
+    });
+}
+
+std::string renderQuery(OutputFormat format,
+                        const std::function<void(QueryRenderer &)> &f) {
+    return render(format, Encoding::utf8, [&](Renderer &r) {
+        QueryRenderer q(r, EmitBeginEnd::on);
+        f(q);
+    });
+}
+
+// little-endian integer of the given number of bytes
+std::string le(uint64_t value, size_t size) {
+    std::string result;
+    for (size_t i = 0; i < size; ++i) {
+        result += static_cast<char>(value >> (8 * i));
+    }
+    return result;
+}
+
+std::string u8(uint64_t value) { return le(value, 1); }
+std::string u32(uint64_t value) { return le(value, 4); }
+
+// quotes, a backslash, a control character and a 2-byte UTF-8 sequence
+const std::string nasty = "say \"hi\\ho\"\n to J\xc3\xb6rg!";
+}  // namespace
+
+TEST(Renderer, EscapesStrings) {
+    EXPECT_EQ(R"("say \u0022hi\u005cho\u0022\u000a to J\u00f6rg!")",
+              renderString(OutputFormat::json, Encoding::utf8, nasty));
+    EXPECT_EQ(R"(u"say \u0022hi\u005cho\u0022\u000a to J\u00f6rg!")",
+              renderString(OutputFormat::python, Encoding::utf8, nasty));
+    EXPECT_EQ(R"(u"say \u0022hi\u005cho\u0022\u000a to J\u00f6rg!")",
+              renderString(OutputFormat::python3, Encoding::utf8, nasty));
+    EXPECT_EQ("say \"\"hi\\ho\"\"\n to J\xc3\xb6rg!",
+              renderString(OutputFormat::csv, Encoding::utf8, nasty));
+    EXPECT_EQ(nasty,
+              renderString(OutputFormat::broken_csv, Encoding::utf8, nasty));
+}
+
+TEST(Renderer, EscapesOtherEncodings) {
+    EXPECT_EQ(R"("say \u0022hi\u005cho\u0022\u000a to J\u00c3\u00b6rg!")",
+              renderString(OutputFormat::json, Encoding::latin1, nasty));
+    EXPECT_EQ(R"("J\u00f6rg \u00f6")",
+              renderString(OutputFormat::json, Encoding::mixed,
+                           "J\xc3\xb6rg \xf6"));
+    EXPECT_EQ(R"("\ud83d\ude00")",
+              renderString(OutputFormat::json, Encoding::utf8,
+                           "\xf0\x9f\x98\x80"));
+}
+
+TEST(Renderer, EscapesBlobs) {
+    EXPECT_EQ(R"("a\u0022b\u0000c")",
+              renderBlob(OutputFormat::json, "a\"b\0c"s));
+    EXPECT_EQ(R"(b"a\x22b\x00c\xff")",
+              renderBlob(OutputFormat::python3, "a\"b\0c\xff"s));
+    EXPECT_EQ("a\"\"b\0c"s, renderBlob(OutputFormat::csv, "a\"b\0c"s));
+}
+
+TEST(Renderer, EscapesAtEveryPositionOfLongStrings) {
+    // Long enough to exercise both the block-wise and the bytewise scanning.
+    for (size_t len : {15, 16, 17, 40}) {
+        for (size_t pos = 0; pos < len; ++pos) {
+            for (char ch : {'"', '\\', '\n', '\x7f', '\xf6'}) {
+                std::string str(len, 'x');
+                str[pos] = ch;
+                auto escaped = ch == '"'      ? R"(\u0022)"s
+                               : ch == '\\'   ? R"(\u005c)"s
+                               : ch == '\n'   ? R"(\u000a)"s
+                               : ch == '\x7f' ? "\x7f"s
+                                              : R"(\u00f6)"s;
+                EXPECT_EQ('"' + std::string(pos, 'x') + escaped +
+                              std::string(len - pos - 1, 'x') + '"',
+                          renderString(OutputFormat::json, Encoding::latin1,
+                                       str));
+            }
+        }
+    }
+}
+
+TEST(Renderer, FormatsNumbers) {
+    auto numbers = [](Renderer &r) {
+        r.output(-42);
+        r.output(PlainChar{' '});
+        r.output(18446744073709551615UL);
+        r.output(PlainChar{' '});
+        r.output(0.1 + 0.2);
+        r.output(PlainChar{' '});
+        r.output(1e20);
+        r.output(PlainChar{' '});
+        r.output(2.0);
+        r.output(PlainChar{' '});
+        r.output(true);
+    };
+    EXPECT_EQ("-42 18446744073709551615 0.3 1e+20 2 1",
+              render(OutputFormat::csv, Encoding::utf8, numbers));
+    EXPECT_EQ("-42 18446744073709551615 0.30000000000000004 1e+20 2 1",
+              render(OutputFormat::json, Encoding::utf8, numbers));
+    EXPECT_EQ("-42 18446744073709551615 0.30000000000000004 1e+20 2 1",
+              render(OutputFormat::python3, Encoding::utf8, numbers));
+}
+
+TEST(Renderer, BinaryColumns) {
+    auto row = [](QueryRenderer &q, int i, const std::string &s, double d,
+                  const std::vector<int> &l) {
+        RowRenderer r(q);
+        r.output(i);
+        r.output(s);
+        r.output(d);
+        ListRenderer lr(r);
+        for (auto elem : l) {
+            lr.output(elem);
+        }
+    };
+    auto actual = renderQuery(OutputFormat::binary, [&](QueryRenderer &q) {
+        row(q, 1, "foo", 0.5, {1, 2});
+        row(q, -2, "bar", std::nan(""), {});
+        row(q, 3, "foo", 2.0, {3});
+    });
+    EXPECT_EQ("LQB1"s + u32(3) + u32(4) + u32(0) +
+                  // int32 column
+                  u8(1) + u32(1) + u32(-2) + u32(3) +
+                  // string column with 2 distinct strings
+                  u8(5) + u32(2) + u32(3) + "foo" + u32(3) + "bar" + u32(0) +
+                  u32(1) + u32(0) +
+                  // mixed column of reals and nulls
+                  u8(9) + u8(3) + u8(0) + u8(3) + u8(3) +
+                  le(0x3FE0000000000000, 8) + le(0x4000000000000000, 8) +
+                  // list column with its int32 elements
+                  u8(7) + u32(0) + u32(2) + u32(2) + u32(3) + u8(1) + u32(1) +
+                  u32(2) + u32(3),
+              actual);
+}
+
+TEST(Renderer, BinaryColumnHeadersKeepTheColumnTypes) {
+    auto actual = renderQuery(OutputFormat::binary, [&](QueryRenderer &q) {
+        q.renderer().outputColumnHeaders({"state", "name"});
+        RowRenderer r(q);
+        r.output(1);
+        r.output("foo"s);
+    });
+    EXPECT_EQ("LQB1"s + u32(1) + u32(2) +
+                  // column headers
+                  u32(2) + u32(5) + "state" + u32(4) + "name" +
+                  // int32 column
+                  u8(1) + u32(1) +
+                  // string column
+                  u8(5) + u32(1) + u32(3) + "foo" + u32(0),
+              actual);
+}
+
+TEST(Renderer, BinaryRowFragments) {
+    auto columns = [](RowRenderer &r) {
+        r.output(Null());
+        r.output(std::chrono::system_clock::from_time_t(1234567890));
+        r.output(std::vector<char>{'a', '\0'});
+        {
+            ListRenderer l(r);
+            l.output(1.5);
+            SublistRenderer s(l);
+            s.output("x"s);
+        }
+        DictRenderer d(r);
+        d.output("key", "value");
+    };
+    auto fragment = render(OutputFormat::binary, Encoding::utf8,
+                           [&](Renderer &renderer) {
+                               QueryRenderer q(renderer, EmitBeginEnd::off);
+                               RowRenderer r(q);
+                               columns(r);
+                           });
+    EXPECT_EQ(renderQuery(OutputFormat::binary,
+                          [&](QueryRenderer &q) {
+                              RowRenderer r(q);
+                              columns(r);
+                          }),
+              renderQuery(OutputFormat::binary, [&](QueryRenderer &q) {
+                  RowRenderer r(q);
+                  r.output(RowFragment{fragment});
+              }));
+}
@@ -0,0 +1,167 @@
+// Copyright (C) 2019 tribe29 GmbH - License: GNU General Public License v2
+// This file is part of Checkmk (https://checkmk.com). It is subject to the
+// terms and conditions defined in the file COPYING, which is part of this
+// source code package.
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+
+#include "LogCache.h"
+#include "LogEntries.h"
+#include "NagiosCore.h"
+#include "StateHistoryCheckpoints.h"
+#include "TableQueryHelper.h"
+#include "TableStateHistory.h"
+#include "data_encoding.h"
+#include "gtest/gtest.h"
+#include "nagios.h"
+#include "test_utilities.h"
+
+namespace fs = std::filesystem;
+
+extern char *log_file;
+extern char *log_archive_path;
+
+namespace {
+using Checkpoint = StateHistoryCheckpoints::Checkpoint;
+
+std::shared_ptr<const Checkpoint> checkpointAt(time_t t, size_t bytes = 0) {
+    auto checkpoint = std::make_shared<Checkpoint>();
+    checkpoint->key = LogEntries::makeKey(t, 1);
+    checkpoint->time = t;
+    checkpoint->in_nagios_initial_states = false;
+    checkpoint->bytes = bytes;
+    return checkpoint;
+}
+
+const StateHistoryCheckpoints::config_t config1{std::chrono::seconds{1}};
+const StateHistoryCheckpoints::config_t config2{std::chrono::seconds{2}};
+}  // namespace
+
+TEST(StateHistoryCheckpoints, FindsLatestBefore) {
+    StateHistoryCheckpoints checkpoints;
+    EXPECT_EQ(nullptr, checkpoints.find(config1, 1000, 5000));
+    checkpoints.add(config1, 1000, checkpointAt(1000));
+    checkpoints.add(config1, 1000, checkpointAt(4600));
+    checkpoints.add(config1, 1000, checkpointAt(8200));
+
+    EXPECT_EQ(nullptr, checkpoints.find(config1, 1000, 1000));
+    EXPECT_EQ(1000, checkpoints.find(config1, 1000, 1001)->time);
+    EXPECT_EQ(4600, checkpoints.find(config1, 1000, 8200)->time);
+    EXPECT_EQ(8200, checkpoints.find(config1, 1000, 9999)->time);
+    EXPECT_EQ(nullptr, checkpoints.find(config1, 2000, 9999));
+
+    EXPECT_TRUE(
+        checkpoints.contains(config1, 1000, LogEntries::makeKey(4600, 1)));
+    EXPECT_FALSE(
+        checkpoints.contains(config1, 1000, LogEntries::makeKey(4600, 2)));
+}
+
+TEST(StateHistoryCheckpoints, DropsTheOldestCheckpointsBeyondTheLimits) {
+    StateHistoryCheckpoints checkpoints;
+    constexpr auto max = StateHistoryCheckpoints::max_checkpoints;
+    checkpoints.add(config1, 1000, checkpointAt(1000));
+    for (size_t i = 0; i < max; ++i) {
+        checkpoints.add(config1, 2000, checkpointAt(2000 + i));
+    }
+    EXPECT_EQ(nullptr, checkpoints.find(config1, 1000, 9999));
+    EXPECT_EQ(2000, checkpoints.find(config1, 2000, 2001)->time);
+    checkpoints.add(config1, 2000, checkpointAt(9000));
+    EXPECT_EQ(nullptr, checkpoints.find(config1, 2000, 2001));
+
+    constexpr auto max_bytes = StateHistoryCheckpoints::max_bytes;
+    checkpoints.add(config2, 1000, checkpointAt(1000, max_bytes / 2));
+    checkpoints.add(config2, 1000, checkpointAt(2000, max_bytes / 2));
+    EXPECT_EQ(1000, checkpoints.find(config2, 1000, 1001)->time);
+    checkpoints.add(config2, 1000, checkpointAt(3000, max_bytes / 2));
+    EXPECT_EQ(nullptr, checkpoints.find(config2, 1000, 2000));
+    EXPECT_EQ(2000, checkpoints.find(config2, 1000, 2001)->time);
+    checkpoints.add(config2, 1000, checkpointAt(4000, max_bytes + 1));
+    EXPECT_EQ(3000, checkpoints.find(config2, 1000, 9999)->time);
+}
+
+TEST(StateHistoryCheckpoints, KeepsRecentlyUsedLogfiles) {
+    StateHistoryCheckpoints checkpoints;
+    checkpoints.add(config1, 1000, checkpointAt(1000));
+    checkpoints.add(config1, 2000, checkpointAt(2000));
+    EXPECT_NE(nullptr, checkpoints.find(config1, 1000, 9999));
+    checkpoints.add(config1, 3000, checkpointAt(3000));
+    EXPECT_NE(nullptr, checkpoints.find(config1, 1000, 9999));
+    EXPECT_EQ(nullptr, checkpoints.find(config1, 2000, 9999));
+    EXPECT_NE(nullptr, checkpoints.find(config1, 3000, 9999));
+
+    // A configuration change drops everything.
+    EXPECT_EQ(nullptr, checkpoints.find(config2, 3000, 9999));
+    EXPECT_EQ(nullptr, checkpoints.find(config1, 3000, 9999));
+}
+
+namespace {
+// A core knowing just a single host, the Nagios dummies know nothing at all.
+class SingleHostCore : public NagiosCore {
+public:
+    explicit SingleHostCore(host *hst)
+        : NagiosCore(NagiosPaths{}, NagiosLimits{}, NagiosAuthorization{},
+                     Encoding::utf8)
+        , _host(hst) {}
+
+    Host *find_host(const std::string &name) override {
+        return name == _host->name ? reinterpret_cast<Host *>(_host) : nullptr;
+    }
+
+private:
+    host *_host;
+};
+
+class StateHistoryFixture : public ::testing::Test {
+protected:
+    void SetUp() override {
+        fs::create_directories(archive);
+        std::ofstream(logfile_path)
+            << "[1000000000] LOG VERSION: 2.0\n"
+               "[1000000000] INITIAL HOST STATE: sesame_street;UP;HARD;1;OK\n"
+               "[1000007200] HOST ALERT: sesame_street;DOWN;HARD;1;argh\n";
+        log_file = logfile_path.data();
+        log_archive_path = archive_path.data();
+    }
+
+    void TearDown() override {
+        log_file = nullptr;
+        log_archive_path = nullptr;
+        fs::remove_all(basepath);
+    }
+
+    static std::string statehist(TableStateHistory &table, time_t since,
+                                 time_t until) {
+        return mk::test::query(
+            table, {"Columns: host_name from until duration_part log_output\n",
+                    "Filter: time >= " + std::to_string(since) + "\n",
+                    "Filter: time < " + std::to_string(until) + "\n"});
+    }
+
+    fs::path basepath = fs::temp_directory_path() / "statehist_tests";
+    fs::path archive = basepath / "archive";
+    std::string logfile_path = (basepath / "nagios.log").string();
+    std::string archive_path = archive.string();
+    TestHost hst{{}};
+    SingleHostCore core{&hst};
+    LogCache log_cache{&core};
+};
+}  // namespace
+
+TEST_F(StateHistoryFixture, RestoredStatesStartAtSinceOfTheQuery) {
+    TableStateHistory fresh{&core, &log_cache};
+    auto expected = statehist(fresh, 1000005000, 1000006000);
+    EXPECT_EQ("sesame_street;1000005000;1000005999;1;OK\n", expected);
+
+    // The first query takes a checkpoint while replaying up to its 'since',
+    // the second one restores it and finds no entries after its own 'since'.
+    TableStateHistory table{&core, &log_cache};
+    statehist(table, 1000007300, 1000008000);
+    EXPECT_EQ(expected, statehist(table, 1000005000, 1000006000));
+}
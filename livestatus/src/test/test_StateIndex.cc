@@ -0,0 +1,90 @@
+// Copyright (C) 2019 tribe29 GmbH - License: GNU General Public License v2
+// This file is part of Checkmk (https://checkmk.com). It is subject to the
+// terms and conditions defined in the file COPYING, which is part of this
+// source code package.
+
+#include <bitset>
+#include <list>
+#include <string>
+#include <vector>
+
+#include "NagiosCore.h"
+#include "StateIndex.h"
+#include "TableHosts.h"
+#include "TableQueryHelper.h"
+#include "data_encoding.h"
+#include "gtest/gtest.h"
+#include "nagios.h"
+#include "test_utilities.h"
+
+extern host *host_list;
+
+namespace {
+struct Thing {
+    int state;
+};
+
+class StateIndexTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        for (const auto &thing : things) {
+            index.add(&thing, thing.state);
+        }
+    }
+
+    std::vector<const Thing *> lookup(std::bitset<32> states) const {
+        return index.objectsWithStates(states);
+    }
+
+    std::vector<Thing> things{{0}, {2}, {1}, {0}, {2}, {-1}};
+    StateIndex<Thing> index;
+};
+}  // namespace
+
+TEST_F(StateIndexTest, KeepsNaturalOrder) {
+    EXPECT_EQ(6U, index.size());
+    EXPECT_EQ((std::vector<const Thing *>{&things[1], &things[2], &things[4],
+                                          &things[5]}),
+              lookup(std::bitset<32>{0b110}));
+}
+
+TEST_F(StateIndexTest, UnusualStatesAreAlwaysIncluded) {
+    EXPECT_EQ((std::vector<const Thing *>{&things[5]}),
+              lookup(std::bitset<32>{}));
+}
+
+TEST_F(StateIndexTest, Update) {
+    index.update(&things[0], 2);
+    index.update(&things[1], 0);
+    EXPECT_EQ((std::vector<const Thing *>{&things[0], &things[4], &things[5]}),
+              lookup(std::bitset<32>{0b100}));
+    EXPECT_EQ((std::vector<const Thing *>{&things[1], &things[3], &things[5]}),
+              lookup(std::bitset<32>{0b001}));
+}
+
+TEST_F(StateIndexTest, UnknownObjectsAreIgnored) {
+    Thing other{1};
+    index.update(&other, 1);
+    EXPECT_EQ(6U, index.size());
+    EXPECT_EQ((std::vector<const Thing *>{&things[2], &things[5]}),
+              lookup(std::bitset<32>{0b010}));
+}
+
+TEST(StateIndex, TableHostsCatchesUpWithStatesFromRetentionData) {
+    TestHost hst{{}};
+    hst.current_state = 0;
+    hst.next = nullptr;
+    host_list = &hst;
+    NagiosCore core{NagiosPaths{}, NagiosLimits{}, NagiosAuthorization{},
+                    Encoding::utf8};
+    TableHosts table{&core};
+    const std::list<std::string> down{"Columns: name\n", "Filter: state = 1\n"};
+    EXPECT_EQ("", mk::test::query(table, down));
+
+    // Retention data is read without any broker callbacks, the index is
+    // updated when the event loop starts.
+    hst.current_state = 1;
+    table.updateStates();
+    EXPECT_EQ("sesame_street\n", mk::test::query(table, down));
+    host_list = nullptr;
+}
@@ -0,0 +1,54 @@
+// Copyright (C) 2019 tribe29 GmbH - License: GNU General Public License v2
+// This file is part of Checkmk (https://checkmk.com). It is subject to the
+// terms and conditions defined in the file COPYING, which is part of this
+// source code package.
+
+#include <string>
+#include <vector>
+
+#include "Renderer.h"
+#include "StatsGroups.h"
+#include "gtest/gtest.h"
+
+TEST(StatsGroups, FindOnEmptyTable) {
+    StatsGroups groups;
+    EXPECT_EQ(nullptr, groups.find(""));
+    EXPECT_EQ(nullptr, groups.find("foo"));
+}
+
+TEST(StatsGroups, InsertAndFind) {
+    StatsGroups groups;
+    auto &foo = groups.insert("foo", RowFragment{"FOO"}, {});
+    auto &empty = groups.insert("", RowFragment{""}, {});
+    EXPECT_EQ(&foo, groups.find("foo"));
+    EXPECT_EQ(&empty, groups.find(""));
+    EXPECT_EQ(nullptr, groups.find("bar"));
+    EXPECT_EQ(&foo, &groups.insert("foo", RowFragment{"other"}, {}));
+    EXPECT_EQ("FOO", foo.fragment._str);
+    EXPECT_EQ(2U, groups.size());
+}
+
+TEST(StatsGroups, SurvivesGrowing) {
+    StatsGroups groups;
+    std::vector<StatsGroups::Group *> inserted;
+    for (int i = 0; i < 1000; ++i) {
+        auto key = std::to_string(i);
+        inserted.push_back(&groups.insert(key, RowFragment{key}, {}));
+    }
+    EXPECT_EQ(1000U, groups.size());
+    for (int i = 0; i < 1000; ++i) {
+        EXPECT_EQ(inserted[i], groups.find(std::to_string(i)));
+    }
+}
+
+TEST(StatsGroups, SortedByRenderedKey) {
+    StatsGroups groups;
+    groups.insert("\x03", RowFragment{"c"}, {});
+    groups.insert("\x01", RowFragment{"a"}, {});
+    groups.insert("\x02", RowFragment{"b"}, {});
+    std::string order;
+    for (const auto *group : groups.sorted()) {
+        order += group->fragment._str;
+    }
+    EXPECT_EQ("abc", order);
+}
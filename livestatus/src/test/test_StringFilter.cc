@@ -0,0 +1,99 @@
+// Copyright (C) 2019 tribe29 GmbH - License: GNU General Public License v2
+// This file is part of Checkmk (https://checkmk.com). It is subject to the
+// terms and conditions defined in the file COPYING, which is part of this
+// source code package.
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+
+#include "AndingFilter.h"
+#include "Filter.h"
+#include "OringFilter.h"
+#include "StringFilter.h"
+#include "StringLambdaColumn.h"
+#include "gtest/gtest.h"
+#include "opids.h"
+
+namespace {
+struct Thing {
+    std::string name;
+};
+
+class StringPrefixRestrictionTest : public ::testing::Test {
+protected:
+    std::unique_ptr<Filter> name(RelationalOperator op,
+                                 const std::string &value) const {
+        return std::make_unique<StringFilter>(Filter::Kind::row, name_column,
+                                              op, value);
+    }
+
+    std::optional<std::string> prefix(RelationalOperator op,
+                                      const std::string &value) const {
+        return name(op, value)->stringPrefixRestrictionFor("name");
+    }
+
+    static Filters filters(std::unique_ptr<Filter> a,
+                           std::unique_ptr<Filter> b) {
+        Filters result;
+        result.push_back(std::move(a));
+        result.push_back(std::move(b));
+        return result;
+    }
+
+    StringLambdaColumn<Thing> name_column{
+        "name", "The name", {}, [](const Thing &t) { return t.name; }};
+};
+}  // namespace
+
+TEST_F(StringPrefixRestrictionTest, Equality) {
+    EXPECT_EQ("CPU load", prefix(RelationalOperator::equal, "CPU load"));
+    EXPECT_EQ(std::nullopt, prefix(RelationalOperator::equal, ""));
+    EXPECT_EQ(std::nullopt, prefix(RelationalOperator::equal_icase, "CPU"));
+    EXPECT_EQ(std::nullopt, prefix(RelationalOperator::not_equal, "CPU"));
+    EXPECT_EQ(std::nullopt, name(RelationalOperator::equal, "CPU")
+                                ->stringPrefixRestrictionFor("other"));
+}
+
+TEST_F(StringPrefixRestrictionTest, AnchoredRegex) {
+    EXPECT_EQ("Interface", prefix(RelationalOperator::matches, "^Interface"));
+    EXPECT_EQ("Interface ",
+              prefix(RelationalOperator::matches, "^Interface [0-9]+$"));
+    EXPECT_EQ("Interface", prefix(RelationalOperator::matches, "^Interfaces?"));
+    EXPECT_EQ("Interface", prefix(RelationalOperator::matches, "^Interface+"));
+    EXPECT_EQ("Disk", prefix(RelationalOperator::matches, "^Disk\\.IO"));
+    EXPECT_EQ(std::nullopt, prefix(RelationalOperator::matches, "Interface"));
+    EXPECT_EQ(std::nullopt, prefix(RelationalOperator::matches, "^.*"));
+    EXPECT_EQ(std::nullopt, prefix(RelationalOperator::matches, "^a|b"));
+    EXPECT_EQ(std::nullopt, prefix(RelationalOperator::matches, "^a*"));
+    EXPECT_EQ(std::nullopt,
+              prefix(RelationalOperator::matches_icase, "^Interface"));
+}
+
+TEST_F(StringPrefixRestrictionTest, Junctions) {
+    EXPECT_EQ("Interface 1",
+              AndingFilter::make(
+                  Filter::Kind::row,
+                  filters(name(RelationalOperator::matches, "^Inter"),
+                          name(RelationalOperator::matches, "^Interface 1")))
+                  ->stringPrefixRestrictionFor("name"));
+    EXPECT_EQ("Interface ",
+              OringFilter::make(
+                  Filter::Kind::row,
+                  filters(name(RelationalOperator::equal, "Interface 1"),
+                          name(RelationalOperator::matches, "^Interface 2")))
+                  ->stringPrefixRestrictionFor("name"));
+    EXPECT_EQ(std::nullopt,
+              OringFilter::make(
+                  Filter::Kind::row,
+                  filters(name(RelationalOperator::equal, "CPU"),
+                          name(RelationalOperator::equal, "Disk")))
+                  ->stringPrefixRestrictionFor("name"));
+    EXPECT_EQ(std::nullopt,
+              OringFilter::make(
+                  Filter::Kind::row,
+                  filters(name(RelationalOperator::equal, "CPU"),
+                          name(RelationalOperator::not_equal, "CPU 1")))
+                  ->stringPrefixRestrictionFor("name"));
+}
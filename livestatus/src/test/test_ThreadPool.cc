@@ -0,0 +1,142 @@
+// Copyright (C) 2019 tribe29 GmbH - License: GNU General Public License v2
+// This file is part of Checkmk (https://checkmk.com). It is subject to the
+// terms and conditions defined in the file COPYING, which is part of this
+// source code package.
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "IntLambdaColumn.h"
+#include "NagiosCore.h"
+#include "Query.h"
+#include "Row.h"
+#include "StringLambdaColumn.h"
+#include "Table.h"
+#include "TableQueryHelper.h"
+#include "ThreadPool.h"
+#include "data_encoding.h"
+#include "gtest/gtest.h"
+
+TEST(ThreadPool, RunsEveryTaskExactlyOnce) {
+    ThreadPool pool{3};
+    std::vector<std::atomic<int>> calls(1000);
+    pool.run(calls.size(), [&](size_t i) { calls[i]++; });
+    for (const auto &count : calls) {
+        EXPECT_EQ(1, count);
+    }
+    pool.run(0, [](size_t /*i*/) { FAIL(); });
+}
+
+TEST(ThreadPool, RethrowsExceptions) {
+    ThreadPool pool{2};
+    std::atomic<int> calls{0};
+    EXPECT_THROW(pool.run(10,
+                          [&](size_t i) {
+                              calls++;
+                              if (i == 5) {
+                                  throw std::runtime_error("boom");
+                              }
+                          }),
+                 std::runtime_error);
+    EXPECT_EQ(10, calls);
+}
+
+TEST(ThreadPool, PostRunsJobsInTheBackground) {
+    ThreadPool pool{2};
+    std::atomic<int> calls{0};
+    for (int i = 0; i < 100; ++i) {
+        pool.post([&calls, i] {
+            calls++;
+            if (i % 10 == 0) {
+                throw std::runtime_error("ignored");
+            }
+        });
+    }
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (calls < 100 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(100, calls);
+}
+
+namespace {
+struct Thing {
+    int number;
+    std::string name;
+};
+
+class TableThings : public Table {
+public:
+    TableThings(MonitoringCore *mc, ThreadPool *pool)
+        : Table(mc), _pool(pool) {
+        for (int i = 0; i < 5000; ++i) {
+            _things.push_back({i, "thing" + std::to_string(i % 7)});
+        }
+        addColumn(std::make_unique<IntLambdaColumn<Thing>>(
+            "number", "The number", ColumnOffsets{},
+            [](const Thing &t) { return t.number; }));
+        addColumn(std::make_unique<StringLambdaColumn<Thing>>(
+            "name", "The name", ColumnOffsets{},
+            [](const Thing &t) { return t.name; }));
+    }
+
+    [[nodiscard]] std::string name() const override { return "things"; }
+    [[nodiscard]] std::string namePrefix() const override {
+        return "thing_";
+    }
+
+    void answerQuery(Query *query) override {
+        std::vector<Row> rows;
+        for (const auto &thing : _things) {
+            rows.emplace_back(&thing);
+        }
+        query->processDatasets(rows, _pool);
+    }
+
+private:
+    ThreadPool *_pool;
+    std::vector<Thing> _things;
+};
+
+class ParallelScanTest : public ::testing::Test {
+protected:
+    void check(const std::list<std::string> &q) {
+        auto expected = mk::test::query(sequential, q);
+        EXPECT_EQ(expected, mk::test::query(parallel, q));
+    }
+
+    NagiosCore core{NagiosPaths{}, NagiosLimits{}, NagiosAuthorization{},
+                    Encoding::utf8};
+    ThreadPool pool{3};
+    TableThings sequential{&core, nullptr};
+    TableThings parallel{&core, &pool};
+};
+}  // namespace
+
+TEST_F(ParallelScanTest, Rows) {
+    check({"Columns: number name\n"});
+    check({"Columns: number name\n", "Filter: name = thing3\n"});
+    check({"Columns: number\n", "Filter: number > 2500\n",
+           "OutputFormat: json\n"});
+    check({"Columns: number\n", "Filter: name ~ 1\n", "Limit: 1200\n"});
+    // The later chunks use up the response budget, the limit is reached
+    // within the response size with the rows of the first chunk.
+    check({"Columns: number name\n", "Filter: number < 100\n",
+           "Filter: number >= 1250\n", "Or: 2\n", "Limit: 400\n"});
+}
+
+TEST_F(ParallelScanTest, Stats) {
+    check({"Stats: number >= 0\n", "Stats: sum number\n",
+           "Stats: min number\n", "Stats: max number\n"});
+    check({"Columns: name\n", "Stats: number > 1000\n", "Stats: avg number\n",
+           "Stats: max number\n"});
+    check({"Columns: name\n", "Filter: number < 4000\n",
+           "Stats: number > 100\n", "Limit: 3\n"});
+}
@@ -19,9 +19,12 @@ CustomVariables::CustomVariables(Attributes attrs) : attrs_(std::move(attrs)) {
     }
 }
 
-customvariablesmember *CustomVariables::start() { return &cvms_.back(); }
+customvariablesmember *CustomVariables::start() {
+    return cvms_.empty() ? nullptr : &cvms_.back();
+}
 
-TestHost::TestHost(const Attributes &cust_vars) : cust_vars_(cust_vars) {
+TestHost::TestHost(const Attributes &cust_vars)
+    : host{}, cust_vars_(cust_vars) {
     name = cc("sesame_street");
     display_name = cc("the display name");
     alias = cc("the alias");
@@ -38,7 +41,7 @@ TestHost::TestHost(const Attributes &cust_vars) : cust_vars_(cust_vars) {
 }
 
 TestService::TestService(host *h, const Attributes &cust_vars)
-    : cust_vars_(cust_vars) {
+    : service{}, cust_vars_(cust_vars) {
     description = cc("muppet_show");
     display_name = cc("The Muppet Show");
 #ifdef NAGIOS4
@@ -52,3 +55,24 @@ TestService::TestService(host *h, const Attributes &cust_vars)
     perf_data = cc("99%");
     host_ptr = h;
 }
+
+namespace {
+bool is_member(const contactsmember *members, const contact *ctc) {
+    for (const auto *mem = members; mem != nullptr; mem = mem->next) {
+        if (mem->contact_ptr == ctc) {
+            return true;
+        }
+    }
+    return false;
+}
+}  // namespace
+
+// Unlike the other Nagios dummies these need the real object structures. In
+// contrast to Nagios they ignore the contact groups.
+int is_contact_for_host(host *hst, contact *ctc) {
+    return is_member(hst->contacts, ctc) ? 1 : 0;
+}
+
+int is_contact_for_service(service *svc, contact *ctc) {
+    return is_member(svc->contacts, ctc) ? 1 : 0;
+}